@@ -0,0 +1,1077 @@
+/*
+ * File: main.c
+ * Author: Ragib Asif
+ * Email: ragibasif@tuta.io
+ * GitHub: https://github.com/ragibasif
+ * LinkedIn: https://www.linkedin.com/in/ragibasif/
+ * SPDX-License-Identifier: MIT
+ * Copyright (c) 2025 Ragib Asif
+ * Version 1.0.0
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/dynamic_array.h"
+#include "../src/dynamic_array_concurrent.h"
+#include "../src/dynamic_array_frozen.h"
+#include "../src/dynamic_array_parallel.h"
+#include "../src/dynamic_array_set.h"
+#include "../src/dynamic_array_simd.h"
+#include "../src/dynamic_array_text.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static double now_ns( void ) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// ============================================================================
+// Growth Benchmarks
+// ============================================================================
+
+// realloc that always moves, i.e. what an allocator without mremap does to a
+// multi-GB buffer: old and new blocks are both resident during the copy
+static void *copying_realloc( void *context, void *ptr, const size_t old_size,
+                              const size_t new_size ) {
+    (void)context;
+    void *moved = malloc( new_size );
+    if ( moved == NULL ) { return NULL; }
+    if ( ptr != NULL ) {
+        memcpy( moved, ptr, old_size < new_size ? old_size : new_size );
+        free( ptr );
+    }
+    return moved;
+}
+
+static void *copying_alloc( void *context, const size_t size ) {
+    (void)context;
+    return malloc( size );
+}
+
+static void copying_free( void *context, void *ptr, const size_t size ) {
+    (void)context;
+    (void)size;
+    free( ptr );
+}
+
+static const struct dynamic_array_allocator copying_allocator = {
+    .alloc   = copying_alloc,
+    .realloc = copying_realloc,
+    .free    = copying_free,
+    .context = NULL,
+};
+
+// each policy runs in its own process so ru_maxrss is the peak of that
+// policy alone
+static void
+bench_growth_policy( const char                           *name,
+                     const struct dynamic_array_growth    *growth,
+                     const struct dynamic_array_allocator *allocator,
+                     const size_t                          size ) {
+    fflush( stdout );
+    pid_t pid = fork();
+    if ( pid < 0 ) {
+        perror( "fork" );
+        return;
+    }
+    if ( pid > 0 ) {
+        waitpid( pid, NULL, 0 );
+        return;
+    }
+
+    struct dynamic_array da;
+    dynamic_array_init_with( &da, allocator );
+    dynamic_array_set_growth( &da, growth );
+    double start = now_ns();
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( &da, (int)i ); }
+    double elapsed = ( now_ns() - start ) / 1e6;
+
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    printf( "growth size=%zu policy=%s: %.1f ms, peak rss %ld MiB "
+            "(data %zu MiB, capacity %zu)\n",
+            size, name, elapsed, usage.ru_maxrss / 1024,
+            size * sizeof( int ) >> 20, da.capacity );
+    dynamic_array_release( &da );
+    fflush( stdout );
+    _exit( EXIT_SUCCESS );
+}
+
+void bench_growth( const size_t size ) {
+    const struct dynamic_array_growth one_and_half = {
+        .kind = DYNAMIC_ARRAY_GROWTH_ONE_AND_HALF,
+    };
+    const struct dynamic_array_growth fixed = {
+        .kind      = DYNAMIC_ARRAY_GROWTH_FIXED,
+        .increment = size / 64,
+    };
+    const struct dynamic_array_growth mapped = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .mmap_threshold = 1 << 20,
+    };
+
+    bench_growth_policy( "2x/copy", NULL, &copying_allocator, size );
+    bench_growth_policy( "2x", NULL, NULL, size );
+    bench_growth_policy( "1.5x", &one_and_half, NULL, size );
+    bench_growth_policy( "fixed", &fixed, NULL, size );
+    bench_growth_policy( "2x/mremap", &mapped, NULL, size );
+}
+
+// resident set right now, from /proc; 0 where that is missing
+static long resident_mib( void ) {
+    FILE *statm = fopen( "/proc/self/statm", "r" );
+    if ( statm == NULL ) { return 0; }
+    long pages    = 0;
+    long resident = 0;
+    if ( fscanf( statm, "%ld %ld", &pages, &resident ) != 2 ) { resident = 0; }
+    fclose( statm );
+    return resident * sysconf( _SC_PAGESIZE ) >> 20;
+}
+
+// a burst to `size` elements popped back to 1% of it, then push/pop pairs at
+// the size it settled on; forked like the growth policies
+static void bench_shrink_policy( const char                        *name,
+                                 const struct dynamic_array_growth *growth,
+                                 const size_t                       size ) {
+    fflush( stdout );
+    pid_t pid = fork();
+    if ( pid < 0 ) {
+        perror( "fork" );
+        return;
+    }
+    if ( pid > 0 ) {
+        waitpid( pid, NULL, 0 );
+        return;
+    }
+
+    struct dynamic_array da;
+    dynamic_array_init( &da );
+    dynamic_array_set_growth( &da, growth );
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( &da, (int)i ); }
+    double start = now_ns();
+    while ( da.size > size / 100 ) { dynamic_array_pop( &da ); }
+    const double pop_ns = ( now_ns() - start ) / (double)( size - da.size );
+
+    const int pairs = 1000000;
+    start           = now_ns();
+    for ( int i = 0; i < pairs; i++ ) {
+        dynamic_array_push( &da, i );
+        dynamic_array_pop( &da );
+    }
+    const double pair_ns = ( now_ns() - start ) / pairs;
+    printf( "shrink size=%zu policy=%s: pop %.2f ns, push+pop %.2f ns, "
+            "rss %ld MiB after (capacity %zu)\n",
+            size, name, pop_ns, pair_ns, resident_mib(), da.capacity );
+    dynamic_array_release( &da );
+    fflush( stdout );
+    _exit( EXIT_SUCCESS );
+}
+
+void bench_shrink( const size_t size ) {
+    const struct dynamic_array_growth quarter = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .shrink_divisor = 4,
+    };
+    const struct dynamic_array_growth mapped = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .mmap_threshold = 1 << 20,
+        .shrink_divisor = 4,
+    };
+
+    bench_shrink_policy( "keep", NULL, size );
+    bench_shrink_policy( "1/4", &quarter, size );
+    bench_shrink_policy( "1/4/mapped", &mapped, size );
+}
+
+// ============================================================================
+// Rotation Benchmarks
+// ============================================================================
+
+// the n-step rotations are O(N) in the array size only, so every row of the
+// output should report roughly the same time for a given size
+void bench_rotate_n( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, (int)i ); }
+
+    const int counts[] = { 1, 10, 1000, (int)( size / 2 ), (int)size - 1 };
+    const int repeats  = 50;
+
+    for ( size_t c = 0; c < sizeof counts / sizeof *counts; c++ ) {
+        double start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) {
+            dynamic_array_rotate_right_n( da, counts[c] );
+            dynamic_array_rotate_left_n( da, counts[c] );
+        }
+        double elapsed = ( now_ns() - start ) / ( 2.0 * repeats );
+        printf( "rotate_n size=%zu count=%d: %.0f ns/rotation\n", size,
+                counts[c], elapsed );
+    }
+
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Search Benchmarks
+// ============================================================================
+
+// worst case search (value absent) at every kernel level the CPU supports
+void bench_find( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, (int)i ); }
+
+    enum dynamic_array_simd_level best    = dynamic_array_simd_detect();
+    const int                     repeats = 200;
+    volatile ptrdiff_t            sink    = 0;
+
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        double start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) {
+            sink = dynamic_array_find( da, -1 );
+        }
+        double elapsed = ( now_ns() - start ) / repeats;
+        printf( "find size=%zu level=%s: %.0f ns/find (%.2f ns/element)\n",
+                size,
+                dynamic_array_simd_level_name(
+                    (enum dynamic_array_simd_level)level ),
+                elapsed, elapsed / (double)size );
+    }
+    (void)sink;
+    dynamic_array_simd_set_level( best );
+
+    dynamic_array_destroy( da );
+}
+
+// membership lookups of present keys on an unsorted array: vectorized scan
+// versus the hash index, plus what the index costs in memory
+void bench_index( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) {
+        dynamic_array_push( da, (int)( i * 2654435761u ) );
+    }
+    const size_t       lookups = size < 100000 ? 100000 : size;
+    volatile ptrdiff_t sink    = 0;
+
+    double start = now_ns();
+    for ( size_t i = 0; i < lookups / 100; i++ ) {
+        sink = dynamic_array_find( da, da->buffer[( i * 7919 ) % size] );
+    }
+    printf( "lookup size=%zu method=scan: %.1f ns/find\n", size,
+            ( now_ns() - start ) / (double)( lookups / 100 ) );
+
+    start = now_ns();
+    dynamic_array_index_enable( da );
+    printf( "lookup size=%zu method=index build: %.1f ms, %.1f bytes/element\n",
+            size, ( now_ns() - start ) / 1e6,
+            (double)dynamic_array_index_memory( da ) / (double)size );
+    start = now_ns();
+    for ( size_t i = 0; i < lookups; i++ ) {
+        sink = dynamic_array_find( da, da->buffer[( i * 7919 ) % size] );
+    }
+    printf( "lookup size=%zu method=index: %.1f ns/find\n", size,
+            ( now_ns() - start ) / (double)lookups );
+    (void)sink;
+    dynamic_array_destroy( da );
+}
+
+// a read-only snapshot per request: pushing every element into a new array
+// versus a copy-on-write clone, and what the first write to a clone costs
+void bench_clone( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, (int)i ); }
+    const int        requests = 100;
+    volatile int64_t sink     = 0;
+
+    double start = now_ns();
+    for ( int r = 0; r < requests; r++ ) {
+        struct dynamic_array *copy = dynamic_array_create();
+        for ( size_t i = 0; i < size; i++ ) {
+            dynamic_array_push( copy, da->buffer[i] );
+        }
+        sink = copy->buffer[size / 2];
+        dynamic_array_destroy( copy );
+    }
+    printf( "snapshot size=%zu method=push copy: %.2f us/request\n", size,
+            ( now_ns() - start ) / requests / 1e3 );
+
+    start = now_ns();
+    for ( int r = 0; r < requests; r++ ) {
+        struct dynamic_array *snapshot = dynamic_array_clone( da );
+        sink                           = snapshot->buffer[size / 2];
+        dynamic_array_destroy( snapshot );
+    }
+    printf( "snapshot size=%zu method=clone: %.2f us/request\n", size,
+            ( now_ns() - start ) / requests / 1e3 );
+
+    start = now_ns();
+    for ( int r = 0; r < requests; r++ ) {
+        struct dynamic_array *snapshot = dynamic_array_clone( da );
+        dynamic_array_set( snapshot, 0, r );
+        dynamic_array_destroy( snapshot );
+    }
+    printf( "snapshot size=%zu method=clone + write: %.2f us/request\n", size,
+            ( now_ns() - start ) / requests / 1e3 );
+    (void)sink;
+    dynamic_array_destroy( da );
+}
+
+// sorted ids frozen into bit-packed blocks: bytes per element, random get,
+// find and a full decode at every kernel level
+void bench_frozen( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) {
+        dynamic_array_push( da, (int)( 1000000 + i * 8 + i % 7 ) );
+    }
+    struct dynamic_array_frozen *f = dynamic_array_freeze( da );
+    printf( "frozen size=%zu: %.2f bytes/element (array: %zu)\n", size,
+            (double)dynamic_array_frozen_memory( f ) / (double)size,
+            sizeof *da->buffer );
+
+    const size_t  lookups = 1000000;
+    volatile long sink    = 0;
+    double        start   = now_ns();
+    for ( size_t i = 0; i < lookups; i++ ) {
+        sink = dynamic_array_frozen_get( f, ( i * 7919 ) % size );
+    }
+    printf( "frozen size=%zu get: %.1f ns\n", size,
+            ( now_ns() - start ) / (double)lookups );
+    start = now_ns();
+    for ( size_t i = 0; i < lookups; i++ ) {
+        sink = dynamic_array_frozen_find( f, da->buffer[( i * 7919 ) % size] );
+    }
+    printf( "frozen size=%zu find: %.1f ns\n", size,
+            ( now_ns() - start ) / (double)lookups );
+
+    enum dynamic_array_simd_level best    = dynamic_array_simd_detect();
+    int                          *out     = malloc( sizeof *out * size );
+    const int                     repeats = 20;
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) {
+            dynamic_array_frozen_decode( f, 0, size, out );
+            sink = out[size / 2];
+        }
+        printf( "frozen size=%zu decode level=%s: %.2f ns/element\n", size,
+                dynamic_array_simd_level_name(
+                    (enum dynamic_array_simd_level)level ),
+                ( now_ns() - start ) / repeats / (double)size );
+    }
+    dynamic_array_simd_set_level( best );
+    (void)sink;
+    free( out );
+    dynamic_array_frozen_destroy( f );
+    dynamic_array_destroy( da );
+}
+
+// overlap of two sorted id lists: a find per element versus intersect, at
+// every kernel level for equal sizes and for a list `ratio` times smaller
+void bench_set( const size_t size ) {
+    struct dynamic_array *a   = dynamic_array_create();
+    struct dynamic_array *b   = dynamic_array_create();
+    struct dynamic_array *out = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) {
+        dynamic_array_push( a, (int)( i * 3 ) );
+        dynamic_array_push( b, (int)( i * 5 ) );
+    }
+    // unsorted copies, so find scans
+    struct dynamic_array *scanned = dynamic_array_create();
+    dynamic_array_extend( scanned, b );
+    const size_t  probes = 1000;
+    volatile long sink   = 0;
+    double        start  = now_ns();
+    for ( size_t i = 0; i < probes; i++ ) {
+        sink = dynamic_array_find( scanned, a->buffer[i * ( size / probes )] );
+    }
+    printf( "intersect size=%zu method=find per element: %.2f ms "
+            "(extrapolated)\n",
+            size, ( now_ns() - start ) * (double)( size / probes ) / 1e6 );
+
+    enum dynamic_array_simd_level best    = dynamic_array_simd_detect();
+    const int                     repeats = 20;
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) {
+            dynamic_array_intersect( out, a, b );
+        }
+        printf( "intersect size=%zu level=%s: %.2f ms (%zu common)\n", size,
+                dynamic_array_simd_level_name(
+                    (enum dynamic_array_simd_level)level ),
+                ( now_ns() - start ) / repeats / 1e6, out->size );
+    }
+    dynamic_array_simd_set_level( best );
+
+    for ( size_t ratio = 8; ratio <= 512; ratio *= 4 ) {
+        struct dynamic_array *small = dynamic_array_create();
+        for ( size_t i = 0; i < size / ratio; i++ ) {
+            dynamic_array_push( small, (int)( i * ratio * 5 ) );
+        }
+        start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) {
+            dynamic_array_intersect( out, small, a );
+        }
+        printf( "intersect size=%zu ratio=%zu: %.3f ms\n", size, ratio,
+                ( now_ns() - start ) / repeats / 1e6 );
+        dynamic_array_destroy( small );
+    }
+    (void)sink;
+    dynamic_array_destroy( scanned );
+    dynamic_array_destroy( out );
+    dynamic_array_destroy( b );
+    dynamic_array_destroy( a );
+}
+
+// sum and minmax at every kernel level; the scalar level is the plain loop
+void bench_reduce( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) {
+        dynamic_array_push( da, (int)( i * 2654435761u ) );
+    }
+
+    enum dynamic_array_simd_level best    = dynamic_array_simd_detect();
+    const int                     repeats = 200;
+    volatile int64_t              sink    = 0;
+
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        const char *name = dynamic_array_simd_level_name(
+            (enum dynamic_array_simd_level)level );
+        double start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) { sink = dynamic_array_sum( da ); }
+        printf( "sum size=%zu level=%s: %.2f ns/element\n", size, name,
+                ( now_ns() - start ) / repeats / (double)size );
+
+        start = now_ns();
+        for ( int r = 0; r < repeats; r++ ) {
+            int min, max;
+            dynamic_array_minmax( da, &min, &max );
+            sink = min + max;
+        }
+        printf( "minmax size=%zu level=%s: %.2f ns/element\n", size, name,
+                ( now_ns() - start ) / repeats / (double)size );
+    }
+    (void)sink;
+    dynamic_array_simd_set_level( best );
+
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Sort and Lookup Benchmarks
+// ============================================================================
+
+static int compare_ints( const void *a, const void *b ) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return ( x > y ) - ( x < y );
+}
+
+// radix sort against qsort, then lookups of present keys before and after
+// the sorted flag switches find to binary search
+void bench_sort( const size_t size ) {
+    struct dynamic_array *da   = dynamic_array_create();
+    int                  *copy = malloc( sizeof *copy * size );
+    unsigned              seed = 42;
+    for ( size_t i = 0; i < size; i++ ) {
+        seed    = seed * 1103515245u + 12345u;
+        copy[i] = (int)seed;
+    }
+    dynamic_array_push_n( da, copy, size );
+
+    double start = now_ns();
+    qsort( copy, size, sizeof *copy, compare_ints );
+    printf( "sort size=%zu method=qsort: %.1f ms\n", size,
+            ( now_ns() - start ) / 1e6 );
+
+    const int          lookups = 1000;
+    volatile ptrdiff_t sink    = 0;
+    start                      = now_ns();
+    for ( int i = 0; i < lookups; i++ ) {
+        sink = dynamic_array_find( da, copy[(size_t)i * 7919 % size] );
+    }
+    printf( "find size=%zu order=unsorted: %.0f ns/lookup\n", size,
+            ( now_ns() - start ) / lookups );
+
+    start = now_ns();
+    dynamic_array_sort( da );
+    printf( "sort size=%zu method=radix: %.1f ms\n", size,
+            ( now_ns() - start ) / 1e6 );
+
+    start = now_ns();
+    for ( int i = 0; i < lookups; i++ ) {
+        sink = dynamic_array_find( da, copy[(size_t)i * 7919 % size] );
+    }
+    printf( "find size=%zu order=sorted: %.0f ns/lookup\n", size,
+            ( now_ns() - start ) / lookups );
+    (void)sink;
+
+    free( copy );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Compaction Benchmarks
+// ============================================================================
+
+static bool is_negative( const int value, void *context ) {
+    (void)context;
+    return value < 0;
+}
+
+// purge of 1% scattered elements: one remove per element versus a single
+// compaction pass (predicate and vectorized value removal)
+void bench_remove( const size_t size ) {
+    struct dynamic_array *source = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) {
+        dynamic_array_push( source, i % 100 == 0 ? -1 : (int)i );
+    }
+    struct dynamic_array *da = dynamic_array_create();
+
+    dynamic_array_extend( da, source );
+    double start = now_ns();
+    for ( size_t i = da->size; i > 0; i-- ) {
+        if ( da->buffer[i - 1] < 0 ) { dynamic_array_remove( da, i - 1 ); }
+    }
+    printf( "remove size=%zu method=one-by-one: %.0f us\n", size,
+            ( now_ns() - start ) / 1e3 );
+
+    dynamic_array_reset( da );
+    dynamic_array_extend( da, source );
+    start = now_ns();
+    dynamic_array_remove_if( da, is_negative, NULL );
+    printf( "remove size=%zu method=remove_if: %.0f us\n", size,
+            ( now_ns() - start ) / 1e3 );
+
+    enum dynamic_array_simd_level best = dynamic_array_simd_detect();
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        dynamic_array_reset( da );
+        dynamic_array_extend( da, source );
+        start = now_ns();
+        dynamic_array_remove_value( da, -1 );
+        printf( "remove size=%zu method=remove_value/%s: %.0f us\n", size,
+                dynamic_array_simd_level_name(
+                    (enum dynamic_array_simd_level)level ),
+                ( now_ns() - start ) / 1e3 );
+    }
+    dynamic_array_simd_set_level( best );
+
+    dynamic_array_destroy( da );
+    dynamic_array_destroy( source );
+}
+
+// ============================================================================
+// Sliding Window Benchmarks
+// ============================================================================
+
+// drop-oldest window: remove(0) shifts the whole array, the ring moves head
+void bench_window( const size_t window ) {
+    const size_t          pushes = 200000;
+    struct dynamic_array *da     = dynamic_array_create();
+    double                start  = now_ns();
+    for ( size_t i = 0; i < pushes; i++ ) {
+        dynamic_array_push( da, (int)i );
+        if ( da->size > window ) { dynamic_array_remove( da, 0 ); }
+    }
+    printf( "window size=%zu type=array: %.1f ns/push\n", window,
+            ( now_ns() - start ) / (double)pushes );
+    dynamic_array_destroy( da );
+
+    struct dynamic_array_ring *ring = dynamic_array_ring_create();
+    start                           = now_ns();
+    for ( size_t i = 0; i < pushes; i++ ) {
+        dynamic_array_ring_push_back( ring, (int)i );
+        if ( ring->size > window ) { dynamic_array_ring_pop_front( ring ); }
+    }
+    printf( "window size=%zu type=ring: %.1f ns/push\n", window,
+            ( now_ns() - start ) / (double)pushes );
+    dynamic_array_ring_destroy( ring );
+}
+
+// ============================================================================
+// Parallel Scaling Benchmarks
+// ============================================================================
+
+// strong scaling from 1 thread up to the online processors; the find target
+// sits at the end so every chunk is scanned
+void bench_parallel( const size_t size ) {
+    struct dynamic_array *da     = dynamic_array_create();
+    long                  online = sysconf( _SC_NPROCESSORS_ONLN );
+    size_t                max    = online > 0 ? (size_t)online : 1;
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, 0 ); }
+
+    for ( size_t threads = 1;; threads *= 2 ) {
+        if ( threads > max ) { threads = max; }
+        struct dynamic_array_workers *w =
+            dynamic_array_workers_create( threads );
+
+        double start = now_ns();
+        dynamic_array_parallel_fill( w, da, 1, 0 );
+        double fill = ( now_ns() - start ) / 1e6;
+
+        da->buffer[size - 1] = 2;
+        start                = now_ns();
+        volatile ptrdiff_t found =
+            dynamic_array_parallel_find( w, da, 2, 0 );
+        double find = ( now_ns() - start ) / 1e6;
+        (void)found;
+
+        start                = now_ns();
+        volatile int64_t sum = dynamic_array_parallel_sum( w, da, 0 );
+        double           reduce = ( now_ns() - start ) / 1e6;
+        (void)sum;
+
+        unsigned seed = 42;
+        for ( size_t i = 0; i < size; i++ ) {
+            seed          = seed * 1103515245u + 12345u;
+            da->buffer[i] = (int)seed;
+        }
+        da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_SORTED;
+        start = now_ns();
+        dynamic_array_parallel_sort( w, da, 0 );
+        double sort = ( now_ns() - start ) / 1e6;
+
+        printf( "parallel size=%zu threads=%zu: fill %.1f ms, find %.1f ms, "
+                "sum %.1f ms, sort %.1f ms\n",
+                size, threads, fill, find, reduce, sort );
+        dynamic_array_workers_destroy( w );
+        if ( threads == max ) { break; }
+    }
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Concurrent Append Benchmarks
+// ============================================================================
+
+struct append_job {
+    struct dynamic_array_concurrent *c;
+    struct dynamic_array            *da;
+    pthread_mutex_t                 *lock;
+    size_t                           pushes;
+};
+
+static void *append_segmented( void *argument ) {
+    struct append_job *job = argument;
+    for ( size_t i = 0; i < job->pushes; i++ ) {
+        dynamic_array_concurrent_push( job->c, (int)i );
+    }
+    return NULL;
+}
+
+static void *append_locked( void *argument ) {
+    struct append_job *job = argument;
+    for ( size_t i = 0; i < job->pushes; i++ ) {
+        pthread_mutex_lock( job->lock );
+        dynamic_array_push( job->da, (int)i );
+        pthread_mutex_unlock( job->lock );
+    }
+    return NULL;
+}
+
+// total appends split across 1..CPUs producers: mutex around push versus
+// the lock-free segmented array
+void bench_concurrent_append( const size_t total ) {
+    long      online  = sysconf( _SC_NPROCESSORS_ONLN );
+    size_t    max     = online > 0 ? (size_t)online : 1;
+    pthread_t threads[64];
+    if ( max > 64 ) { max = 64; }
+
+    for ( size_t producers = 1;; producers *= 2 ) {
+        if ( producers > max ) { producers = max; }
+        pthread_mutex_t   lock = PTHREAD_MUTEX_INITIALIZER;
+        struct append_job job  = {
+            .c      = dynamic_array_concurrent_create(),
+            .da     = dynamic_array_create(),
+            .lock   = &lock,
+            .pushes = total / producers,
+        };
+
+        double start = now_ns();
+        for ( size_t t = 0; t < producers; t++ ) {
+            pthread_create( &threads[t], NULL, append_locked, &job );
+        }
+        for ( size_t t = 0; t < producers; t++ ) {
+            pthread_join( threads[t], NULL );
+        }
+        printf( "append producers=%zu method=mutex: %.1f ns/push\n",
+                producers, ( now_ns() - start ) / (double)total );
+
+        start = now_ns();
+        for ( size_t t = 0; t < producers; t++ ) {
+            pthread_create( &threads[t], NULL, append_segmented, &job );
+        }
+        for ( size_t t = 0; t < producers; t++ ) {
+            pthread_join( threads[t], NULL );
+        }
+        printf( "append producers=%zu method=segmented: %.1f ns/push\n",
+                producers, ( now_ns() - start ) / (double)total );
+
+        dynamic_array_concurrent_destroy( job.c );
+        dynamic_array_destroy( job.da );
+        pthread_mutex_destroy( &lock );
+        if ( producers == max ) { break; }
+    }
+}
+
+// ============================================================================
+// File-Backed Storage Benchmarks
+// ============================================================================
+
+// startup cost: rebuilding with push versus mapping the saved file, then a
+// full scan that faults the mapped pages in
+void bench_file( const size_t size ) {
+    const char           *path  = "build/bench_array.bin";
+    double                start = now_ns();
+    struct dynamic_array *da    = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, (int)i ); }
+    printf( "startup size=%zu method=push: %.1f ms\n", size,
+            ( now_ns() - start ) / 1e6 );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_create_file( path );
+    if ( da == NULL ) {
+        perror( path );
+        return;
+    }
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, (int)i ); }
+    dynamic_array_destroy( da );
+
+    start = now_ns();
+    da    = dynamic_array_open( path, DYNAMIC_ARRAY_FILE_READ_ONLY );
+    printf( "startup size=%zu method=open: %.3f ms\n", size,
+            ( now_ns() - start ) / 1e6 );
+    start                   = now_ns();
+    volatile ptrdiff_t sink = dynamic_array_find( da, -1 );
+    (void)sink;
+    printf( "first scan size=%zu method=open: %.1f ms\n", size,
+            ( now_ns() - start ) / 1e6 );
+    dynamic_array_destroy( da );
+    remove( path );
+}
+
+// ============================================================================
+// Text I/O Benchmarks
+// ============================================================================
+
+// one integer per line through a temporary file: fprintf per element versus
+// the buffered formatter, then fscanf per element versus the bulk parser
+void bench_text( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < size; i++ ) {
+        dynamic_array_push( da, (int)( i * 2654435761u ) );
+    }
+    FILE *tmp = tmpfile();
+    if ( tmp == NULL ) {
+        perror( "tmpfile" );
+        dynamic_array_destroy( da );
+        return;
+    }
+
+    double start = now_ns();
+    for ( size_t i = 0; i < size; i++ ) {
+        fprintf( tmp, "%d\n", da->buffer[i] );
+    }
+    fflush( tmp );
+    printf( "write size=%zu method=fprintf: %.1f ns/element\n", size,
+            ( now_ns() - start ) / (double)size );
+
+    rewind( tmp );
+    start = now_ns();
+    dynamic_array_write( da, tmp, '\n' );
+    fflush( tmp );
+    printf( "write size=%zu method=buffered: %.1f ns/element\n", size,
+            ( now_ns() - start ) / (double)size );
+
+    struct dynamic_array *in = dynamic_array_create();
+    rewind( tmp );
+    start = now_ns();
+    for ( int value; fscanf( tmp, "%d", &value ) == 1; ) {
+        dynamic_array_push( in, value );
+    }
+    printf( "read size=%zu method=fscanf: %.1f ns/element\n", size,
+            ( now_ns() - start ) / (double)size );
+
+    dynamic_array_clear( in );
+    rewind( tmp );
+    start = now_ns();
+    dynamic_array_read( in, tmp );
+    printf( "read size=%zu method=parse: %.1f ns/element\n", size,
+            ( now_ns() - start ) / (double)size );
+
+    fclose( tmp );
+    dynamic_array_destroy( in );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Microbenchmark Harness
+// ============================================================================
+
+// Every operation runs at sizes 10, 100, ... up to max_size and reports one
+// CSV row: operation,size,ops,ns_per_op,bytes_per_op. bytes_per_op is what
+// the array requested from its allocator during the timed loop.
+
+// elements touched per measurement, spread over as many repetitions as the
+// size allows
+#define MICRO_BUDGET ( (size_t)10000000 )
+
+static size_t micro_allocated;
+
+static void *counting_alloc( void *context, const size_t size ) {
+    (void)context;
+    micro_allocated += size;
+    return malloc( size );
+}
+
+static void *counting_realloc( void *context, void *ptr, const size_t old_size,
+                               const size_t new_size ) {
+    (void)context;
+    (void)old_size;
+    micro_allocated += new_size;
+    return realloc( ptr, new_size );
+}
+
+static const struct dynamic_array_allocator counting_allocator = {
+    .alloc   = counting_alloc,
+    .realloc = counting_realloc,
+    .free    = copying_free,
+    .context = NULL,
+};
+
+static size_t micro_repeats( const size_t work ) {
+    return work >= MICRO_BUDGET ? 1 : MICRO_BUDGET / work;
+}
+
+static struct dynamic_array *micro_filled( const size_t size ) {
+    struct dynamic_array *da = dynamic_array_create_with( NULL,
+                                                          &counting_allocator );
+    dynamic_array_reserve( da, size );
+    for ( size_t i = 0; i < size; i++ ) { dynamic_array_push( da, (int)i ); }
+    return da;
+}
+
+static void micro_report( FILE *csv, const char *operation, const size_t size,
+                          const size_t ops, const double ns,
+                          const size_t bytes ) {
+    fprintf( csv, "%s,%zu,%zu,%.3f,%.3f\n", operation, size, ops,
+             ns / (double)ops, (double)bytes / (double)ops );
+    fflush( csv );
+}
+
+static void micro_push_pop( FILE *csv, const size_t size ) {
+    const size_t repeats = micro_repeats( size );
+    double       push = 0, pop = 0;
+    size_t       bytes = 0;
+    for ( size_t r = 0; r < repeats; r++ ) {
+        struct dynamic_array *da =
+            dynamic_array_create_with( NULL, &counting_allocator );
+        micro_allocated = 0;
+        double start    = now_ns();
+        for ( size_t i = 0; i < size; i++ ) {
+            dynamic_array_push( da, (int)i );
+        }
+        push += now_ns() - start;
+        bytes += micro_allocated;
+
+        volatile int sink = 0;
+        start             = now_ns();
+        for ( size_t i = 0; i < size; i++ ) { sink = dynamic_array_pop( da ); }
+        pop += now_ns() - start;
+        (void)sink;
+        dynamic_array_destroy( da );
+    }
+    micro_report( csv, "push", size, repeats * size, push, bytes );
+    micro_report( csv, "pop", size, repeats * size, pop, 0 );
+}
+
+static void micro_get_set( FILE *csv, const size_t size ) {
+    const size_t          repeats = micro_repeats( size );
+    struct dynamic_array *da      = micro_filled( size );
+    volatile int          sink    = 0;
+
+    double start = now_ns();
+    for ( size_t r = 0; r < repeats; r++ ) {
+        for ( size_t i = 0; i < size; i++ ) {
+            sink = dynamic_array_get( da, i );
+        }
+    }
+    micro_report( csv, "get", size, repeats * size, now_ns() - start, 0 );
+
+    start = now_ns();
+    for ( size_t r = 0; r < repeats; r++ ) {
+        for ( size_t i = 0; i < size; i++ ) {
+            dynamic_array_set( da, i, (int)r );
+        }
+    }
+    micro_report( csv, "set", size, repeats * size, now_ns() - start, 0 );
+    (void)sink;
+    dynamic_array_destroy( da );
+}
+
+// absent value: every find scans the whole array
+static void micro_find( FILE *csv, const size_t size ) {
+    const size_t          repeats = micro_repeats( size );
+    struct dynamic_array *da      = micro_filled( size );
+    volatile ptrdiff_t    sink    = 0;
+    double                start   = now_ns();
+    for ( size_t r = 0; r < repeats; r++ ) {
+        sink = dynamic_array_find( da, -1 );
+    }
+    micro_report( csv, "find", size, repeats, now_ns() - start, 0 );
+    (void)sink;
+    dynamic_array_destroy( da );
+}
+
+// Each insert is paired with a pop and each remove with a push, so the size
+// stays fixed and the O(1) partner adds a constant couple of ns.
+static void micro_insert_remove( FILE *csv, const size_t size ) {
+    static const char *const names[][2] = {
+        { "insert_front", "remove_front" },
+        { "insert_middle", "remove_middle" },
+        { "insert_back", "remove_back" },
+    };
+    const size_t          positions[] = { 0, size / 2, size - 1 };
+    struct dynamic_array *da          = micro_filled( size );
+    volatile int          sink        = 0;
+
+    for ( size_t p = 0; p < 3; p++ ) {
+        const size_t repeats = micro_repeats( size - positions[p] );
+        dynamic_array_reserve( da, size + 1 );
+        micro_allocated = 0;
+
+        double start = now_ns();
+        for ( size_t r = 0; r < repeats; r++ ) {
+            dynamic_array_insert( da, positions[p], (int)r );
+            sink = dynamic_array_pop( da );
+        }
+        micro_report( csv, names[p][0], size, repeats, now_ns() - start,
+                      micro_allocated );
+
+        start = now_ns();
+        for ( size_t r = 0; r < repeats; r++ ) {
+            sink = dynamic_array_remove( da, positions[p] );
+            dynamic_array_push( da, (int)r );
+        }
+        micro_report( csv, names[p][1], size, repeats, now_ns() - start,
+                      micro_allocated );
+    }
+    (void)sink;
+    dynamic_array_destroy( da );
+}
+
+static void micro_rotate( FILE *csv, const size_t size ) {
+    const size_t          repeats = micro_repeats( size );
+    struct dynamic_array *da      = micro_filled( size );
+    double                start   = now_ns();
+    for ( size_t r = 0; r < repeats; r++ ) {
+        dynamic_array_rotate_right_n( da, (int)( size / 3 ) );
+    }
+    micro_report( csv, "rotate_n", size, repeats, now_ns() - start, 0 );
+    dynamic_array_destroy( da );
+}
+
+// one expand of a full array of `size` elements; the arrays are built
+// first so only the reallocations are timed
+static void micro_expand( FILE *csv, const size_t size ) {
+    size_t repeats = micro_repeats( size );
+    if ( repeats > 1000 ) { repeats = 1000; }
+    struct dynamic_array **arrays = malloc( sizeof *arrays * repeats );
+    for ( size_t r = 0; r < repeats; r++ ) { arrays[r] = micro_filled( size ); }
+
+    micro_allocated = 0;
+    double start    = now_ns();
+    for ( size_t r = 0; r < repeats; r++ ) {
+        dynamic_array_expand( arrays[r] );
+    }
+    micro_report( csv, "expand", size, repeats, now_ns() - start,
+                  micro_allocated );
+
+    for ( size_t r = 0; r < repeats; r++ ) {
+        dynamic_array_destroy( arrays[r] );
+    }
+    free( arrays );
+}
+
+void bench_micro( FILE *csv, const size_t max_size ) {
+    fprintf( csv, "operation,size,ops,ns_per_op,bytes_per_op\n" );
+    for ( size_t size = 10; size <= max_size; size *= 10 ) {
+        micro_push_pop( csv, size );
+        micro_get_set( csv, size );
+        micro_find( csv, size );
+        micro_insert_remove( csv, size );
+        micro_rotate( csv, size );
+        micro_expand( csv, size );
+    }
+}
+
+// usage: bench [--csv PATH] [--max-size N] [--micro-only]
+// the microbenchmark CSV goes to PATH, or to stdout after the other results
+int main( int argc, char **argv ) {
+    const char *csv_path   = NULL;
+    size_t      max_size   = 100000000;
+    bool        micro_only = false;
+    for ( int i = 1; i < argc; i++ ) {
+        if ( strcmp( argv[i], "--csv" ) == 0 && i + 1 < argc ) {
+            csv_path = argv[++i];
+        } else if ( strcmp( argv[i], "--max-size" ) == 0 && i + 1 < argc ) {
+            max_size = strtoull( argv[++i], NULL, 10 );
+        } else if ( strcmp( argv[i], "--micro-only" ) == 0 ) {
+            micro_only = true;
+        } else {
+            fprintf( stderr,
+                     "usage: %s [--csv PATH] [--max-size N] [--micro-only]\n",
+                     argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+    FILE *csv = csv_path ? fopen( csv_path, "w" ) : stdout;
+    if ( csv == NULL ) {
+        perror( csv_path );
+        return EXIT_FAILURE;
+    }
+
+    if ( !micro_only ) {
+        // first, while this process is still small: children inherit its RSS
+        bench_growth( (size_t)3 << 24 );
+        bench_shrink( 10000000 );
+        bench_rotate_n( 1000 );
+        bench_rotate_n( 100000 );
+        bench_find( 100000 );
+        bench_find( 10000000 );
+        bench_reduce( 100000 );
+        bench_index( 1000 );
+        bench_index( 1000000 );
+        bench_clone( 1000000 );
+        bench_frozen( 1000000 );
+        bench_set( 1000000 );
+        bench_sort( 1000000 );
+        bench_remove( 1000000 );
+        bench_window( 64 );
+        bench_window( 10000 );
+        bench_parallel( 10000000 );
+        bench_concurrent_append( 10000000 );
+        bench_file( 10000000 );
+        bench_text( 10000000 );
+        if ( csv == stdout ) { printf( "\n" ); }
+    }
+    bench_micro( csv, max_size );
+    if ( csv != stdout && fclose( csv ) != 0 ) { return EXIT_FAILURE; }
+    return EXIT_SUCCESS;
+}
@@ -1,23 +1,16 @@
-// FIX: Add error handling for release mode
-// FIX: Add bounds checking in release mode (assertions compile out)
 // TODO: Add documentation
-// TODO: Add shrink_to_fit() - Reduce capacity to match size.
-// TODO: Add reserve() - Ensures at least `n` capacity without changing size.
 // TODO: Add usage examples
-// FIX: add error codes
 // TODO: Add helper functions for index, size, pointer validations
-// FIX: Convert hard coded int type to generic
 
 #include "dynamic_array.h"
 
+#include "dynamic_array_simd.h"
+#include "dynamic_array_view.h"
+
 #include <assert.h>
 #include <limits.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
-#define DEFAULT_CAPACITY 8
-
 // Debug macro - disabled by default, can be enabled with -DDEBUG=1
 #ifndef DEBUG
 #define DEBUG 0
@@ -33,211 +26,360 @@
 #define INTERNAL 0
 #endif
 
-static int euclidean_division( const int a, const int b );
-
-struct dynamic_array *dynamic_array_create( void ) {
-    struct dynamic_array *da;
-    da = malloc( sizeof *da );
-    assert( da != NULL );
-    dynamic_array_init( da );
-    return da;
+// generic storage, growth, access and rotation for the int instantiation
+#define DYNAMIC_ARRAY_NAME            dynamic_array
+#define DYNAMIC_ARRAY_TYPE            int
+#define DYNAMIC_ARRAY_CUSTOM_SEARCH   1
+#define DYNAMIC_ARRAY_HASH_INDEX      1
+#define DYNAMIC_ARRAY_INLINE_CAPACITY DYNAMIC_ARRAY_INT_INLINE_CAPACITY
+#define DYNAMIC_ARRAY_IMPLEMENTATION  1
+#include "dynamic_array_template.h"
+
+#define DYNAMIC_ARRAY_NAME           dynamic_array_ring
+#define DYNAMIC_ARRAY_TYPE           int
+#define DYNAMIC_ARRAY_IMPLEMENTATION 1
+#include "dynamic_array_ring_template.h"
+
+static bool is_sorted( const struct dynamic_array *da ) {
+    return ( da->flags & DYNAMIC_ARRAY_FLAG_SORTED ) != 0;
 }
 
-void dynamic_array_init( struct dynamic_array *da ) {
-    da->size     = 0;
-    da->capacity = DEFAULT_CAPACITY;
-    da->buffer   = malloc( sizeof *da->buffer * da->capacity );
-    assert( da->buffer != NULL );
+// elements a binary search over n compares, for the stats counters
+static inline size_t probes( const size_t n ) {
+    return n ? (size_t)( 64 - __builtin_clzll( n ) ) : 0;
 }
 
-void dynamic_array_clear( struct dynamic_array *da ) {
+// time: expected O(1) with a hash index, O(log N) when sorted, otherwise O(N)
+// vectorized with the kernel picked at runtime (see dynamic_array_simd.c);
+// returns -1 when the value is absent
+ptrdiff_t dynamic_array_find( const struct dynamic_array *da,
+                              const int                   value ) {
     assert( da != NULL );
-    if ( da->buffer ) {
-        free( da->buffer );
-        dynamic_array_init( da );
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) {
+        DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                             1 );
+        size_t i = dynamic_array_index_lookup( da->index, value, da->size );
+        return i == da->size ? -1 : (ptrdiff_t)i;
     }
+    if ( is_sorted( da ) ) {
+        DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                             probes( da->size ) );
+        size_t i =
+            dynamic_array_simd_lower_bound( da->buffer, da->size, value );
+        return i < da->size && da->buffer[i] == value ? (ptrdiff_t)i : -1;
+    }
+    size_t i = dynamic_array_simd_find( da->buffer, da->size, value );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         i == da->size ? i : i + 1 );
+    return i == da->size ? -1 : (ptrdiff_t)i;
 }
 
-void dynamic_array_destroy( struct dynamic_array *da ) {
+// time: O(log N) when sorted, otherwise O(N)
+ptrdiff_t dynamic_array_find_last( const struct dynamic_array *da,
+                                   const int                   value ) {
     assert( da != NULL );
-    dynamic_array_clear( da );
-    free( da );
-    da = NULL;
+    if ( is_sorted( da ) ) {
+        DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                             probes( da->size ) );
+        size_t i =
+            dynamic_array_simd_upper_bound( da->buffer, da->size, value );
+        return i > 0 && da->buffer[i - 1] == value ? (ptrdiff_t)( i - 1 ) : -1;
+    }
+    size_t i = dynamic_array_simd_find_last( da->buffer, da->size, value );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         i == da->size ? i : da->size - i );
+    return i == da->size ? -1 : (ptrdiff_t)i;
 }
 
-size_t dynamic_array_size( const struct dynamic_array *da ) {
+// time: O(log N) when sorted, otherwise O(N)
+size_t dynamic_array_count( const struct dynamic_array *da,
+                            const int                   value ) {
     assert( da != NULL );
-    return da->size;
+    if ( is_sorted( da ) ) {
+        DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                             2 * probes( da->size ) );
+        return dynamic_array_simd_upper_bound( da->buffer, da->size, value ) -
+               dynamic_array_simd_lower_bound( da->buffer, da->size, value );
+    }
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    return dynamic_array_simd_count( da->buffer, da->size, value );
 }
 
-size_t dynamic_array_capacity( const struct dynamic_array *da ) {
+// time: O(N), or O(log N + matches) when sorted
+// writes the first `max` matching indices to `out` and returns the total
+// number of matches, so a short `out` can be resized and the call repeated
+size_t dynamic_array_find_all( const struct dynamic_array *da,
+                               const int value, size_t *out,
+                               const size_t max ) {
     assert( da != NULL );
-    return da->capacity;
+    assert( out != NULL || max == 0 );
+    if ( is_sorted( da ) ) {
+        DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                             2 * probes( da->size ) );
+        size_t first =
+            dynamic_array_simd_lower_bound( da->buffer, da->size, value );
+        size_t last =
+            dynamic_array_simd_upper_bound( da->buffer, da->size, value );
+        for ( size_t i = first; i < last && i - first < max; i++ ) {
+            out[i - first] = i;
+        }
+        return last - first;
+    }
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    return dynamic_array_simd_find_all( da->buffer, da->size, value, out,
+                                        max );
 }
 
-void dynamic_array_expand( struct dynamic_array *da ) {
-    assert( da != NULL );
-    assert( ( sizeof *da->buffer * ( da->capacity << 1 ) ) < SIZE_MAX );
-    da->capacity <<= 1; // capacity is doubled through bit shifting
-    int *buffer = realloc( da->buffer, sizeof *da->buffer * da->capacity );
-    assert( buffer != NULL );
-    da->buffer = buffer;
-}
+// ============================================================================
+// Reductions
+// ============================================================================
 
-void dynamic_array_push( struct dynamic_array *da, const int value ) {
-    if ( da->size + 1 >= da->capacity ) { dynamic_array_expand( da ); }
-    da->buffer[da->size++] = value;
+// time: O(N) vectorized; accumulated in 64 bits, 0 for an empty array
+int64_t dynamic_array_sum( const struct dynamic_array *da ) {
+    assert( da != NULL );
+    return dynamic_array_simd_sum( da->buffer, da->size );
 }
 
-int dynamic_array_pop( struct dynamic_array *da ) {
-    // FIX: undefined behavior on empty array in non-debug mode
-    assert( da->size > 0 );
-    return da->buffer[--da->size];
+// time: O(1) when sorted, otherwise O(N) vectorized
+int dynamic_array_min( const struct dynamic_array *da ) {
+    assert( da != NULL && da->size > 0 );
+    if ( is_sorted( da ) ) { return da->buffer[0]; }
+    return dynamic_array_simd_min( da->buffer, da->size );
 }
 
-void dynamic_array_print( const struct dynamic_array *da ) {
-    assert( da != NULL );
-    for ( size_t i = 0; i < da->size; i++ ) { printf( "%d ", da->buffer[i] ); }
-    putchar( '\n' );
+// time: O(1) when sorted, otherwise O(N)
+int dynamic_array_max( const struct dynamic_array *da ) {
+    assert( da != NULL && da->size > 0 );
+    if ( is_sorted( da ) ) { return da->buffer[da->size - 1]; }
+    return dynamic_array_simd_max( da->buffer, da->size );
 }
 
-int dynamic_array_find( const struct dynamic_array *da, const int value ) {
-    assert( da != NULL );
-    for ( size_t i = 0; i < da->size; i++ ) {
-        if ( da->buffer[i] == value ) { return (int)i; }
+// time: O(1) when sorted, otherwise one O(N) pass for both
+void dynamic_array_minmax( const struct dynamic_array *da, int *min,
+                           int *max ) {
+    assert( da != NULL && da->size > 0 );
+    assert( min != NULL && max != NULL );
+    if ( is_sorted( da ) ) {
+        *min = da->buffer[0];
+        *max = da->buffer[da->size - 1];
+        return;
     }
-    return -1;
+    dynamic_array_simd_minmax( da->buffer, da->size, min, max );
 }
 
-// FIX: These functions should validate non-NULL inputs at runtime
-int dynamic_array_get( const struct dynamic_array *da, const size_t index ) {
-    assert( da != NULL );
-    assert( index < da->size );
-    return da->buffer[index];
+// time: O(1) when sorted, otherwise O(N); the first minimum
+size_t dynamic_array_argmin( const struct dynamic_array *da ) {
+    assert( da != NULL && da->size > 0 );
+    if ( is_sorted( da ) ) { return 0; }
+    return dynamic_array_simd_argmin( da->buffer, da->size );
 }
 
-void dynamic_array_set( const struct dynamic_array *da, const size_t index,
-                        const int value ) {
-    assert( da != NULL );
-    assert( index < da->size );
-    da->buffer[index] = value;
+// time: O(log N) when sorted, otherwise O(N); the first maximum
+size_t dynamic_array_argmax( const struct dynamic_array *da ) {
+    assert( da != NULL && da->size > 0 );
+    if ( is_sorted( da ) ) {
+        return dynamic_array_simd_lower_bound( da->buffer, da->size,
+                                               da->buffer[da->size - 1] );
+    }
+    return dynamic_array_simd_argmax( da->buffer, da->size );
 }
 
-int dynamic_array_front( const struct dynamic_array *da ) {
-    assert( da != NULL );
-    assert( da->size > 0 );
-    return da->buffer[0];
+// ============================================================================
+// Sorting
+// ============================================================================
+
+// below this size insertion sort beats the four histogram passes
+#define RADIX_THRESHOLD 64
+
+static void insertion_sort( int *data, const size_t n ) {
+    for ( size_t i = 1; i < n; i++ ) {
+        int    value = data[i];
+        size_t j     = i;
+        for ( ; j > 0 && data[j - 1] > value; j-- ) { data[j] = data[j - 1]; }
+        data[j] = value;
+    }
 }
 
-int dynamic_array_back( const struct dynamic_array *da ) {
-    assert( da != NULL );
-    assert( da->size > 0 );
-    return da->buffer[da->size - 1];
+// flipping the sign bit maps INT_MIN..INT_MAX onto 0..UINT32_MAX in order
+static inline uint32_t radix_key( const int value ) {
+    return (uint32_t)value ^ 0x80000000u;
 }
 
-// time: O(N)
-void dynamic_array_insert( struct dynamic_array *da, const size_t index,
-                           const int value ) {
-    assert( index <= da->size );
-    if ( da->size + 1 >= da->capacity ) { dynamic_array_expand( da ); }
-    for ( size_t i = da->size; i > index; i-- ) {
-        da->buffer[i] = da->buffer[i - 1];
+// LSD radix sort, one byte per pass. All four histograms are built in a
+// single read of the input, and passes where every key shares the same byte
+// are skipped, so e.g. small non-negative values cost one or two passes.
+static void radix_sort( int *data, int *scratch, const size_t n ) {
+    size_t counts[4][256] = { 0 };
+    for ( size_t i = 0; i < n; i++ ) {
+        uint32_t key = radix_key( data[i] );
+        counts[0][key & 0xFF]++;
+        counts[1][( key >> 8 ) & 0xFF]++;
+        counts[2][( key >> 16 ) & 0xFF]++;
+        counts[3][key >> 24]++;
     }
-    da->buffer[index] = value;
-    da->size++;
-}
 
-int dynamic_array_remove( struct dynamic_array *da, const size_t index ) {
-    assert( index < da->size && da->size > 0 );
-    int item = da->buffer[index];
-    for ( size_t i = index; i < da->size - 1; i++ ) {
-        da->buffer[i] = da->buffer[i + 1];
+    int *src = data;
+    int *dst = scratch;
+    for ( unsigned pass = 0; pass < 4; pass++ ) {
+        const unsigned shift = pass * 8;
+        if ( counts[pass][( radix_key( src[0] ) >> shift ) & 0xFF] == n ) {
+            continue;
+        }
+        size_t offset = 0;
+        for ( size_t b = 0; b < 256; b++ ) {
+            size_t count    = counts[pass][b];
+            counts[pass][b] = offset;
+            offset += count;
+        }
+        for ( size_t i = 0; i < n; i++ ) {
+            size_t byte               = ( radix_key( src[i] ) >> shift ) & 0xFF;
+            dst[counts[pass][byte]++] = src[i];
+        }
+        int *temp = src;
+        src       = dst;
+        dst       = temp;
     }
-    da->size--;
-    return item;
+    if ( src != data ) { memcpy( data, src, sizeof *data * n ); }
 }
 
-int dynamic_array_find_transposition( struct dynamic_array *da, int value ) {
-    // every time the value is found, swap it one position to the left
-    // frequently searched for value is gradually moved to the front to
-    // reduce search time
-    int position = dynamic_array_find( da, value );
-    if ( position > 0 ) {
-        int temp_value           = da->buffer[position];
-        da->buffer[position]     = da->buffer[position - 1];
-        da->buffer[position - 1] = temp_value;
-        position--;
+static void sort_ints( int *data, const size_t n,
+                       const struct dynamic_array_allocator *allocator ) {
+    if ( n < RADIX_THRESHOLD ) {
+        insertion_sort( data, n );
+        return;
     }
-    return position;
+    const size_t bytes   = sizeof *data * n;
+    int         *scratch = allocator->alloc( allocator->context, bytes );
+    assert( scratch != NULL );
+    radix_sort( data, scratch, n );
+    allocator->free( allocator->context, scratch, bytes );
 }
 
-// time: O(N)
-void dynamic_array_rotate_right( struct dynamic_array *da ) {
-    // retrieve the last element
-    // shift all elements to the right
-    // set first element to previously saved last element
-    int last = da->buffer[da->size - 1];
-    for ( size_t i = da->size - 1; i > 0; i-- ) {
-        da->buffer[i] = da->buffer[i - 1];
-    }
-    da->buffer[0] = last;
+// time: O(N) (at most four passes), O(N^2) insertion sort below 64 elements
+// sorts ascending and marks the array sorted; the scratch buffer comes from
+// the array's allocator
+void dynamic_array_sort( struct dynamic_array *da ) {
+    assert( da != NULL );
+    if ( is_sorted( da ) ) { return; }
+    dynamic_array_unshare( da );
+    sort_ints( da->buffer, da->size, da->allocator );
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+    da->flags |= DYNAMIC_ARRAY_FLAG_SORTED;
+    dynamic_array_index_refresh( da );
 }
 
-// time: O(N)
-void dynamic_array_rotate_left( struct dynamic_array *da ) {
-    // retrieve the first element
-    // shift all elements to the left
-    // set last element to previously saved first element
-    int first = da->buffer[0];
-    for ( size_t i = 0; i < da->size - 1; i++ ) {
-        da->buffer[i] = da->buffer[i + 1];
+// time: as dynamic_array_sort; a strided view is gathered into a scratch
+// buffer from the array's allocator, sorted there and scattered back
+void dynamic_array_view_sort( const struct dynamic_array_view view ) {
+    struct dynamic_array *da = view.array;
+    assert( da != NULL );
+    if ( is_sorted( da ) || view.size < 2 ) { return; }
+    dynamic_array_view_touch( view );
+    if ( view.stride == 1 ) {
+        sort_ints( view.data, view.size, da->allocator );
+        dynamic_array_index_refresh( da );
+        return;
+    }
+    const size_t bytes    = sizeof *view.data * view.size;
+    int         *gathered = da->allocator->alloc( da->allocator->context,
+                                                  bytes );
+    assert( gathered != NULL );
+    for ( size_t i = 0; i < view.size; i++ ) {
+        gathered[i] = view.data[i * view.stride];
     }
-    da->buffer[da->size - 1] = first;
+    sort_ints( gathered, view.size, da->allocator );
+    for ( size_t i = 0; i < view.size; i++ ) {
+        view.data[i * view.stride] = gathered[i];
+    }
+    da->allocator->free( da->allocator->context, gathered, bytes );
+    dynamic_array_index_refresh( da );
 }
 
-void dynamic_array_rotate_right_n( struct dynamic_array *da, int count ) {
-    // get the mod so as not to do redundant operations
-    int rotations = euclidean_division( count, da->size );
-    for ( size_t i = 0; i < rotations; i++ ) {
-        dynamic_array_rotate_right( da );
-    }
+bool dynamic_array_is_sorted( const struct dynamic_array *da ) {
+    assert( da != NULL );
+    return is_sorted( da );
 }
 
-void dynamic_array_rotate_left_n( struct dynamic_array *da, int count ) {
-    // get the mod so as not to do redundant operations
-    int rotations = euclidean_division( count, da->size );
-    for ( size_t i = 0; i < rotations; i++ ) {
-        dynamic_array_rotate_left( da );
-    }
+// time: O(log N)
+// the array must be in ascending order (sorted, or built in order)
+size_t dynamic_array_lower_bound( const struct dynamic_array *da,
+                                  const int                   value ) {
+    assert( da != NULL );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         probes( da->size ) );
+    return dynamic_array_simd_lower_bound( da->buffer, da->size, value );
 }
 
-void dynamic_array_fill( struct dynamic_array *da, const int value ) {
+// time: O(log N)
+size_t dynamic_array_upper_bound( const struct dynamic_array *da,
+                                  const int                   value ) {
     assert( da != NULL );
-    assert( da->size > 0 );
-    for ( size_t i = 0; i < da->size; i++ ) { da->buffer[i] = value; }
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         probes( da->size ) );
+    return dynamic_array_simd_upper_bound( da->buffer, da->size, value );
 }
 
-bool dynamic_array_empty( const struct dynamic_array *da ) {
+// time: O(log N)
+bool dynamic_array_binary_search( const struct dynamic_array *da,
+                                  const int                   value ) {
     assert( da != NULL );
-    return da->size == 0;
-}
-
-// https://en.wikipedia.org/wiki/Euclidean_division
-// a = bq + r and 0 <= r < |b|
-// euclidean modulo == euclidean division
-// In C/C++, a % b always returns results with the sign of a
-// Mathematically, modulo is always non-negative
-// % -> remainder operator in C
-// % -> already behaves like Euclidean modulo for unsigned integers
-// returns between [0,n-1], (same behavior of the modulo operator in python)
-int euclidean_division( const int a, const int b ) {
-    if ( b == 0 ) { // b == 0 is Undefined Behavior/Division by zero error
-        return 0;
-    }
-    if ( a == INT_MIN && b == -1 ) {
-        return 0; // mathematically 0 but UB because of overflow
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         probes( da->size ) );
+    size_t i = dynamic_array_simd_lower_bound( da->buffer, da->size, value );
+    return i < da->size && da->buffer[i] == value;
+}
+
+// time: O(N) for the shift, O(log N) to find the slot
+// inserts after any equal elements and keeps the sorted flag as it was
+size_t dynamic_array_insert_sorted( struct dynamic_array *da,
+                                    const int             value ) {
+    assert( da != NULL );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         probes( da->size ) );
+    const unsigned sorted = da->flags & DYNAMIC_ARRAY_FLAG_SORTED;
+    size_t         index =
+        dynamic_array_simd_upper_bound( da->buffer, da->size, value );
+    dynamic_array_insert( da, index, value );
+    da->flags |= sorted;
+    return index;
+}
+
+// time: O(N), single vectorized compaction pass; returns how many elements
+// were removed
+size_t dynamic_array_remove_value( struct dynamic_array *da,
+                                   const int             value ) {
+    assert( da != NULL );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    dynamic_array_unshare( da );
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+    size_t kept    = dynamic_array_simd_remove( da->buffer, da->size, value );
+    size_t removed = da->size - kept;
+    da->size       = kept;
+    dynamic_array_settle( da );
+    dynamic_array_index_refresh( da );
+    return removed;
+}
+
+ptrdiff_t dynamic_array_find_transposition( struct dynamic_array *da,
+                                            const int             value ) {
+    // every time the value is found, swap it one position to the left
+    // frequently searched for value is gradually moved to the front to
+    // reduce search time
+    ptrdiff_t position = dynamic_array_find( da, value );
+    if ( position > 0 ) {
+        dynamic_array_unshare( da );
+        da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_SORTED;
+        int temp_value           = da->buffer[position];
+        da->buffer[position]     = da->buffer[position - 1];
+        da->buffer[position - 1] = temp_value;
+        position--;
+        if ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) {
+            dynamic_array_index_swap( da->index, da->buffer,
+                                      (size_t)position );
+        }
     }
-    long long r = a % b;
-    if ( r < 0 ) { r += abs( b ); }
-    return r;
+    return position;
 }
@@ -9,38 +9,61 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
-struct dynamic_array {
-    int   *buffer;
-    size_t size;
-    size_t capacity;
-};
-
-extern struct dynamic_array *dynamic_array_create( void );
-extern void                  dynamic_array_init( struct dynamic_array *da );
-extern void                  dynamic_array_clear( struct dynamic_array *da );
-extern void                  dynamic_array_destroy( struct dynamic_array *da );
-extern void   dynamic_array_push( struct dynamic_array *da, const int value );
-extern int    dynamic_array_pop( struct dynamic_array *da );
-extern size_t dynamic_array_size( const struct dynamic_array *da );
-extern size_t dynamic_array_capacity( const struct dynamic_array *da );
-extern bool   dynamic_array_empty( const struct dynamic_array *da );
-extern void   dynamic_array_fill( struct dynamic_array *da, const int value );
-extern void   dynamic_array_expand( struct dynamic_array *da );
-extern void   dynamic_array_rotate_right( struct dynamic_array *da );
-extern void   dynamic_array_rotate_left( struct dynamic_array *da );
-extern void   dynamic_array_rotate_right_n( struct dynamic_array *da,
-                                            const int             value );
-extern void   dynamic_array_rotate_left_n( struct dynamic_array *da,
+// Inline (small-buffer) capacity of the int array, off by default; build with
+// -DDYNAMIC_ARRAY_INT_INLINE_CAPACITY=16 to keep up to 16 ints in the struct.
+#ifndef DYNAMIC_ARRAY_INT_INLINE_CAPACITY
+#define DYNAMIC_ARRAY_INT_INLINE_CAPACITY 0
+#endif
+
+// The int array is one instantiation of dynamic_array_template.h; the search
+// functions are replaced by the SIMD kernels declared below.
+#define DYNAMIC_ARRAY_NAME            dynamic_array
+#define DYNAMIC_ARRAY_TYPE            int
+#define DYNAMIC_ARRAY_CUSTOM_SEARCH   1
+#define DYNAMIC_ARRAY_HASH_INDEX      1
+#define DYNAMIC_ARRAY_INLINE_CAPACITY DYNAMIC_ARRAY_INT_INLINE_CAPACITY
+#include "dynamic_array_template.h"
+
+// int ring buffer (deque) for sliding windows, see
+// dynamic_array_ring_template.h
+#define DYNAMIC_ARRAY_NAME dynamic_array_ring
+#define DYNAMIC_ARRAY_TYPE int
+#include "dynamic_array_ring_template.h"
+
+// "%d " per element and a newline to stdout; see dynamic_array_text.h
+extern void      dynamic_array_print( const struct dynamic_array *da );
+extern ptrdiff_t dynamic_array_find( const struct dynamic_array *da,
+                                     const int                   value );
+extern ptrdiff_t dynamic_array_find_last( const struct dynamic_array *da,
+                                          const int                   value );
+extern size_t    dynamic_array_count( const struct dynamic_array *da,
+                                      const int                   value );
+extern size_t    dynamic_array_find_all( const struct dynamic_array *da,
+                                         const int value, size_t *out,
+                                         const size_t max );
+extern int64_t   dynamic_array_sum( const struct dynamic_array *da );
+// min, max and the arg variants require a non-empty array; arg variants
+// return the first position of the extreme value
+extern int       dynamic_array_min( const struct dynamic_array *da );
+extern int       dynamic_array_max( const struct dynamic_array *da );
+extern void      dynamic_array_minmax( const struct dynamic_array *da,
+                                       int *min, int *max );
+extern size_t    dynamic_array_argmin( const struct dynamic_array *da );
+extern size_t    dynamic_array_argmax( const struct dynamic_array *da );
+extern size_t    dynamic_array_remove_value( struct dynamic_array *da,
+                                             const int             value );
+extern ptrdiff_t
+dynamic_array_find_transposition( struct dynamic_array *da, const int value );
+extern void   dynamic_array_sort( struct dynamic_array *da );
+extern bool   dynamic_array_is_sorted( const struct dynamic_array *da );
+extern size_t dynamic_array_lower_bound( const struct dynamic_array *da,
+                                         const int                   value );
+extern size_t dynamic_array_upper_bound( const struct dynamic_array *da,
+                                         const int                   value );
+extern bool   dynamic_array_binary_search( const struct dynamic_array *da,
+                                           const int                   value );
+extern size_t dynamic_array_insert_sorted( struct dynamic_array *da,
                                            const int             value );
-extern int    dynamic_array_get( const struct dynamic_array *da,
-                                 const size_t                index );
-extern void   dynamic_array_set( const struct dynamic_array *da,
-                                 const size_t index, const int value );
-extern void   dynamic_array_print( const struct dynamic_array *da );
-extern int    dynamic_array_find( const struct dynamic_array *da,
-                                  const int                   value );
-extern int    dynamic_array_front( const struct dynamic_array *da );
-extern int    dynamic_array_back( const struct dynamic_array *da );
 
 #ifdef __cplusplus
 }
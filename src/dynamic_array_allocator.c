@@ -0,0 +1,249 @@
+#include "dynamic_array_allocator.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGNMENT        alignof( max_align_t )
+#define ALIGN_UP( n, a ) ( ( ( n ) + ( a ) - 1 ) & ~( (size_t)( a ) - 1 ) )
+
+// ============================================================================
+// Heap allocator
+// ============================================================================
+
+static void *heap_alloc( void *context, const size_t size ) {
+    (void)context;
+    return malloc( size );
+}
+
+static void *heap_realloc( void *context, void *ptr, const size_t old_size,
+                           const size_t new_size ) {
+    (void)context;
+    (void)old_size;
+    return realloc( ptr, new_size );
+}
+
+static void heap_free( void *context, void *ptr, const size_t size ) {
+    (void)context;
+    (void)size;
+    free( ptr );
+}
+
+const struct dynamic_array_allocator dynamic_array_heap_allocator = {
+    .alloc   = heap_alloc,
+    .realloc = heap_realloc,
+    .free    = heap_free,
+    .context = NULL,
+};
+
+// ============================================================================
+// Arena allocator
+// ============================================================================
+
+struct dynamic_array_arena_block {
+    struct dynamic_array_arena_block *next;
+    size_t                            capacity;
+    size_t                            used;
+};
+
+#define BLOCK_HEADER ALIGN_UP( sizeof( struct dynamic_array_arena_block ), \
+                               ALIGNMENT )
+
+static unsigned char *block_data( struct dynamic_array_arena_block *block ) {
+    return (unsigned char *)block + BLOCK_HEADER;
+}
+
+static void *arena_alloc( void *context, const size_t size ) {
+    struct dynamic_array_arena       *arena   = context;
+    struct dynamic_array_arena_block *block   = arena->head;
+    const size_t                      aligned = ALIGN_UP( size, ALIGNMENT );
+    assert( aligned >= size );
+
+    if ( block == NULL || block->capacity - block->used < aligned ) {
+        // oversized requests get a block of their own
+        size_t capacity =
+            aligned > arena->block_size ? aligned : arena->block_size;
+        block = malloc( BLOCK_HEADER + capacity );
+        if ( block == NULL ) { return NULL; }
+        block->next     = arena->head;
+        block->capacity = capacity;
+        block->used     = 0;
+        arena->head     = block;
+    }
+
+    void *ptr = block_data( block ) + block->used;
+    block->used += aligned;
+    arena->last = ptr;
+    return ptr;
+}
+
+static void *arena_realloc( void *context, void *ptr, const size_t old_size,
+                            const size_t new_size ) {
+    struct dynamic_array_arena       *arena = context;
+    struct dynamic_array_arena_block *block = arena->head;
+    if ( ptr == NULL ) { return arena_alloc( context, new_size ); }
+
+    // the most recent allocation can be resized by moving the bump pointer
+    if ( ptr == arena->last ) {
+        size_t offset  = (size_t)( (unsigned char *)ptr - block_data( block ) );
+        size_t aligned = ALIGN_UP( new_size, ALIGNMENT );
+        if ( aligned <= block->capacity - offset ) {
+            block->used = offset + aligned;
+            return ptr;
+        }
+    }
+
+    void *moved = arena_alloc( context, new_size );
+    if ( moved == NULL ) { return NULL; }
+    memcpy( moved, ptr, old_size < new_size ? old_size : new_size );
+    return moved;
+}
+
+static void arena_free( void *context, void *ptr, const size_t size ) {
+    struct dynamic_array_arena *arena = context;
+    (void)size;
+    // only the most recent allocation is handed back, the rest waits for
+    // dynamic_array_arena_reset
+    if ( ptr != NULL && ptr == arena->last ) {
+        arena->head->used =
+            (size_t)( (unsigned char *)ptr - block_data( arena->head ) );
+        arena->last = NULL;
+    }
+}
+
+void dynamic_array_arena_init( struct dynamic_array_arena *arena,
+                               const size_t                block_size ) {
+    assert( arena != NULL );
+    assert( block_size > 0 );
+    arena->head       = NULL;
+    arena->block_size = ALIGN_UP( block_size, ALIGNMENT );
+    arena->last       = NULL;
+    arena->allocator  = ( struct dynamic_array_allocator ){
+         .alloc   = arena_alloc,
+         .realloc = arena_realloc,
+         .free    = arena_free,
+         .context = arena,
+    };
+}
+
+// frees every allocation at once; the newest block is kept and rewound so
+// the next request starts without touching malloc
+void dynamic_array_arena_reset( struct dynamic_array_arena *arena ) {
+    assert( arena != NULL );
+    struct dynamic_array_arena_block *block = arena->head;
+    if ( block == NULL ) { return; }
+    struct dynamic_array_arena_block *next = block->next;
+    while ( next != NULL ) {
+        struct dynamic_array_arena_block *older = next->next;
+        free( next );
+        next = older;
+    }
+    block->next = NULL;
+    block->used = 0;
+    arena->last = NULL;
+}
+
+void dynamic_array_arena_destroy( struct dynamic_array_arena *arena ) {
+    assert( arena != NULL );
+    while ( arena->head != NULL ) {
+        struct dynamic_array_arena_block *next = arena->head->next;
+        free( arena->head );
+        arena->head = next;
+    }
+    arena->last = NULL;
+}
+
+size_t dynamic_array_arena_used( const struct dynamic_array_arena *arena ) {
+    assert( arena != NULL );
+    size_t used = 0;
+    for ( struct dynamic_array_arena_block *block = arena->head; block;
+          block = block->next ) {
+        used += block->used;
+    }
+    return used;
+}
+
+// ============================================================================
+// Pool allocator
+// ============================================================================
+
+// chunks are chained through their first aligned slot
+#define CHUNK_HEADER ALIGN_UP( sizeof( void * ), ALIGNMENT )
+
+static void *pool_alloc( void *context, const size_t size ) {
+    struct dynamic_array_pool *pool = context;
+    assert( size <= pool->object_size );
+    (void)size;
+
+    if ( pool->free_list == NULL ) {
+        unsigned char *chunk =
+            malloc( CHUNK_HEADER + pool->object_size * pool->chunk_objects );
+        if ( chunk == NULL ) { return NULL; }
+        memcpy( chunk, &pool->chunks, sizeof pool->chunks );
+        pool->chunks = chunk;
+        // thread the new objects onto the free list back to front so they
+        // are handed out in address order
+        for ( size_t i = pool->chunk_objects; i > 0; i-- ) {
+            unsigned char *object =
+                chunk + CHUNK_HEADER + ( i - 1 ) * pool->object_size;
+            memcpy( object, &pool->free_list, sizeof pool->free_list );
+            pool->free_list = object;
+        }
+    }
+
+    void *object = pool->free_list;
+    memcpy( &pool->free_list, object, sizeof pool->free_list );
+    return object;
+}
+
+static void *pool_realloc( void *context, void *ptr, const size_t old_size,
+                           const size_t new_size ) {
+    struct dynamic_array_pool *pool = context;
+    (void)pool;
+    (void)old_size;
+    assert( new_size <= pool->object_size );
+    (void)new_size;
+    return ptr != NULL ? ptr : pool_alloc( context, new_size );
+}
+
+static void pool_free( void *context, void *ptr, const size_t size ) {
+    struct dynamic_array_pool *pool = context;
+    (void)size;
+    if ( ptr == NULL ) { return; }
+    memcpy( ptr, &pool->free_list, sizeof pool->free_list );
+    pool->free_list = ptr;
+}
+
+void dynamic_array_pool_init( struct dynamic_array_pool *pool,
+                              const size_t               object_size,
+                              const size_t               chunk_objects ) {
+    assert( pool != NULL );
+    assert( object_size > 0 && chunk_objects > 0 );
+    size_t size = object_size < sizeof( void * ) ? sizeof( void * )
+                                                 : object_size;
+    pool->object_size   = ALIGN_UP( size, ALIGNMENT );
+    pool->chunk_objects = chunk_objects;
+    pool->free_list     = NULL;
+    pool->chunks        = NULL;
+    pool->allocator     = ( struct dynamic_array_allocator ){
+            .alloc   = pool_alloc,
+            .realloc = pool_realloc,
+            .free    = pool_free,
+            .context = pool,
+    };
+}
+
+void dynamic_array_pool_destroy( struct dynamic_array_pool *pool ) {
+    assert( pool != NULL );
+    void *chunk = pool->chunks;
+    while ( chunk != NULL ) {
+        void *next;
+        memcpy( &next, chunk, sizeof next );
+        free( chunk );
+        chunk = next;
+    }
+    pool->chunks    = NULL;
+    pool->free_list = NULL;
+}
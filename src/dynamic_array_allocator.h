@@ -0,0 +1,63 @@
+#ifndef DYNAMIC_ARRAY_ALLOCATOR_H
+#define DYNAMIC_ARRAY_ALLOCATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+// Allocation interface used for both array headers and element buffers.
+// Sizes of the previous block are passed back in so allocators that do not
+// track them (arenas, pools) can still realloc and free.
+struct dynamic_array_allocator {
+    void *( *alloc )( void *context, const size_t size );
+    void *( *realloc )( void *context, void *ptr, const size_t old_size,
+                        const size_t new_size );
+    void ( *free )( void *context, void *ptr, const size_t size );
+    void *context;
+};
+
+// malloc/realloc/free, used whenever NULL is passed as an allocator
+extern const struct dynamic_array_allocator dynamic_array_heap_allocator;
+
+// Bump allocator: allocations are carved out of large blocks and released
+// together by dynamic_array_arena_reset. Growing or freeing the most recent
+// allocation happens in place, so a single growing array stays contiguous.
+struct dynamic_array_arena_block;
+
+struct dynamic_array_arena {
+    struct dynamic_array_arena_block *head;
+    size_t                            block_size;
+    void                             *last;
+    struct dynamic_array_allocator    allocator;
+};
+
+extern void dynamic_array_arena_init( struct dynamic_array_arena *arena,
+                                      const size_t                block_size );
+extern void dynamic_array_arena_reset( struct dynamic_array_arena *arena );
+extern void dynamic_array_arena_destroy( struct dynamic_array_arena *arena );
+extern size_t
+dynamic_array_arena_used( const struct dynamic_array_arena *arena );
+
+// Fixed-size object pool with a free list, sized for array headers
+// (e.g. sizeof(struct dynamic_array)). Objects come from chunks that are only
+// returned to the heap by dynamic_array_pool_destroy.
+struct dynamic_array_pool {
+    size_t                         object_size;
+    size_t                         chunk_objects;
+    void                          *free_list;
+    void                          *chunks;
+    struct dynamic_array_allocator allocator;
+};
+
+extern void dynamic_array_pool_init( struct dynamic_array_pool *pool,
+                                     const size_t               object_size,
+                                     const size_t               chunk_objects );
+extern void dynamic_array_pool_destroy( struct dynamic_array_pool *pool );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_ALLOCATOR_H
@@ -0,0 +1,57 @@
+#ifndef DYNAMIC_ARRAY_COMMON_H
+#define DYNAMIC_ARRAY_COMMON_H
+
+// Definitions shared by the array and ring templates.
+
+#include "dynamic_array_allocator.h"
+#include "dynamic_array_index.h"
+#include "dynamic_array_stats.h"
+#include "dynamic_array_storage.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DYNAMIC_ARRAY_DEFAULT_CAPACITY 8
+
+#define DYNAMIC_ARRAY_CONCAT_( a, b ) a##b
+#define DYNAMIC_ARRAY_CONCAT( a, b )  DYNAMIC_ARRAY_CONCAT_( a, b )
+
+// the inline fast paths branch to an out-of-line slow path, kept away from
+// the hot code
+#define DYNAMIC_ARRAY_UNLIKELY( x ) __builtin_expect( !!( x ), 0 )
+#define DYNAMIC_ARRAY_COLD          __attribute__( ( cold, noinline ) )
+
+// Results of the _checked functions, which test their preconditions at
+// runtime instead of asserting them, so they hold in release builds too.
+enum dynamic_array_status {
+    DYNAMIC_ARRAY_OK,
+    DYNAMIC_ARRAY_ERROR_NULL,      // a NULL array or output pointer
+    DYNAMIC_ARRAY_ERROR_BOUNDS,    // index past the size
+    DYNAMIC_ARRAY_ERROR_EMPTY,     // pop, front or back of an empty array
+    DYNAMIC_ARRAY_ERROR_READ_ONLY, // a write to a read-only file
+    DYNAMIC_ARRAY_ERROR_NO_MEMORY, // the buffer could not grow or be copied
+};
+
+// https://en.wikipedia.org/wiki/Euclidean_division
+// a = bq + r and 0 <= r < |b|
+// euclidean modulo == euclidean division
+// In C/C++, a % b always returns results with the sign of a
+// Mathematically, modulo is always non-negative
+// % -> remainder operator in C
+// % -> already behaves like Euclidean modulo for unsigned integers
+// returns between [0,n-1], (same behavior of the modulo operator in python)
+// the divisor is the array size, so the result is taken in size_t to stay
+// correct for arrays larger than INT_MAX
+static inline size_t dynamic_array_euclidean_division( const int    a,
+                                                       const size_t b ) {
+    if ( b == 0 ) { // b == 0 is Undefined Behavior/Division by zero error
+        return 0;
+    }
+    if ( a >= 0 ) { return (size_t)a % b; }
+    // -(a + 1) cannot overflow for INT_MIN, so |a| = -(a + 1) + 1
+    size_t r = ( (size_t)( -( a + 1 ) ) + 1 ) % b;
+    return r == 0 ? 0 : b - r;
+}
+
+#endif // DYNAMIC_ARRAY_COMMON_H
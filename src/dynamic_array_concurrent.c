@@ -0,0 +1,231 @@
+#include "dynamic_array_concurrent.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+// segment k holds SEGMENT_BASE << k slots; 61 segments cover every size_t
+// index once SEGMENT_BASE is folded into it
+#define SEGMENT_SHIFT 3
+#define SEGMENT_BASE  ( (size_t)1 << SEGMENT_SHIFT )
+#define SEGMENT_COUNT ( 64 - SEGMENT_SHIFT )
+
+// A segment is one allocation: its slots, then one ready flag per slot that
+// the producer sets once the slot is written.
+struct dynamic_array_concurrent {
+    _Atomic( int * )                      segments[SEGMENT_COUNT];
+    atomic_size_t                         reserved; // slots handed out
+    // a prefix of ready slots already found by size(); only ever grows
+    atomic_size_t                         published;
+    const struct dynamic_array_allocator *allocator;
+};
+
+static inline size_t segment_of( const size_t index ) {
+    return (size_t)( 63 - __builtin_clzll( index + SEGMENT_BASE ) ) -
+           SEGMENT_SHIFT;
+}
+
+static inline size_t segment_capacity( const size_t segment ) {
+    return SEGMENT_BASE << segment;
+}
+
+// index of the first slot of a segment
+static inline size_t segment_start( const size_t segment ) {
+    return segment_capacity( segment ) - SEGMENT_BASE;
+}
+
+static inline size_t segment_bytes( const size_t segment ) {
+    return ( sizeof( int ) + sizeof( atomic_uchar ) ) *
+           segment_capacity( segment );
+}
+
+static inline atomic_uchar *ready_flags( int *segment, const size_t k ) {
+    return (atomic_uchar *)( segment + segment_capacity( k ) );
+}
+
+struct dynamic_array_concurrent *dynamic_array_concurrent_create( void ) {
+    return dynamic_array_concurrent_create_with( NULL );
+}
+
+struct dynamic_array_concurrent *dynamic_array_concurrent_create_with(
+    const struct dynamic_array_allocator *allocator ) {
+    struct dynamic_array_concurrent *c = dynamic_array_heap_allocator.alloc(
+        dynamic_array_heap_allocator.context, sizeof *c );
+    assert( c != NULL );
+    for ( size_t k = 0; k < SEGMENT_COUNT; k++ ) {
+        atomic_init( &c->segments[k], NULL );
+    }
+    atomic_init( &c->reserved, 0 );
+    atomic_init( &c->published, 0 );
+    c->allocator = allocator ? allocator : &dynamic_array_heap_allocator;
+    return c;
+}
+
+void dynamic_array_concurrent_destroy( struct dynamic_array_concurrent *c ) {
+    if ( c == NULL ) { return; }
+    for ( size_t k = 0; k < SEGMENT_COUNT; k++ ) {
+        int *segment =
+            atomic_load_explicit( &c->segments[k], memory_order_relaxed );
+        if ( segment == NULL ) { continue; }
+        c->allocator->free( c->allocator->context, segment,
+                            segment_bytes( k ) );
+    }
+    dynamic_array_heap_allocator.free( dynamic_array_heap_allocator.context,
+                                       c, sizeof *c );
+}
+
+// The first producer to reach a segment allocates it; racing producers
+// lose the CAS and free their copy.
+static int *segment_get( struct dynamic_array_concurrent *c, const size_t k ) {
+    int *segment =
+        atomic_load_explicit( &c->segments[k], memory_order_acquire );
+    if ( segment != NULL ) { return segment; }
+
+    const size_t bytes = segment_bytes( k );
+    int *fresh = c->allocator->alloc( c->allocator->context, bytes );
+    assert( fresh != NULL );
+    atomic_uchar *ready = ready_flags( fresh, k );
+    for ( size_t i = 0; i < segment_capacity( k ); i++ ) {
+        atomic_init( &ready[i], 0 );
+    }
+    if ( atomic_compare_exchange_strong_explicit(
+             &c->segments[k], &segment, fresh, memory_order_acq_rel,
+             memory_order_acquire ) ) {
+        return fresh;
+    }
+    c->allocator->free( c->allocator->context, fresh, bytes );
+    return segment;
+}
+
+// Each slot is published on its own, so a producer never waits for another.
+// One stalled between reserving and writing holds back size() at its first
+// slot, but no other producer.
+static void publish( int *segment, const size_t k, const size_t offset,
+                     const size_t n ) {
+    atomic_uchar *ready = ready_flags( segment, k );
+    for ( size_t i = offset; i < offset + n; i++ ) {
+        atomic_store_explicit( &ready[i], 1, memory_order_release );
+    }
+}
+
+// time: O(1), wait-free apart from the allocation of a new segment
+size_t dynamic_array_concurrent_push( struct dynamic_array_concurrent *c,
+                                      const int                        value ) {
+    assert( c != NULL );
+    size_t index =
+        atomic_fetch_add_explicit( &c->reserved, 1, memory_order_relaxed );
+    assert( index < SIZE_MAX - SEGMENT_BASE );
+    size_t k       = segment_of( index );
+    size_t offset  = index - segment_start( k );
+    int   *segment = segment_get( c, k );
+
+    segment[offset] = value;
+    publish( segment, k, offset, 1 );
+    return index;
+}
+
+// time: O(N); the n slots are contiguous in index order
+size_t dynamic_array_concurrent_push_n( struct dynamic_array_concurrent *c,
+                                        const int *values, const size_t n ) {
+    assert( c != NULL );
+    assert( values != NULL || n == 0 );
+    size_t first =
+        atomic_fetch_add_explicit( &c->reserved, n, memory_order_relaxed );
+    assert( first < SIZE_MAX - SEGMENT_BASE - n );
+    for ( size_t done = 0; done < n; ) {
+        size_t index  = first + done;
+        size_t k      = segment_of( index );
+        size_t offset = index - segment_start( k );
+        size_t chunk  = segment_capacity( k ) - offset;
+        if ( chunk > n - done ) { chunk = n - done; }
+        int *segment = segment_get( c, k );
+        memcpy( segment + offset, values + done, sizeof *values * chunk );
+        publish( segment, k, offset, chunk );
+        done += chunk;
+    }
+    return first;
+}
+
+static bool is_ready( const struct dynamic_array_concurrent *c,
+                      const size_t                           index ) {
+    const size_t k = segment_of( index );
+    int *segment =
+        atomic_load_explicit( &c->segments[k], memory_order_acquire );
+    return segment != NULL &&
+           atomic_load_explicit(
+               &ready_flags( segment, k )[index - segment_start( k )],
+               memory_order_acquire );
+}
+
+// time: O(1) amortized: the scan starts from the prefix found by the last
+// call and stops at the first slot still being written
+size_t
+dynamic_array_concurrent_size( const struct dynamic_array_concurrent *c ) {
+    assert( c != NULL );
+    // `published` is atomic, so advancing it from readers is race-free
+    atomic_size_t *published = (atomic_size_t *)&c->published;
+    const size_t   reserved =
+        atomic_load_explicit( &c->reserved, memory_order_relaxed );
+    size_t ready = atomic_load_explicit( published, memory_order_acquire );
+    while ( ready < reserved && is_ready( c, ready ) ) { ready++; }
+    // a racing reader may have got further; the larger prefix stays
+    size_t seen = atomic_load_explicit( published, memory_order_relaxed );
+    while ( seen < ready ) {
+        if ( atomic_compare_exchange_weak_explicit( published, &seen, ready,
+                                                    memory_order_release,
+                                                    memory_order_relaxed ) ) {
+            break;
+        }
+    }
+    return ready;
+}
+
+// time: O(1)
+int dynamic_array_concurrent_get( const struct dynamic_array_concurrent *c,
+                                  const size_t index ) {
+    assert( c != NULL );
+    // the acquire load also orders the read of the value after its write
+    const bool ready = is_ready( c, index );
+    assert( ready );
+    (void)ready;
+    size_t k = segment_of( index );
+    int   *segment =
+        atomic_load_explicit( &c->segments[k], memory_order_relaxed );
+    return segment[index - segment_start( k )];
+}
+
+// time: O(N), one bulk copy per segment
+size_t
+dynamic_array_concurrent_collect( const struct dynamic_array_concurrent *c,
+                                  struct dynamic_array                  *da ) {
+    assert( c != NULL );
+    assert( da != NULL );
+    const size_t size = dynamic_array_concurrent_size( c );
+    for ( size_t k = 0; segment_start( k ) < size; k++ ) {
+        const int *segment =
+            atomic_load_explicit( &c->segments[k], memory_order_acquire );
+        size_t chunk = size - segment_start( k );
+        if ( chunk > segment_capacity( k ) ) { chunk = segment_capacity( k ); }
+        dynamic_array_push_n( da, segment, chunk );
+    }
+    return size;
+}
+
+// time: O(N), the ready flags of the used slots are reset
+void dynamic_array_concurrent_clear( struct dynamic_array_concurrent *c ) {
+    assert( c != NULL );
+    const size_t used =
+        atomic_load_explicit( &c->reserved, memory_order_relaxed );
+    for ( size_t k = 0; k < SEGMENT_COUNT && segment_start( k ) < used; k++ ) {
+        int *segment =
+            atomic_load_explicit( &c->segments[k], memory_order_relaxed );
+        if ( segment == NULL ) { continue; }
+        atomic_uchar *ready = ready_flags( segment, k );
+        for ( size_t i = 0; i < segment_capacity( k ); i++ ) {
+            atomic_store_explicit( &ready[i], 0, memory_order_relaxed );
+        }
+    }
+    atomic_store_explicit( &c->reserved, 0, memory_order_relaxed );
+    atomic_store_explicit( &c->published, 0, memory_order_relaxed );
+}
@@ -0,0 +1,54 @@
+#ifndef DYNAMIC_ARRAY_CONCURRENT_H
+#define DYNAMIC_ARRAY_CONCURRENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dynamic_array.h"
+
+#include <stddef.h>
+
+// Multi-producer append-only int array. Elements live in segments of
+// 8, 16, 32, ... slots that are allocated on first use and never moved, so
+// pushes reserve slots with one atomic fetch_add and never wait for a
+// reallocation or for each other. Every slot has a ready flag the producer
+// sets once it is written: size() counts the prefix of ready slots, and
+// get() on any index below it, or returned by a push that has finished, is
+// safe while other threads keep pushing.
+struct dynamic_array_concurrent;
+
+extern struct dynamic_array_concurrent *dynamic_array_concurrent_create( void );
+// the allocator is called from pushing threads and must be thread-safe
+extern struct dynamic_array_concurrent *dynamic_array_concurrent_create_with(
+    const struct dynamic_array_allocator *allocator );
+extern void
+dynamic_array_concurrent_destroy( struct dynamic_array_concurrent *c );
+
+// thread-safe; return the index of the (first) element
+extern size_t dynamic_array_concurrent_push( struct dynamic_array_concurrent *c,
+                                             const int value );
+extern size_t
+dynamic_array_concurrent_push_n( struct dynamic_array_concurrent *c,
+                                 const int *values, const size_t n );
+
+// thread-safe
+extern size_t
+dynamic_array_concurrent_size( const struct dynamic_array_concurrent *c );
+extern int
+dynamic_array_concurrent_get( const struct dynamic_array_concurrent *c,
+                              const size_t                           index );
+// appends the published elements to a regular array, returns how many
+extern size_t
+dynamic_array_concurrent_collect( const struct dynamic_array_concurrent *c,
+                                  struct dynamic_array                  *da );
+
+// not thread-safe: keeps the segments for reuse; time: O(N)
+extern void
+dynamic_array_concurrent_clear( struct dynamic_array_concurrent *c );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_CONCURRENT_H
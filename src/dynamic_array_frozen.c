@@ -0,0 +1,266 @@
+#include "dynamic_array_frozen.h"
+
+#include "dynamic_array_simd.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#define BLOCK_SIZE 128
+
+struct block {
+    size_t  offset; // first word in `packed`
+    int     min;    // the reference value of both encodings
+    int     max;
+    uint8_t bits;
+    bool    delta;
+};
+
+struct dynamic_array_frozen {
+    size_t                                size;
+    size_t                                blocks;
+    size_t                                words;
+    bool                                  sorted; // ascending elements
+    struct block                         *block;
+    uint32_t                             *packed;
+    const struct dynamic_array_allocator *allocator;
+};
+
+static inline unsigned bit_width( const uint32_t x ) {
+    return x ? 32 - (unsigned)__builtin_clz( x ) : 0;
+}
+
+static inline size_t block_count( const struct dynamic_array_frozen *f,
+                                  const size_t                       b ) {
+    const size_t first = b * BLOCK_SIZE;
+    return f->size - first < BLOCK_SIZE ? f->size - first : BLOCK_SIZE;
+}
+
+// a short last block is padded with copies of its last element, which moves
+// neither its range nor (for ascending data) its deltas
+static void load_block( const int *data, const size_t n,
+                        int values[BLOCK_SIZE] ) {
+    memcpy( values, data, sizeof *values * n );
+    for ( size_t i = n; i < BLOCK_SIZE; i++ ) { values[i] = data[n - 1]; }
+}
+
+// frame of reference needs the width of max - min; delta the width of the
+// largest difference along a lane, which is small for ascending data even
+// when its range is not
+static struct block plan_block( const int values[BLOCK_SIZE] ) {
+    int min = INT_MAX;
+    int max = INT_MIN;
+    for ( size_t i = 0; i < BLOCK_SIZE; i++ ) {
+        min = values[i] < min ? values[i] : min;
+        max = values[i] > max ? values[i] : max;
+    }
+    uint32_t differences = 0;
+    for ( size_t i = 0; i < BLOCK_SIZE; i++ ) {
+        const int before = i < 4 ? min : values[i - 4];
+        differences |= (uint32_t)values[i] - (uint32_t)before;
+    }
+    const unsigned reference = bit_width( (uint32_t)max - (uint32_t)min );
+    const unsigned delta     = bit_width( differences );
+    return ( struct block ){
+        .min   = min,
+        .max   = max,
+        .bits  = (uint8_t)( delta < reference ? delta : reference ),
+        .delta = delta < reference,
+    };
+}
+
+static void decode_block( const struct dynamic_array_frozen *f,
+                          const size_t b, int out[BLOCK_SIZE] ) {
+    const struct block *block = &f->block[b];
+    dynamic_array_simd_unpack128( f->packed + block->offset, block->bits,
+                                  block->min, block->delta, out );
+}
+
+// ============================================================================
+// Freezing
+// ============================================================================
+
+void dynamic_array_frozen_destroy( struct dynamic_array_frozen *f ) {
+    if ( f == NULL ) { return; }
+    const struct dynamic_array_allocator *allocator = f->allocator;
+    if ( f->packed != NULL ) {
+        allocator->free( allocator->context, f->packed,
+                         sizeof *f->packed * f->words );
+    }
+    if ( f->block != NULL ) {
+        allocator->free( allocator->context, f->block,
+                         sizeof *f->block * f->blocks );
+    }
+    allocator->free( allocator->context, f, sizeof *f );
+}
+
+// time: O(N), two passes: the first sizes every block, the second packs them
+// into one allocation
+struct dynamic_array_frozen *
+dynamic_array_freeze( const struct dynamic_array *da ) {
+    assert( da != NULL );
+    const struct dynamic_array_allocator *allocator = da->allocator;
+    struct dynamic_array_frozen          *f =
+        allocator->alloc( allocator->context, sizeof *f );
+    if ( f == NULL ) { return NULL; }
+    *f = ( struct dynamic_array_frozen ){
+        .size      = da->size,
+        .blocks    = ( da->size + BLOCK_SIZE - 1 ) / BLOCK_SIZE,
+        .sorted    = true,
+        .allocator = allocator,
+    };
+    if ( f->blocks == 0 ) { return f; }
+
+    f->block =
+        allocator->alloc( allocator->context, sizeof *f->block * f->blocks );
+    if ( f->block == NULL ) {
+        dynamic_array_frozen_destroy( f );
+        return NULL;
+    }
+    int values[BLOCK_SIZE];
+    for ( size_t b = 0; b < f->blocks; b++ ) {
+        const int *data = da->buffer + b * BLOCK_SIZE;
+        load_block( data, block_count( f, b ), values );
+        f->block[b]        = plan_block( values );
+        f->block[b].offset = f->words;
+        f->words += (size_t)4 * f->block[b].bits;
+    }
+    for ( size_t i = 1; i < da->size && f->sorted; i++ ) {
+        f->sorted = da->buffer[i - 1] <= da->buffer[i];
+    }
+
+    if ( f->words > 0 ) {
+        f->packed = allocator->alloc( allocator->context,
+                                      sizeof *f->packed * f->words );
+        if ( f->packed == NULL ) {
+            dynamic_array_frozen_destroy( f );
+            return NULL;
+        }
+    }
+    for ( size_t b = 0; b < f->blocks; b++ ) {
+        const struct block *block = &f->block[b];
+        load_block( da->buffer + b * BLOCK_SIZE, block_count( f, b ), values );
+        dynamic_array_simd_pack128( values, block->bits, block->min,
+                                    block->delta, f->packed + block->offset );
+    }
+    return f;
+}
+
+size_t dynamic_array_frozen_size( const struct dynamic_array_frozen *f ) {
+    assert( f != NULL );
+    return f->size;
+}
+
+size_t dynamic_array_frozen_memory( const struct dynamic_array_frozen *f ) {
+    assert( f != NULL );
+    return sizeof *f + sizeof *f->block * f->blocks +
+           sizeof *f->packed * f->words;
+}
+
+// ============================================================================
+// Access
+// ============================================================================
+
+int dynamic_array_frozen_get( const struct dynamic_array_frozen *f,
+                              const size_t                       index ) {
+    assert( f != NULL );
+    assert( index < f->size );
+    const struct block *block = &f->block[index / BLOCK_SIZE];
+    const unsigned      i     = (unsigned)( index % BLOCK_SIZE );
+    if ( block->bits == 0 ) { return block->min; }
+    const uint32_t *lane  = f->packed + block->offset + i % 4;
+    uint32_t        value = (uint32_t)block->min;
+    if ( !block->delta ) {
+        return (int)( value +
+                      dynamic_array_simd_extract( lane, block->bits, i / 4 ) );
+    }
+    for ( unsigned row = 0; row <= i / 4; row++ ) {
+        value += dynamic_array_simd_extract( lane, block->bits, row );
+    }
+    return (int)value;
+}
+
+// the first block whose maximum reaches value; on sorted data every earlier
+// block lies below it
+static size_t first_candidate( const struct dynamic_array_frozen *f,
+                               const int                          value ) {
+    size_t lo = 0;
+    size_t hi = f->blocks;
+    while ( lo < hi ) {
+        size_t mid = lo + ( hi - lo ) / 2;
+        if ( f->block[mid].max < value ) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// time: O(log B + 128) when sorted, otherwise O(N) worst case but only the
+// blocks whose [min, max] holds the value are decoded
+ptrdiff_t
+dynamic_array_frozen_find( const struct dynamic_array_frozen *f,
+                           const int                          value ) {
+    assert( f != NULL );
+    int    values[BLOCK_SIZE];
+    size_t b = f->sorted ? first_candidate( f, value ) : 0;
+    for ( ; b < f->blocks; b++ ) {
+        const struct block *block = &f->block[b];
+        if ( value < block->min || value > block->max ) {
+            if ( f->sorted ) { break; }
+            continue;
+        }
+        decode_block( f, b, values );
+        const size_t n = block_count( f, b );
+        const size_t i = dynamic_array_simd_find( values, n, value );
+        if ( i < n ) { return (ptrdiff_t)( b * BLOCK_SIZE + i ); }
+        if ( f->sorted ) { break; }
+    }
+    return -1;
+}
+
+// whole blocks are decoded in place; partial ones go through a scratch block
+void dynamic_array_frozen_decode( const struct dynamic_array_frozen *f,
+                                  const size_t first, const size_t n,
+                                  int *out ) {
+    assert( f != NULL );
+    assert( first <= f->size && n <= f->size - first );
+    assert( out != NULL || n == 0 );
+    int    scratch[BLOCK_SIZE];
+    size_t done = 0;
+    while ( done < n ) {
+        const size_t position = first + done;
+        const size_t b        = position / BLOCK_SIZE;
+        const size_t skip     = position % BLOCK_SIZE;
+        size_t       take     = BLOCK_SIZE - skip;
+        take                  = take < n - done ? take : n - done;
+        if ( take == BLOCK_SIZE ) {
+            decode_block( f, b, out + done );
+        } else {
+            decode_block( f, b, scratch );
+            memcpy( out + done, scratch + skip, sizeof *out * take );
+        }
+        done += take;
+    }
+}
+
+// time: O(N), one reserve; an empty array that receives sorted elements is
+// marked sorted
+void dynamic_array_frozen_thaw( const struct dynamic_array_frozen *f,
+                                struct dynamic_array              *da ) {
+    assert( f != NULL );
+    assert( da != NULL );
+    if ( f->size == 0 ) { return; }
+    assert( f->size <= SIZE_MAX / sizeof *da->buffer - da->size );
+    const bool sorted = da->size == 0 && f->sorted;
+    dynamic_array_unshare( da );
+    dynamic_array_reserve( da, da->size + f->size );
+    dynamic_array_frozen_decode( f, 0, f->size, da->buffer + da->size );
+    da->size += f->size;
+    da->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                              DYNAMIC_ARRAY_FLAG_INDEXED );
+    if ( sorted ) { da->flags |= DYNAMIC_ARRAY_FLAG_SORTED; }
+    dynamic_array_index_refresh( da );
+}
@@ -0,0 +1,56 @@
+#ifndef DYNAMIC_ARRAY_FROZEN_H
+#define DYNAMIC_ARRAY_FROZEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dynamic_array.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Compressed read-only copy of an int array. Elements are cut into blocks
+// of 128; each block stores its minimum and maximum and bit-packs its values
+// either relative to the minimum (frame of reference) or as differences
+// along four lanes (delta), whichever needs fewer bits. Sorted ids and
+// small-range counters shrink several times; random 32-bit values do not
+// shrink at all. Blocks are decoded with the SIMD kernels in
+// dynamic_array_simd.h.
+struct dynamic_array_frozen;
+
+// time: O(N); the source is left alone. Memory comes from the array's
+// allocator; returns NULL when it runs out.
+extern struct dynamic_array_frozen *
+dynamic_array_freeze( const struct dynamic_array *da );
+extern void dynamic_array_frozen_destroy( struct dynamic_array_frozen *f );
+
+extern size_t dynamic_array_frozen_size( const struct dynamic_array_frozen *f );
+// bytes held, header and block table included
+extern size_t
+dynamic_array_frozen_memory( const struct dynamic_array_frozen *f );
+
+// time: O(1) for frame-of-reference blocks, O(32) for delta blocks
+extern int dynamic_array_frozen_get( const struct dynamic_array_frozen *f,
+                                     const size_t                       index );
+// First position of value, -1 when absent. Blocks whose range excludes the
+// value are skipped undecoded; a sorted source is searched by binary search
+// over the blocks, so only one block is decoded.
+extern ptrdiff_t
+dynamic_array_frozen_find( const struct dynamic_array_frozen *f,
+                           const int                          value );
+
+// Streaming decode: writes elements [first, first + n) to out, one block
+// at a time.
+extern void dynamic_array_frozen_decode( const struct dynamic_array_frozen *f,
+                                         const size_t first, const size_t n,
+                                         int *out );
+// appends every element to da, reserving once
+extern void dynamic_array_frozen_thaw( const struct dynamic_array_frozen *f,
+                                       struct dynamic_array              *da );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_FROZEN_H
@@ -0,0 +1,286 @@
+#include "dynamic_array_index.h"
+
+#include "dynamic_array.h"
+#include "dynamic_array_simd.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+// the table is kept at most half full, so probe runs stay short
+#define INDEX_MIN_CAPACITY ( (size_t)16 )
+#define EMPTY              SIZE_MAX
+
+struct slot {
+    size_t position; // EMPTY for a free slot
+    int    value;
+};
+
+struct dynamic_array_index {
+    struct slot                          *slots;
+    size_t                                capacity; // power of two
+    size_t                                count;
+    unsigned                              shift;    // 64 - log2(capacity)
+    const struct dynamic_array_allocator *allocator;
+};
+
+// Fibonacci hashing: the top bits of value * 2^64 / phi spread consecutive
+// keys evenly
+static inline size_t home( const struct dynamic_array_index *index,
+                           const int                         value ) {
+    return (size_t)( ( (uint64_t)(uint32_t)value * 0x9E3779B97F4A7C15ull ) >>
+                     index->shift );
+}
+
+// the slot holding value, or the free slot where it belongs
+static size_t probe( const struct dynamic_array_index *index,
+                     const int                         value ) {
+    const size_t mask = index->capacity - 1;
+    for ( size_t i = home( index, value );; i = ( i + 1 ) & mask ) {
+        const struct slot *slot = &index->slots[i];
+        if ( slot->position == EMPTY || slot->value == value ) { return i; }
+    }
+}
+
+static size_t capacity_for( const size_t n ) {
+    size_t capacity = INDEX_MIN_CAPACITY;
+    while ( capacity / 2 < n ) { capacity *= 2; }
+    return capacity;
+}
+
+// swaps in an empty table of `capacity` slots, returning the old one
+static bool allocate_slots( struct dynamic_array_index *index,
+                            const size_t capacity, struct slot **old ) {
+    assert( capacity <= SIZE_MAX / sizeof( struct slot ) );
+    struct slot *slots = index->allocator->alloc( index->allocator->context,
+                                                  sizeof *slots * capacity );
+    if ( slots == NULL ) { return false; }
+    for ( size_t i = 0; i < capacity; i++ ) { slots[i].position = EMPTY; }
+    *old            = index->slots;
+    index->slots    = slots;
+    index->capacity = capacity;
+    index->count    = 0;
+    index->shift    = (unsigned)( 64 - __builtin_ctzll( capacity ) );
+    return true;
+}
+
+static void free_slots( const struct dynamic_array_index *index,
+                        struct slot *slots, const size_t capacity ) {
+    if ( slots == NULL ) { return; }
+    index->allocator->free( index->allocator->context, slots,
+                            sizeof *slots * capacity );
+}
+
+// time: O(capacity)
+static bool grow( struct dynamic_array_index *index ) {
+    struct slot *old          = NULL;
+    const size_t old_capacity = index->capacity;
+    if ( !allocate_slots( index, old_capacity * 2, &old ) ) { return false; }
+    for ( size_t i = 0; i < old_capacity; i++ ) {
+        if ( old[i].position == EMPTY ) { continue; }
+        index->slots[probe( index, old[i].value )] = old[i];
+        index->count++;
+    }
+    free_slots( index, old, old_capacity );
+    return true;
+}
+
+// expected O(1); keeps the smaller position when the value is present
+bool dynamic_array_index_add( struct dynamic_array_index *index,
+                              const int value, const size_t position ) {
+    assert( index != NULL );
+    if ( index->count + 1 > index->capacity / 2 && !grow( index ) ) {
+        return false;
+    }
+    struct slot *slot = &index->slots[probe( index, value )];
+    if ( slot->position == EMPTY ) {
+        *slot = ( struct slot ){ .position = position, .value = value };
+        index->count++;
+    } else if ( position < slot->position ) {
+        slot->position = position;
+    }
+    return true;
+}
+
+// Backward-shift deletion: later entries of the probe run move into the hole
+// unless their home lies between the hole and their slot, so no tombstones
+// are left behind.
+static void erase( struct dynamic_array_index *index, size_t hole ) {
+    const size_t mask = index->capacity - 1;
+    size_t       i    = ( hole + 1 ) & mask;
+    while ( index->slots[i].position != EMPTY ) {
+        size_t distance = ( i - home( index, index->slots[i].value ) ) & mask;
+        if ( distance >= ( ( i - hole ) & mask ) ) {
+            index->slots[hole] = index->slots[i];
+            hole               = i;
+        }
+        i = ( i + 1 ) & mask;
+    }
+    index->slots[hole].position = EMPTY;
+    index->count--;
+}
+
+// the popped element was the value's first occurrence only if the entry
+// points at it; otherwise an earlier copy remains and nothing changes
+void dynamic_array_index_pop( struct dynamic_array_index *index,
+                              const int value, const size_t position ) {
+    assert( index != NULL );
+    size_t i = probe( index, value );
+    if ( index->slots[i].position == position ) { erase( index, i ); }
+}
+
+// moves every stored position from `from` on up or down by one;
+// time: O(capacity)
+static void shift_positions( struct dynamic_array_index *index,
+                             const size_t from, const bool up ) {
+    for ( size_t i = 0; i < index->capacity; i++ ) {
+        struct slot *slot = &index->slots[i];
+        if ( slot->position == EMPTY || slot->position < from ) { continue; }
+        slot->position = up ? slot->position + 1 : slot->position - 1;
+    }
+}
+
+// the elements from position on moved up by one to make room for value
+bool dynamic_array_index_insert( struct dynamic_array_index *index,
+                                 const int value, const size_t position ) {
+    assert( index != NULL );
+    shift_positions( index, position, true );
+    return dynamic_array_index_add( index, value, position );
+}
+
+// The elements after position moved down by one over value. If it was the
+// first occurrence, the next copy, now at position or later, takes over; the
+// erase leaves room, so the add cannot fail.
+void dynamic_array_index_remove( struct dynamic_array_index *index,
+                                 const int *data, const size_t n,
+                                 const int value, const size_t position ) {
+    assert( index != NULL );
+    assert( data != NULL || n == 0 );
+    const size_t i     = probe( index, value );
+    const bool   first = index->slots[i].position == position;
+    if ( first ) { erase( index, i ); }
+    shift_positions( index, position + 1, false );
+    if ( !first ) { return; }
+    const size_t next =
+        position + dynamic_array_simd_find( data + position, n - position,
+                                            value );
+    if ( next < n ) { (void)dynamic_array_index_add( index, value, next ); }
+}
+
+// the elements at position and position + 1 traded places; a first
+// occurrence can only move next to itself, so each entry moves with its value
+void dynamic_array_index_swap( struct dynamic_array_index *index,
+                               const int *data, const size_t position ) {
+    assert( index != NULL );
+    assert( data != NULL );
+    const int left  = data[position];
+    const int right = data[position + 1];
+    if ( left == right ) { return; }
+    struct slot *moved_left  = &index->slots[probe( index, left )];
+    struct slot *moved_right = &index->slots[probe( index, right )];
+    if ( moved_left->position == position + 1 ) { moved_left->position--; }
+    if ( moved_right->position == position ) { moved_right->position++; }
+}
+
+// time: O(capacity); an empty table matches an empty array
+void dynamic_array_index_clear( struct dynamic_array_index *index ) {
+    assert( index != NULL );
+    for ( size_t i = 0; i < index->capacity; i++ ) {
+        index->slots[i].position = EMPTY;
+    }
+    index->count = 0;
+}
+
+// Overwriting the first occurrence of old_value would need a scan for the
+// next one, so that case reports the index stale.
+bool dynamic_array_index_replace( struct dynamic_array_index *index,
+                                  const int old_value, const int value,
+                                  const size_t position ) {
+    assert( index != NULL );
+    if ( old_value == value ) { return true; }
+    if ( index->slots[probe( index, old_value )].position == position ) {
+        return false;
+    }
+    return dynamic_array_index_add( index, value, position );
+}
+
+// time: O(N); the table is resized to the element count, so it also shrinks
+// after the array does
+bool dynamic_array_index_rebuild( struct dynamic_array_index *index,
+                                  const int *data, const size_t n ) {
+    assert( index != NULL );
+    assert( data != NULL || n == 0 );
+    const size_t capacity = capacity_for( n );
+    if ( capacity != index->capacity ) {
+        struct slot *old          = NULL;
+        const size_t old_capacity = index->capacity;
+        if ( !allocate_slots( index, capacity, &old ) ) { return false; }
+        free_slots( index, old, old_capacity );
+    } else {
+        dynamic_array_index_clear( index );
+    }
+    // ascending positions: the first occurrence claims the slot
+    for ( size_t i = 0; i < n; i++ ) {
+        struct slot *slot = &index->slots[probe( index, data[i] )];
+        if ( slot->position != EMPTY ) { continue; }
+        *slot = ( struct slot ){ .position = i, .value = data[i] };
+        index->count++;
+    }
+    return true;
+}
+
+// expected O(1)
+size_t dynamic_array_index_lookup( const struct dynamic_array_index *index,
+                                   const int value, const size_t n ) {
+    assert( index != NULL );
+    const struct slot *slot = &index->slots[probe( index, value )];
+    return slot->position == EMPTY ? n : slot->position;
+}
+
+void dynamic_array_index_destroy( struct dynamic_array_index *index ) {
+    if ( index == NULL ) { return; }
+    free_slots( index, index->slots, index->capacity );
+    index->allocator->free( index->allocator->context, index, sizeof *index );
+}
+
+// time: O(N)
+bool dynamic_array_index_enable( struct dynamic_array *da ) {
+    assert( da != NULL );
+    if ( da->index == NULL ) {
+        struct dynamic_array_index *index =
+            da->allocator->alloc( da->allocator->context, sizeof *index );
+        if ( index == NULL ) { return false; }
+        *index = ( struct dynamic_array_index ){ .allocator = da->allocator };
+        da->index = index;
+    }
+    if ( !dynamic_array_index_rebuild( da->index, da->buffer, da->size ) ) {
+        dynamic_array_index_disable( da );
+        return false;
+    }
+    da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED;
+    return true;
+}
+
+// time: O(N) when stale, O(1) otherwise
+bool dynamic_array_index_refresh( struct dynamic_array *da ) {
+    assert( da != NULL );
+    if ( da->index == NULL ) { return false; }
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) { return true; }
+    if ( !dynamic_array_index_rebuild( da->index, da->buffer, da->size ) ) {
+        return false;
+    }
+    da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED;
+    return true;
+}
+
+void dynamic_array_index_disable( struct dynamic_array *da ) {
+    assert( da != NULL );
+    dynamic_array_index_destroy( da->index );
+    da->index = NULL;
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+}
+
+size_t dynamic_array_index_memory( const struct dynamic_array *da ) {
+    assert( da != NULL );
+    if ( da->index == NULL ) { return 0; }
+    return sizeof *da->index + sizeof *da->index->slots * da->index->capacity;
+}
@@ -0,0 +1,67 @@
+#ifndef DYNAMIC_ARRAY_INDEX_H
+#define DYNAMIC_ARRAY_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Opt-in hash index for the int array: an open-addressing table from each
+// value to the position of its first occurrence, so dynamic_array_find is
+// expected O(1) on unsorted arrays. push, pop, set, insert and remove update
+// it in place; bulk changes rebuild it in one O(N) pass before returning.
+// Writes that bypass the array, the _unchecked setters and stores through a
+// view, and a rebuild without memory leave it stale
+// (DYNAMIC_ARRAY_FLAG_INDEXED cleared): find then ignores the table until
+// dynamic_array_index_refresh. find never writes, so an indexed array can be
+// searched from several threads.
+struct dynamic_array;
+struct dynamic_array_index;
+
+// builds the index from the current elements, using the array's allocator;
+// returns false when the table cannot be allocated
+extern bool dynamic_array_index_enable( struct dynamic_array *da );
+// rebuilds a stale index; false without an index or when the table cannot
+// grow, in which case it stays stale
+extern bool dynamic_array_index_refresh( struct dynamic_array *da );
+extern void dynamic_array_index_disable( struct dynamic_array *da );
+// bytes held by the index, 0 without one
+extern size_t dynamic_array_index_memory( const struct dynamic_array *da );
+
+// used by the template and the int search; the updates return false when
+// the index could not follow the change and must be rebuilt
+extern bool   dynamic_array_index_add( struct dynamic_array_index *index,
+                                       const int value, const size_t position );
+extern void   dynamic_array_index_pop( struct dynamic_array_index *index,
+                                       const int value, const size_t position );
+extern bool   dynamic_array_index_replace( struct dynamic_array_index *index,
+                                           const int old_value, const int value,
+                                           const size_t position );
+extern bool   dynamic_array_index_insert( struct dynamic_array_index *index,
+                                          const int value,
+                                          const size_t position );
+// data holds the n elements left after the removal
+extern void   dynamic_array_index_remove( struct dynamic_array_index *index,
+                                          const int *data, const size_t n,
+                                          const int value,
+                                          const size_t position );
+// after data[position] and data[position + 1] were swapped
+extern void   dynamic_array_index_swap( struct dynamic_array_index *index,
+                                        const int   *data,
+                                        const size_t position );
+extern void   dynamic_array_index_clear( struct dynamic_array_index *index );
+extern bool   dynamic_array_index_rebuild( struct dynamic_array_index *index,
+                                           const int *data, const size_t n );
+// first position of value, `n` when absent
+extern size_t
+dynamic_array_index_lookup( const struct dynamic_array_index *index,
+                            const int value, const size_t n );
+extern void   dynamic_array_index_destroy( struct dynamic_array_index *index );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_INDEX_H
@@ -0,0 +1,490 @@
+// sysconf and pthreads are POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "dynamic_array_parallel.h"
+
+#include "dynamic_array_simd.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// ============================================================================
+// Worker pool
+// ============================================================================
+
+struct dynamic_array_workers {
+    pthread_t      *threads;
+    size_t          count; // started threads, the caller is not included
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+
+    // current job, published under `lock` by bumping `generation`
+    void ( *task )( void *context, const size_t index );
+    void         *context;
+    size_t        tasks;
+    atomic_size_t next;
+    size_t        finished;
+    unsigned long generation;
+    bool          stop;
+};
+
+static void drain( struct dynamic_array_workers *w ) {
+    for ( ;; ) {
+        size_t index =
+            atomic_fetch_add_explicit( &w->next, 1, memory_order_relaxed );
+        if ( index >= w->tasks ) { return; }
+        w->task( w->context, index );
+    }
+}
+
+static void *worker_main( void *argument ) {
+    struct dynamic_array_workers *w    = argument;
+    unsigned long                 seen = 0;
+    pthread_mutex_lock( &w->lock );
+    for ( ;; ) {
+        while ( !w->stop && w->generation == seen ) {
+            pthread_cond_wait( &w->wake, &w->lock );
+        }
+        if ( w->stop ) { break; }
+        seen = w->generation;
+        pthread_mutex_unlock( &w->lock );
+
+        drain( w );
+
+        pthread_mutex_lock( &w->lock );
+        if ( ++w->finished == w->count ) { pthread_cond_signal( &w->done ); }
+    }
+    pthread_mutex_unlock( &w->lock );
+    return NULL;
+}
+
+struct dynamic_array_workers *
+dynamic_array_workers_create( const size_t threads ) {
+    size_t total = threads;
+    if ( total == 0 ) {
+        long online = sysconf( _SC_NPROCESSORS_ONLN );
+        total       = online > 0 ? (size_t)online : 1;
+    }
+
+    struct dynamic_array_workers *w = calloc( 1, sizeof *w );
+    assert( w != NULL );
+    w->count   = total - 1;
+    w->threads = w->count ? malloc( sizeof *w->threads * w->count ) : NULL;
+    assert( w->threads != NULL || w->count == 0 );
+    pthread_mutex_init( &w->lock, NULL );
+    pthread_cond_init( &w->wake, NULL );
+    pthread_cond_init( &w->done, NULL );
+    atomic_init( &w->next, 0 );
+
+    for ( size_t i = 0; i < w->count; i++ ) {
+        int error = pthread_create( &w->threads[i], NULL, worker_main, w );
+        assert( error == 0 );
+        (void)error;
+    }
+    return w;
+}
+
+void dynamic_array_workers_destroy( struct dynamic_array_workers *w ) {
+    if ( w == NULL ) { return; }
+    pthread_mutex_lock( &w->lock );
+    w->stop = true;
+    pthread_cond_broadcast( &w->wake );
+    pthread_mutex_unlock( &w->lock );
+    for ( size_t i = 0; i < w->count; i++ ) {
+        pthread_join( w->threads[i], NULL );
+    }
+    pthread_cond_destroy( &w->done );
+    pthread_cond_destroy( &w->wake );
+    pthread_mutex_destroy( &w->lock );
+    free( w->threads );
+    free( w );
+}
+
+size_t dynamic_array_workers_threads( const struct dynamic_array_workers *w ) {
+    return w ? w->count + 1 : 1;
+}
+
+void dynamic_array_workers_run( struct dynamic_array_workers *w,
+                                const size_t                  tasks,
+                                void ( *task )( void        *context,
+                                                const size_t index ),
+                                void *context ) {
+    assert( w != NULL );
+    assert( task != NULL );
+    pthread_mutex_lock( &w->lock );
+    w->task     = task;
+    w->context  = context;
+    w->tasks    = tasks;
+    w->finished = 0;
+    atomic_store_explicit( &w->next, 0, memory_order_relaxed );
+    w->generation++;
+    pthread_cond_broadcast( &w->wake );
+    pthread_mutex_unlock( &w->lock );
+
+    drain( w );
+
+    // every worker checks in, so the job's context may go out of scope
+    pthread_mutex_lock( &w->lock );
+    while ( w->finished < w->count ) {
+        pthread_cond_wait( &w->done, &w->lock );
+    }
+    pthread_mutex_unlock( &w->lock );
+}
+
+// ============================================================================
+// Chunking
+// ============================================================================
+
+// several chunks per thread so uneven chunks (early exits, page faults)
+// balance out
+#define CHUNKS_PER_THREAD 4
+
+static bool serial( const struct dynamic_array_workers *w, const size_t n,
+                    const size_t threshold ) {
+    return w == NULL || w->count == 0 || n < threshold;
+}
+
+static size_t chunk_count( const struct dynamic_array_workers *w,
+                           const size_t                        n ) {
+    size_t chunks = ( w->count + 1 ) * CHUNKS_PER_THREAD;
+    return chunks < n ? chunks : n;
+}
+
+// [first, last) of chunk `index` out of `chunks` over n elements
+static void chunk_range( const size_t n, const size_t chunks,
+                         const size_t index, size_t *first, size_t *last ) {
+    *first = n / chunks * index + ( index < n % chunks ? index : n % chunks );
+    *last  = *first + n / chunks + ( index < n % chunks ? 1 : 0 );
+}
+
+// ============================================================================
+// Fill and transform
+// ============================================================================
+
+struct fill_job {
+    int   *data;
+    size_t n;
+    size_t chunks;
+    int    value;
+};
+
+static void fill_task( void *context, const size_t index ) {
+    struct fill_job *job = context;
+    size_t           first, last;
+    chunk_range( job->n, job->chunks, index, &first, &last );
+    for ( size_t i = first; i < last; i++ ) { job->data[i] = job->value; }
+}
+
+void dynamic_array_parallel_fill( struct dynamic_array_workers *w,
+                                  struct dynamic_array         *da,
+                                  const int value, const size_t threshold ) {
+    assert( da != NULL );
+    if ( serial( w, da->size, threshold ) ) {
+        dynamic_array_fill( da, value );
+        return;
+    }
+    dynamic_array_unshare( da );
+    struct fill_job job = {
+        .data   = da->buffer,
+        .n      = da->size,
+        .chunks = chunk_count( w, da->size ),
+        .value  = value,
+    };
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+    dynamic_array_workers_run( w, job.chunks, fill_task, &job );
+    dynamic_array_index_refresh( da );
+}
+
+struct transform_job {
+    int   *data;
+    size_t n;
+    size_t chunks;
+    int ( *function )( const int value, void *context );
+    void *context;
+};
+
+static void transform_task( void *context, const size_t index ) {
+    struct transform_job *job = context;
+    size_t                first, last;
+    chunk_range( job->n, job->chunks, index, &first, &last );
+    for ( size_t i = first; i < last; i++ ) {
+        job->data[i] = job->function( job->data[i], job->context );
+    }
+}
+
+// replaces every element with function(element, context); the function is
+// called concurrently and in no particular order
+void dynamic_array_parallel_transform(
+    struct dynamic_array_workers *w, struct dynamic_array *da,
+    int ( *function )( const int value, void *context ), void *context,
+    const size_t threshold ) {
+    assert( da != NULL );
+    assert( function != NULL );
+    dynamic_array_unshare( da );
+    da->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                              DYNAMIC_ARRAY_FLAG_INDEXED );
+    struct transform_job job = {
+        .data     = da->buffer,
+        .n        = da->size,
+        .chunks   = 1,
+        .function = function,
+        .context  = context,
+    };
+    if ( serial( w, da->size, threshold ) ) {
+        if ( da->size > 0 ) { transform_task( &job, 0 ); }
+    } else {
+        job.chunks = chunk_count( w, da->size );
+        dynamic_array_workers_run( w, job.chunks, transform_task, &job );
+    }
+    dynamic_array_index_refresh( da );
+}
+
+// ============================================================================
+// Find
+// ============================================================================
+
+struct find_job {
+    const int    *data;
+    size_t        n;
+    size_t        chunks;
+    int           value;
+    atomic_size_t best; // earliest match so far, n when none
+};
+
+static void find_task( void *context, const size_t index ) {
+    struct find_job *job = context;
+    size_t           first, last;
+    chunk_range( job->n, job->chunks, index, &first, &last );
+    // chunks are claimed in order, so once a match precedes this chunk the
+    // rest of the job has nothing left to improve
+    if ( first >= atomic_load_explicit( &job->best, memory_order_relaxed ) ) {
+        return;
+    }
+    size_t found = dynamic_array_simd_find( job->data + first, last - first,
+                                            job->value );
+    if ( found == last - first ) { return; }
+    found += first;
+    size_t best = atomic_load_explicit( &job->best, memory_order_relaxed );
+    while ( found < best &&
+            !atomic_compare_exchange_weak_explicit( &job->best, &best, found,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed ) ) {
+    }
+}
+
+// returns the earliest match like dynamic_array_find, which answers directly
+// on a sorted or indexed array
+ptrdiff_t dynamic_array_parallel_find( struct dynamic_array_workers *w,
+                                       const struct dynamic_array   *da,
+                                       const int                     value,
+                                       const size_t threshold ) {
+    assert( da != NULL );
+    if ( serial( w, da->size, threshold ) ||
+         ( da->flags &
+           ( DYNAMIC_ARRAY_FLAG_SORTED | DYNAMIC_ARRAY_FLAG_INDEXED ) ) ) {
+        return dynamic_array_find( da, value );
+    }
+    struct find_job job = {
+        .data   = da->buffer,
+        .n      = da->size,
+        .chunks = chunk_count( w, da->size ),
+        .value  = value,
+    };
+    atomic_init( &job.best, da->size );
+    dynamic_array_workers_run( w, job.chunks, find_task, &job );
+    size_t best = atomic_load_explicit( &job.best, memory_order_relaxed );
+    return best == da->size ? -1 : (ptrdiff_t)best;
+}
+
+// ============================================================================
+// Reductions
+// ============================================================================
+
+enum reduction { REDUCE_SUM, REDUCE_MIN, REDUCE_MAX };
+
+struct reduce_job {
+    const int     *data;
+    size_t         n;
+    size_t         chunks;
+    enum reduction op;
+    int64_t       *partials;
+};
+
+// each chunk runs the SIMD kernel for the one field that was asked for
+static int64_t reduce_range( const enum reduction op, const int *data,
+                             const size_t n ) {
+    switch ( op ) {
+        case REDUCE_SUM: return dynamic_array_simd_sum( data, n );
+        case REDUCE_MIN: return dynamic_array_simd_min( data, n );
+        case REDUCE_MAX: return dynamic_array_simd_max( data, n );
+    }
+    return 0;
+}
+
+static void reduce_task( void *context, const size_t index ) {
+    struct reduce_job *job = context;
+    size_t             first, last;
+    chunk_range( job->n, job->chunks, index, &first, &last );
+    job->partials[index] =
+        reduce_range( job->op, job->data + first, last - first );
+}
+
+static int64_t reduce( struct dynamic_array_workers *w,
+                       const struct dynamic_array *da, const enum reduction op,
+                       const size_t threshold ) {
+    assert( da != NULL );
+    if ( serial( w, da->size, threshold ) ) {
+        return reduce_range( op, da->buffer, da->size );
+    }
+    struct reduce_job job = {
+        .data   = da->buffer,
+        .n      = da->size,
+        .chunks = chunk_count( w, da->size ),
+        .op     = op,
+    };
+    job.partials = malloc( sizeof *job.partials * job.chunks );
+    assert( job.partials != NULL );
+    dynamic_array_workers_run( w, job.chunks, reduce_task, &job );
+
+    int64_t total = job.partials[0];
+    for ( size_t i = 1; i < job.chunks; i++ ) {
+        int64_t partial = job.partials[i];
+        switch ( op ) {
+            case REDUCE_SUM: total += partial; break;
+            case REDUCE_MIN: total = partial < total ? partial : total; break;
+            case REDUCE_MAX: total = partial > total ? partial : total; break;
+        }
+    }
+    free( job.partials );
+    return total;
+}
+
+// 64-bit so that 2^32 elements of INT_MAX still fit
+int64_t dynamic_array_parallel_sum( struct dynamic_array_workers *w,
+                                    const struct dynamic_array   *da,
+                                    const size_t                  threshold ) {
+    return reduce( w, da, REDUCE_SUM, threshold );
+}
+
+int dynamic_array_parallel_min( struct dynamic_array_workers *w,
+                                const struct dynamic_array   *da,
+                                const size_t                  threshold ) {
+    assert( da != NULL && da->size > 0 );
+    return (int)reduce( w, da, REDUCE_MIN, threshold );
+}
+
+int dynamic_array_parallel_max( struct dynamic_array_workers *w,
+                                const struct dynamic_array   *da,
+                                const size_t                  threshold ) {
+    assert( da != NULL && da->size > 0 );
+    return (int)reduce( w, da, REDUCE_MAX, threshold );
+}
+
+// ============================================================================
+// Sort
+// ============================================================================
+
+// Parallel LSD radix sort: every pass histograms each chunk in parallel,
+// turns the histograms into per-chunk output offsets serially (256 x chunks)
+// and scatters the chunks in parallel. Chunk t writes bucket b right after
+// chunks 0..t-1 wrote theirs, so each pass stays stable.
+
+#define RADIX_BUCKETS 256
+
+struct sort_job {
+    int    *src;
+    int    *dst;
+    size_t  n;
+    size_t  chunks;
+    size_t *counts; // chunks x RADIX_BUCKETS
+    size_t  shift;
+};
+
+static inline size_t radix_byte( const int value, const size_t shift ) {
+    return ( ( (uint32_t)value ^ 0x80000000u ) >> shift ) & 0xFF;
+}
+
+static void histogram_task( void *context, const size_t index ) {
+    struct sort_job *job    = context;
+    size_t          *counts = job->counts + index * RADIX_BUCKETS;
+    size_t           first, last;
+    chunk_range( job->n, job->chunks, index, &first, &last );
+    memset( counts, 0, sizeof *counts * RADIX_BUCKETS );
+    for ( size_t i = first; i < last; i++ ) {
+        counts[radix_byte( job->src[i], job->shift )]++;
+    }
+}
+
+static void scatter_task( void *context, const size_t index ) {
+    struct sort_job *job     = context;
+    size_t          *offsets = job->counts + index * RADIX_BUCKETS;
+    size_t           first, last;
+    chunk_range( job->n, job->chunks, index, &first, &last );
+    for ( size_t i = first; i < last; i++ ) {
+        job->dst[offsets[radix_byte( job->src[i], job->shift )]++] =
+            job->src[i];
+    }
+}
+
+// time: O(N / threads) per pass, at most four passes
+// sorts ascending and sets the sorted flag like dynamic_array_sort
+void dynamic_array_parallel_sort( struct dynamic_array_workers *w,
+                                  struct dynamic_array         *da,
+                                  const size_t                  threshold ) {
+    assert( da != NULL );
+    if ( serial( w, da->size, threshold ) ||
+         ( da->flags & DYNAMIC_ARRAY_FLAG_SORTED ) ) {
+        dynamic_array_sort( da );
+        return;
+    }
+
+    dynamic_array_unshare( da );
+    const size_t bytes = sizeof *da->buffer * da->size;
+    int *scratch = da->allocator->alloc( da->allocator->context, bytes );
+    assert( scratch != NULL );
+    struct sort_job job = {
+        .src    = da->buffer,
+        .dst    = scratch,
+        .n      = da->size,
+        .chunks = chunk_count( w, da->size ),
+    };
+    job.counts = malloc( sizeof *job.counts * job.chunks * RADIX_BUCKETS );
+    assert( job.counts != NULL );
+
+    for ( job.shift = 0; job.shift < 32; job.shift += 8 ) {
+        dynamic_array_workers_run( w, job.chunks, histogram_task, &job );
+
+        // exclusive prefix over (bucket, chunk) in that order
+        size_t offset = 0;
+        bool   skip   = false;
+        for ( size_t b = 0; b < RADIX_BUCKETS; b++ ) {
+            size_t bucket = 0;
+            for ( size_t t = 0; t < job.chunks; t++ ) {
+                size_t count = job.counts[t * RADIX_BUCKETS + b];
+                job.counts[t * RADIX_BUCKETS + b] = offset;
+                offset += count;
+                bucket += count;
+            }
+            // every key shares this byte: the pass would be a plain copy
+            skip = skip || bucket == job.n;
+        }
+        if ( skip ) { continue; }
+
+        dynamic_array_workers_run( w, job.chunks, scatter_task, &job );
+        int *temp = job.src;
+        job.src   = job.dst;
+        job.dst   = temp;
+    }
+    if ( job.src != da->buffer ) { memcpy( da->buffer, job.src, bytes ); }
+
+    free( job.counts );
+    da->allocator->free( da->allocator->context, scratch, bytes );
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+    da->flags |= DYNAMIC_ARRAY_FLAG_SORTED;
+    dynamic_array_index_refresh( da );
+}
@@ -0,0 +1,66 @@
+#ifndef DYNAMIC_ARRAY_PARALLEL_H
+#define DYNAMIC_ARRAY_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dynamic_array.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed pool of pthreads that run index-based tasks. The calling thread
+// takes part in every job, so a pool of N threads starts N - 1 workers.
+// A pool runs one job at a time; it must not be shared by concurrent callers.
+struct dynamic_array_workers;
+
+// 0 threads selects the number of online processors
+extern struct dynamic_array_workers *
+dynamic_array_workers_create( const size_t threads );
+extern void dynamic_array_workers_destroy( struct dynamic_array_workers *w );
+extern size_t
+dynamic_array_workers_threads( const struct dynamic_array_workers *w );
+// runs task(context, i) for every i in [0, tasks) and returns when all are
+// done; tasks are handed out in increasing order
+extern void dynamic_array_workers_run( struct dynamic_array_workers *w,
+                                       const size_t                  tasks,
+                                       void ( *task )( void        *context,
+                                                       const size_t index ),
+                                       void *context );
+
+// Parallel versions of the int array operations. Arrays smaller than
+// `threshold` elements, or a NULL / single-thread pool, take the serial path,
+// so results are identical either way.
+#define DYNAMIC_ARRAY_PARALLEL_THRESHOLD ( (size_t)1 << 16 )
+
+extern void dynamic_array_parallel_fill( struct dynamic_array_workers *w,
+                                         struct dynamic_array         *da,
+                                         const int                     value,
+                                         const size_t threshold );
+extern ptrdiff_t
+dynamic_array_parallel_find( struct dynamic_array_workers *w,
+                             const struct dynamic_array *da, const int value,
+                             const size_t threshold );
+extern int64_t dynamic_array_parallel_sum( struct dynamic_array_workers *w,
+                                           const struct dynamic_array   *da,
+                                           const size_t threshold );
+extern int     dynamic_array_parallel_min( struct dynamic_array_workers *w,
+                                           const struct dynamic_array   *da,
+                                           const size_t threshold );
+extern int     dynamic_array_parallel_max( struct dynamic_array_workers *w,
+                                           const struct dynamic_array   *da,
+                                           const size_t threshold );
+extern void    dynamic_array_parallel_transform(
+       struct dynamic_array_workers *w, struct dynamic_array *da,
+       int ( *function )( const int value, void *context ), void *context,
+       const size_t threshold );
+extern void dynamic_array_parallel_sort( struct dynamic_array_workers *w,
+                                         struct dynamic_array         *da,
+                                         const size_t threshold );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_PARALLEL_H
@@ -0,0 +1,380 @@
+// Type-generic ring buffer (deque) template.
+//
+// Same parameters and modes as dynamic_array_template.h: include it with
+// DYNAMIC_ARRAY_NAME and DYNAMIC_ARRAY_TYPE defined (plus optionally
+// DYNAMIC_ARRAY_IMPLEMENTATION or DYNAMIC_ARRAY_STATIC) to generate
+// `struct NAME` and the NAME_* functions.
+//
+// Elements live in a circular buffer starting at `head`, so both ends are
+// O(1) and get/set take logical indices. Rotating a full ring only moves
+// `head`; a partially filled one moves min(k, N - k) elements. linearize
+// makes the contents contiguous when a plain pointer is needed.
+//
+// Example:
+//   #define DYNAMIC_ARRAY_NAME window
+//   #define DYNAMIC_ARRAY_TYPE double
+//   #define DYNAMIC_ARRAY_STATIC
+//   #include "dynamic_array_ring_template.h"
+//
+//   struct window *w = window_create();
+//   window_push_back( w, sample );
+//   if ( window_size( w ) > 64 ) { window_pop_front( w ); }
+
+#include "dynamic_array_common.h"
+
+#if !defined( DYNAMIC_ARRAY_NAME ) || !defined( DYNAMIC_ARRAY_TYPE )
+#error "DYNAMIC_ARRAY_NAME and DYNAMIC_ARRAY_TYPE must be defined"
+#endif
+
+#if defined( DYNAMIC_ARRAY_STATIC )
+#define DA_DECLARE 1
+#define DA_DEFINE  1
+#define DA_API     [[maybe_unused]] static
+#elif defined( DYNAMIC_ARRAY_IMPLEMENTATION )
+#define DA_DECLARE 0
+#define DA_DEFINE  1
+#define DA_API
+#else
+#define DA_DECLARE 1
+#define DA_DEFINE  0
+#define DA_API     extern
+#endif
+
+#define DA_T       DYNAMIC_ARRAY_TYPE
+#define DA_RING    struct DYNAMIC_ARRAY_NAME
+#define DA_FN( x ) DYNAMIC_ARRAY_CONCAT( DYNAMIC_ARRAY_NAME, _##x )
+
+#if DA_DECLARE
+
+DA_RING {
+    DA_T                                 *buffer;
+    size_t                                head;
+    size_t                                size;
+    size_t                                capacity;
+    const struct dynamic_array_allocator *allocator;
+    const struct dynamic_array_allocator *header_allocator;
+};
+
+DA_API DA_RING *DA_FN( create )( void );
+DA_API DA_RING *
+DA_FN( create_with )( const struct dynamic_array_allocator *header_allocator,
+                      const struct dynamic_array_allocator *allocator );
+DA_API void DA_FN( init )( DA_RING *ring );
+DA_API void
+DA_FN( init_with )( DA_RING                              *ring,
+                    const struct dynamic_array_allocator *allocator );
+DA_API void   DA_FN( clear )( DA_RING *ring );
+DA_API void   DA_FN( reserve )( DA_RING *ring, const size_t capacity );
+DA_API void   DA_FN( release )( DA_RING *ring );
+DA_API void   DA_FN( destroy )( DA_RING *ring );
+DA_API size_t DA_FN( size )( const DA_RING *ring );
+DA_API size_t DA_FN( capacity )( const DA_RING *ring );
+DA_API bool   DA_FN( empty )( const DA_RING *ring );
+DA_API void   DA_FN( push_back )( DA_RING *ring, const DA_T value );
+DA_API void   DA_FN( push_front )( DA_RING *ring, const DA_T value );
+DA_API DA_T   DA_FN( pop_back )( DA_RING *ring );
+DA_API DA_T   DA_FN( pop_front )( DA_RING *ring );
+DA_API DA_T   DA_FN( front )( const DA_RING *ring );
+DA_API DA_T   DA_FN( back )( const DA_RING *ring );
+DA_API DA_T   DA_FN( get )( const DA_RING *ring, const size_t index );
+DA_API void   DA_FN( set )( DA_RING *ring, const size_t index,
+                            const DA_T value );
+DA_API void   DA_FN( rotate_right )( DA_RING *ring );
+DA_API void   DA_FN( rotate_left )( DA_RING *ring );
+DA_API void   DA_FN( rotate_right_n )( DA_RING *ring, const int count );
+DA_API void   DA_FN( rotate_left_n )( DA_RING *ring, const int count );
+DA_API DA_T  *DA_FN( linearize )( DA_RING *ring );
+
+#endif // DA_DECLARE
+
+#if DA_DEFINE
+
+#include <assert.h>
+#include <string.h>
+
+// physical slot of logical `index`; head and index are both below capacity,
+// so one subtraction replaces the modulo
+static inline size_t DA_FN( slot )( const DA_RING *ring, const size_t index ) {
+    size_t slot = ring->head + index;
+    return slot >= ring->capacity ? slot - ring->capacity : slot;
+}
+
+// grows the buffer to exactly `capacity`; a wrapped segment [head, old
+// capacity) moves to the end of the new buffer so the ring stays intact
+static void DA_FN( reallocate )( DA_RING *ring, const size_t capacity ) {
+    assert( capacity <= SIZE_MAX / sizeof *ring->buffer );
+    assert( capacity > ring->capacity );
+    DA_T *buffer;
+    if ( ring->buffer == NULL ) {
+        buffer = ring->allocator->alloc( ring->allocator->context,
+                                         sizeof *ring->buffer * capacity );
+    } else {
+        buffer = ring->allocator->realloc(
+            ring->allocator->context, ring->buffer,
+            sizeof *ring->buffer * ring->capacity,
+            sizeof *ring->buffer * capacity );
+    }
+    assert( buffer != NULL );
+    if ( ring->head + ring->size > ring->capacity ) {
+        size_t first = ring->capacity - ring->head;
+        memmove( buffer + capacity - first, buffer + ring->head,
+                 sizeof *ring->buffer * first );
+        ring->head = capacity - first;
+    }
+    ring->buffer   = buffer;
+    ring->capacity = capacity;
+}
+
+static void DA_FN( grow )( DA_RING *ring ) {
+    assert( ring->capacity <= SIZE_MAX / 2 / sizeof *ring->buffer );
+    DA_FN( reallocate )( ring, ring->capacity
+                                   ? ring->capacity << 1
+                                   : DYNAMIC_ARRAY_DEFAULT_CAPACITY );
+}
+
+static void DA_FN( reverse )( DA_T *buffer, const size_t n ) {
+    if ( n < 2 ) { return; }
+    for ( size_t i = 0, j = n - 1; i < j; i++, j-- ) {
+        DA_T temp = buffer[i];
+        buffer[i] = buffer[j];
+        buffer[j] = temp;
+    }
+}
+
+DA_API DA_RING *DA_FN( create )( void ) {
+    return DA_FN( create_with )( NULL, NULL );
+}
+
+// allocators as for the array template: NULL selects the heap, both must
+// outlive the ring
+DA_API DA_RING *
+DA_FN( create_with )( const struct dynamic_array_allocator *header_allocator,
+                      const struct dynamic_array_allocator *allocator ) {
+    if ( header_allocator == NULL ) {
+        header_allocator = &dynamic_array_heap_allocator;
+    }
+    DA_RING *ring;
+    ring = header_allocator->alloc( header_allocator->context, sizeof *ring );
+    assert( ring != NULL );
+    DA_FN( init_with )( ring, allocator );
+    ring->header_allocator = header_allocator;
+    return ring;
+}
+
+DA_API void DA_FN( init )( DA_RING *ring ) { DA_FN( init_with )( ring, NULL ); }
+
+DA_API void
+DA_FN( init_with )( DA_RING                              *ring,
+                    const struct dynamic_array_allocator *allocator ) {
+    assert( ring != NULL );
+    ring->buffer    = NULL;
+    ring->head      = 0;
+    ring->size      = 0;
+    ring->capacity  = 0;
+    ring->allocator = allocator ? allocator : &dynamic_array_heap_allocator;
+    ring->header_allocator = &dynamic_array_heap_allocator;
+}
+
+// empties the ring but keeps the buffer
+DA_API void DA_FN( clear )( DA_RING *ring ) {
+    assert( ring != NULL );
+    ring->head = 0;
+    ring->size = 0;
+}
+
+DA_API void DA_FN( reserve )( DA_RING *ring, const size_t capacity ) {
+    assert( ring != NULL );
+    if ( capacity > ring->capacity ) { DA_FN( reallocate )( ring, capacity ); }
+}
+
+// frees the buffer, the ring stays usable
+DA_API void DA_FN( release )( DA_RING *ring ) {
+    assert( ring != NULL );
+    if ( ring->buffer != NULL ) {
+        ring->allocator->free( ring->allocator->context, ring->buffer,
+                               sizeof *ring->buffer * ring->capacity );
+    }
+    ring->buffer   = NULL;
+    ring->head     = 0;
+    ring->size     = 0;
+    ring->capacity = 0;
+}
+
+DA_API void DA_FN( destroy )( DA_RING *ring ) {
+    assert( ring != NULL );
+    const struct dynamic_array_allocator *header = ring->header_allocator;
+    DA_FN( release )( ring );
+    header->free( header->context, ring, sizeof *ring );
+}
+
+DA_API size_t DA_FN( size )( const DA_RING *ring ) {
+    assert( ring != NULL );
+    return ring->size;
+}
+
+DA_API size_t DA_FN( capacity )( const DA_RING *ring ) {
+    assert( ring != NULL );
+    return ring->capacity;
+}
+
+DA_API bool DA_FN( empty )( const DA_RING *ring ) {
+    assert( ring != NULL );
+    return ring->size == 0;
+}
+
+// time: O(1) amortized
+DA_API void DA_FN( push_back )( DA_RING *ring, const DA_T value ) {
+    assert( ring != NULL );
+    if ( ring->size == ring->capacity ) { DA_FN( grow )( ring ); }
+    ring->buffer[DA_FN( slot )( ring, ring->size )] = value;
+    ring->size++;
+}
+
+// time: O(1) amortized
+DA_API void DA_FN( push_front )( DA_RING *ring, const DA_T value ) {
+    assert( ring != NULL );
+    if ( ring->size == ring->capacity ) { DA_FN( grow )( ring ); }
+    ring->head = ring->head ? ring->head - 1 : ring->capacity - 1;
+    ring->buffer[ring->head] = value;
+    ring->size++;
+}
+
+// time: O(1)
+DA_API DA_T DA_FN( pop_back )( DA_RING *ring ) {
+    assert( ring != NULL );
+    assert( ring->size > 0 );
+    ring->size--;
+    return ring->buffer[DA_FN( slot )( ring, ring->size )];
+}
+
+// time: O(1)
+DA_API DA_T DA_FN( pop_front )( DA_RING *ring ) {
+    assert( ring != NULL );
+    assert( ring->size > 0 );
+    DA_T value = ring->buffer[ring->head];
+    ring->head = ring->head + 1 == ring->capacity ? 0 : ring->head + 1;
+    ring->size--;
+    return value;
+}
+
+DA_API DA_T DA_FN( front )( const DA_RING *ring ) {
+    assert( ring != NULL );
+    assert( ring->size > 0 );
+    return ring->buffer[ring->head];
+}
+
+DA_API DA_T DA_FN( back )( const DA_RING *ring ) {
+    assert( ring != NULL );
+    assert( ring->size > 0 );
+    return ring->buffer[DA_FN( slot )( ring, ring->size - 1 )];
+}
+
+DA_API DA_T DA_FN( get )( const DA_RING *ring, const size_t index ) {
+    assert( ring != NULL );
+    assert( index < ring->size );
+    return ring->buffer[DA_FN( slot )( ring, index )];
+}
+
+DA_API void DA_FN( set )( DA_RING *ring, const size_t index,
+                          const DA_T value ) {
+    assert( ring != NULL );
+    assert( index < ring->size );
+    ring->buffer[DA_FN( slot )( ring, index )] = value;
+}
+
+// time: O(1) when full, otherwise O(min(k, N - k))
+// a full ring rotates by moving head; otherwise the shorter side is moved
+// across the gap one element at a time
+DA_API void DA_FN( rotate_left_n )( DA_RING *ring, const int count ) {
+    assert( ring != NULL );
+    if ( ring->size < 2 ) { return; }
+    size_t k = dynamic_array_euclidean_division( count, ring->size );
+    if ( k == 0 ) { return; }
+    if ( ring->size == ring->capacity ) {
+        ring->head = DA_FN( slot )( ring, k );
+    } else if ( k <= ring->size - k ) {
+        for ( size_t i = 0; i < k; i++ ) {
+            DA_FN( push_back )( ring, DA_FN( pop_front )( ring ) );
+        }
+    } else {
+        for ( size_t i = k; i < ring->size; i++ ) {
+            DA_FN( push_front )( ring, DA_FN( pop_back )( ring ) );
+        }
+    }
+}
+
+// time: O(1) when full, otherwise O(min(k, N - k))
+DA_API void DA_FN( rotate_right_n )( DA_RING *ring, const int count ) {
+    assert( ring != NULL );
+    if ( ring->size < 2 ) { return; }
+    size_t k = dynamic_array_euclidean_division( count, ring->size );
+    if ( k == 0 ) { return; }
+    if ( ring->size == ring->capacity ) {
+        ring->head = DA_FN( slot )( ring, ring->size - k );
+    } else if ( k <= ring->size - k ) {
+        for ( size_t i = 0; i < k; i++ ) {
+            DA_FN( push_front )( ring, DA_FN( pop_back )( ring ) );
+        }
+    } else {
+        for ( size_t i = k; i < ring->size; i++ ) {
+            DA_FN( push_back )( ring, DA_FN( pop_front )( ring ) );
+        }
+    }
+}
+
+// time: O(1)
+DA_API void DA_FN( rotate_right )( DA_RING *ring ) {
+    assert( ring != NULL );
+    if ( ring->size < 2 ) { return; }
+    DA_FN( push_front )( ring, DA_FN( pop_back )( ring ) );
+}
+
+// time: O(1)
+DA_API void DA_FN( rotate_left )( DA_RING *ring ) {
+    assert( ring != NULL );
+    if ( ring->size < 2 ) { return; }
+    DA_FN( push_back )( ring, DA_FN( pop_front )( ring ) );
+}
+
+// time: O(1) if the contents do not wrap, otherwise O(capacity)
+// returns a pointer to the `size` elements in logical order, valid until the
+// next push, rotation or linearize; unwrapped rings are returned as they are
+DA_API DA_T *DA_FN( linearize )( DA_RING *ring ) {
+    assert( ring != NULL );
+    if ( ring->head + ring->size <= ring->capacity ) {
+        return ring->buffer == NULL ? NULL : ring->buffer + ring->head;
+    }
+    const size_t first  = ring->capacity - ring->head;
+    const size_t second = ring->size - first;
+    if ( first <= ring->capacity - ring->size ) {
+        // the [head, capacity) segment fits in the gap: slide the wrapped
+        // part up behind it and copy it to the front
+        memmove( ring->buffer + first, ring->buffer,
+                 sizeof *ring->buffer * second );
+        memcpy( ring->buffer, ring->buffer + ring->head,
+                sizeof *ring->buffer * first );
+    } else {
+        // rotate the whole buffer left by head; unused slots are cleared
+        // first so only initialized values are moved
+        memset( ring->buffer + second, 0,
+                sizeof *ring->buffer * ( ring->head - second ) );
+        DA_FN( reverse )( ring->buffer, ring->head );
+        DA_FN( reverse )( ring->buffer + ring->head, first );
+        DA_FN( reverse )( ring->buffer, ring->capacity );
+    }
+    ring->head = 0;
+    return ring->buffer;
+}
+
+#endif // DA_DEFINE
+
+#undef DA_FN
+#undef DA_RING
+#undef DA_T
+#undef DA_API
+#undef DA_DEFINE
+#undef DA_DECLARE
+#undef DYNAMIC_ARRAY_STATIC
+#undef DYNAMIC_ARRAY_IMPLEMENTATION
+#undef DYNAMIC_ARRAY_TYPE
+#undef DYNAMIC_ARRAY_NAME
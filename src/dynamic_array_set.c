@@ -0,0 +1,262 @@
+#include "dynamic_array_set.h"
+
+#include "dynamic_array_simd.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+// below this size ratio the vectorized merge beats galloping (measured with
+// AVX2 on a million elements)
+#define GALLOP_RATIO 64
+
+struct cursor {
+    const int *next;
+    const int *end;
+};
+
+// The first position from `from` on whose element is not below value.
+// Steps of 1, 2, 4, ... bracket it and a binary search finishes inside the
+// bracket, so a jump of d elements costs O(log d).
+static size_t gallop( const int *data, const size_t n, const size_t from,
+                      const int value ) {
+    if ( from >= n || data[from] >= value ) { return from; }
+    size_t lo   = from; // data[lo] < value
+    size_t step = 1;
+    while ( lo + step < n && data[lo + step] < value ) {
+        lo += step;
+        step *= 2;
+    }
+    const size_t hi = lo + step < n ? lo + step : n;
+    return lo + 1 +
+           dynamic_array_simd_lower_bound( data + lo + 1, hi - lo - 1, value );
+}
+
+// appends value unless it repeats the last one written
+static inline size_t append_distinct( int *out, size_t count,
+                                      const int value ) {
+    if ( count == 0 || out[count - 1] != value ) { out[count++] = value; }
+    return count;
+}
+
+// empties out and reserves room for n elements, the only reserve of an
+// operation; unshare asserts that out is writable
+static int *prepare( struct dynamic_array *out, const size_t n ) {
+    dynamic_array_reset( out );
+    dynamic_array_unshare( out );
+    dynamic_array_reserve( out, n );
+    return out->buffer;
+}
+
+static void finish( struct dynamic_array *out, const size_t n ) {
+    out->size = n;
+    out->flags |= DYNAMIC_ARRAY_FLAG_SORTED;
+}
+
+static void check_operands( const struct dynamic_array *out,
+                            const struct dynamic_array *a,
+                            const struct dynamic_array *b ) {
+    assert( out != NULL && a != NULL && b != NULL );
+    assert( out != a && out != b );
+    (void)out;
+    (void)a;
+    (void)b;
+}
+
+// ============================================================================
+// Unique
+// ============================================================================
+
+size_t dynamic_array_unique( struct dynamic_array *da ) {
+    assert( da != NULL );
+    // nothing is written, or copied from a shared buffer, up to the first
+    // repeat
+    size_t i = 1;
+    while ( i < da->size && da->buffer[i] != da->buffer[i - 1] ) { i++; }
+    if ( i >= da->size ) { return 0; }
+    dynamic_array_unshare( da );
+    int   *data = da->buffer;
+    size_t kept = i;
+    for ( ; i < da->size; i++ ) {
+        const int value = data[i];
+        data[kept]      = value;
+        kept += value != data[kept - 1];
+    }
+    const size_t removed = da->size - kept;
+    da->size             = kept;
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+    dynamic_array_index_refresh( da );
+    return removed;
+}
+
+// ============================================================================
+// Merge
+// ============================================================================
+
+// either side may be empty, with no buffer
+static void merge_two( const int *a, const size_t na, const int *b,
+                       const size_t nb, int *out ) {
+    size_t i = 0;
+    size_t j = 0;
+    while ( i < na && j < nb ) {
+        const bool take_b = b[j] < a[i];
+        out[i + j]        = take_b ? b[j] : a[i];
+        i += !take_b;
+        j += take_b;
+    }
+    if ( i < na ) { memcpy( out + i + j, a + i, sizeof *out * ( na - i ) ); }
+    if ( j < nb ) { memcpy( out + na + j, b + j, sizeof *out * ( nb - j ) ); }
+}
+
+// restores the min-heap order of the cursors below position i
+static void sift_down( struct cursor *heap, const size_t n, size_t i ) {
+    const struct cursor moved = heap[i];
+    for ( ;; ) {
+        size_t child = 2 * i + 1;
+        if ( child >= n ) { break; }
+        if ( child + 1 < n && *heap[child + 1].next < *heap[child].next ) {
+            child++;
+        }
+        if ( *moved.next <= *heap[child].next ) { break; }
+        heap[i] = heap[child];
+        i       = child;
+    }
+    heap[i] = moved;
+}
+
+// the cursor heap comes from out's allocator; the last array left is copied
+// in one go
+static void merge_heap( struct dynamic_array              *out,
+                        const struct dynamic_array *const *arrays,
+                        const size_t k, int *dst ) {
+    const struct dynamic_array_allocator *allocator = out->allocator;
+    struct cursor                        *heap =
+        allocator->alloc( allocator->context, sizeof *heap * k );
+    assert( heap != NULL );
+    size_t n = 0;
+    for ( size_t i = 0; i < k; i++ ) {
+        if ( arrays[i]->size == 0 ) { continue; }
+        heap[n++] = ( struct cursor ){ .next = arrays[i]->buffer,
+                                       .end  = arrays[i]->buffer +
+                                              arrays[i]->size };
+    }
+    for ( size_t i = n / 2; i > 0; i-- ) { sift_down( heap, n, i - 1 ); }
+    while ( n > 1 ) {
+        *dst++ = *heap[0].next++;
+        if ( heap[0].next == heap[0].end ) { heap[0] = heap[--n]; }
+        sift_down( heap, n, 0 );
+    }
+    if ( n == 1 ) {
+        memcpy( dst, heap[0].next,
+                sizeof *dst * (size_t)( heap[0].end - heap[0].next ) );
+    }
+    allocator->free( allocator->context, heap, sizeof *heap * k );
+}
+
+void dynamic_array_merge( struct dynamic_array              *out,
+                          const struct dynamic_array *const *arrays,
+                          const size_t                       k ) {
+    assert( out != NULL );
+    assert( arrays != NULL || k == 0 );
+    size_t total = 0;
+    for ( size_t i = 0; i < k; i++ ) {
+        assert( arrays[i] != NULL && arrays[i] != out );
+        assert( arrays[i]->size <= SIZE_MAX / sizeof( int ) - total );
+        total += arrays[i]->size;
+    }
+    int *dst = prepare( out, total );
+    if ( total == 0 ) {
+        finish( out, 0 );
+        return;
+    }
+    if ( k == 1 ) {
+        memcpy( dst, arrays[0]->buffer, sizeof *dst * total );
+    } else if ( k == 2 ) {
+        merge_two( arrays[0]->buffer, arrays[0]->size, arrays[1]->buffer,
+                   arrays[1]->size, dst );
+    } else {
+        merge_heap( out, arrays, k, dst );
+    }
+    finish( out, total );
+}
+
+// ============================================================================
+// Intersection, union and difference
+// ============================================================================
+
+// each distinct value of the small side is looked up by galloping forward
+// through the large one
+static size_t gallop_intersect( const int *small, const size_t ns,
+                                const int *large, const size_t nl,
+                                int *out ) {
+    size_t count = 0;
+    size_t j     = 0;
+    for ( size_t i = 0; i < ns && j < nl; i++ ) {
+        if ( i > 0 && small[i] == small[i - 1] ) { continue; }
+        j = gallop( large, nl, j, small[i] );
+        if ( j < nl && large[j] == small[i] ) { out[count++] = small[i]; }
+    }
+    return count;
+}
+
+void dynamic_array_intersect( struct dynamic_array       *out,
+                              const struct dynamic_array *a,
+                              const struct dynamic_array *b ) {
+    check_operands( out, a, b );
+    const struct dynamic_array *small = a->size <= b->size ? a : b;
+    const struct dynamic_array *large = small == a ? b : a;
+    int                        *dst   = prepare( out, small->size );
+    size_t                      count = 0;
+    if ( large->size / GALLOP_RATIO > small->size ) {
+        count = gallop_intersect( small->buffer, small->size, large->buffer,
+                                  large->size, dst );
+    } else {
+        count = dynamic_array_simd_intersect( a->buffer, a->size, b->buffer,
+                                              b->size, dst );
+    }
+    finish( out, count );
+}
+
+void dynamic_array_union( struct dynamic_array       *out,
+                          const struct dynamic_array *a,
+                          const struct dynamic_array *b ) {
+    check_operands( out, a, b );
+    assert( a->size <= SIZE_MAX / sizeof( int ) - b->size );
+    int       *dst   = prepare( out, a->size + b->size );
+    const int *x     = a->buffer;
+    const int *y     = b->buffer;
+    size_t     i     = 0;
+    size_t     j     = 0;
+    size_t     count = 0;
+    while ( i < a->size && j < b->size ) {
+        const int lo = x[i] < y[j] ? x[i] : y[j];
+        count        = append_distinct( dst, count, lo );
+        i += x[i] == lo;
+        j += y[j] == lo;
+    }
+    for ( ; i < a->size; i++ ) { count = append_distinct( dst, count, x[i] ); }
+    for ( ; j < b->size; j++ ) { count = append_distinct( dst, count, y[j] ); }
+    finish( out, count );
+}
+
+void dynamic_array_difference( struct dynamic_array       *out,
+                               const struct dynamic_array *a,
+                               const struct dynamic_array *b ) {
+    check_operands( out, a, b );
+    int       *dst      = prepare( out, a->size );
+    const bool gallop_b = b->size / GALLOP_RATIO > a->size;
+    size_t     j        = 0;
+    size_t     count    = 0;
+    for ( size_t i = 0; i < a->size; i++ ) {
+        const int value = a->buffer[i];
+        if ( gallop_b ) {
+            j = gallop( b->buffer, b->size, j, value );
+        } else {
+            while ( j < b->size && b->buffer[j] < value ) { j++; }
+        }
+        if ( j == b->size || b->buffer[j] != value ) {
+            count = append_distinct( dst, count, value );
+        }
+    }
+    finish( out, count );
+}
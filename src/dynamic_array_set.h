@@ -0,0 +1,46 @@
+#ifndef DYNAMIC_ARRAY_SET_H
+#define DYNAMIC_ARRAY_SET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dynamic_array.h"
+
+#include <stddef.h>
+
+// Set algebra on int arrays in ascending order (sorted, or built in order).
+// Results replace the contents of `out`, which is reserved once and marked
+// sorted; `out` must not be one of the inputs. intersect, union and
+// difference return sets: ascending, each value once, whatever duplicates
+// the inputs hold. merge keeps every element.
+
+// time: O(N); removes adjacent repeats, so a sorted array keeps each value
+// once. Returns how many elements were removed.
+extern size_t dynamic_array_unique( struct dynamic_array *da );
+
+// time: O(N log k) for N elements in k arrays; O(N) for k <= 2
+extern void dynamic_array_merge( struct dynamic_array              *out,
+                                 const struct dynamic_array *const *arrays,
+                                 const size_t                       k );
+
+// time: O(m log(n / m)) by galloping when one side is much smaller (m to n),
+// otherwise O(n + m) with the SIMD block kernel
+extern void dynamic_array_intersect( struct dynamic_array       *out,
+                                     const struct dynamic_array *a,
+                                     const struct dynamic_array *b );
+// time: O(n + m)
+extern void dynamic_array_union( struct dynamic_array       *out,
+                                 const struct dynamic_array *a,
+                                 const struct dynamic_array *b );
+// values of a missing from b; time: O(m log(n / m)) when b is much larger,
+// otherwise O(n + m)
+extern void dynamic_array_difference( struct dynamic_array       *out,
+                                      const struct dynamic_array *a,
+                                      const struct dynamic_array *b );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_SET_H
@@ -0,0 +1,1088 @@
+#include "dynamic_array_simd.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Intrinsics are compiled per function with target attributes, so the
+// library itself needs no -m flags and still runs on CPUs without AVX.
+// Build with -DDYNAMIC_ARRAY_NO_SIMD=1 to keep only the scalar kernels.
+#ifndef DYNAMIC_ARRAY_NO_SIMD
+#define DYNAMIC_ARRAY_NO_SIMD 0
+#endif
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) &&                        \
+    defined( __GNUC__ ) && !DYNAMIC_ARRAY_NO_SIMD
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+// lanes are flushed into a size_t well before a 32-bit counter can overflow
+#define COUNT_BLOCK ( (size_t)1 << 28 )
+
+struct kernels {
+    size_t ( *find )( const int *data, const size_t n, const int value );
+    size_t ( *find_last )( const int *data, const size_t n, const int value );
+    size_t ( *count )( const int *data, const size_t n, const int value );
+    size_t ( *find_all )( const int *data, const size_t n, const int value,
+                          size_t *out, const size_t max );
+    size_t ( *remove )( int *data, const size_t n, const int value );
+    int64_t ( *sum )( const int *data, const size_t n );
+    int ( *min )( const int *data, const size_t n );
+    int ( *max )( const int *data, const size_t n );
+    void ( *minmax )( const int *data, const size_t n, int *min, int *max );
+    void ( *unpack128 )( const uint32_t *packed, const unsigned bits,
+                         const int reference, const bool delta, int *out );
+    size_t ( *intersect )( const int *a, const size_t na, const int *b,
+                           const size_t nb, int *out );
+};
+
+// ============================================================================
+// Scalar reference kernels
+// ============================================================================
+
+static size_t scalar_find( const int *data, const size_t n, const int value ) {
+    for ( size_t i = 0; i < n; i++ ) {
+        if ( data[i] == value ) { return i; }
+    }
+    return n;
+}
+
+static size_t scalar_find_last( const int *data, const size_t n,
+                                const int value ) {
+    for ( size_t i = n; i > 0; i-- ) {
+        if ( data[i - 1] == value ) { return i - 1; }
+    }
+    return n;
+}
+
+static size_t scalar_count( const int *data, const size_t n,
+                            const int value ) {
+    size_t count = 0;
+    for ( size_t i = 0; i < n; i++ ) { count += data[i] == value; }
+    return count;
+}
+
+static size_t scalar_find_all( const int *data, const size_t n,
+                               const int value, size_t *out,
+                               const size_t max ) {
+    size_t count = 0;
+    for ( size_t i = 0; i < n; i++ ) {
+        if ( data[i] == value ) {
+            if ( count < max ) { out[count] = i; }
+            count++;
+        }
+    }
+    return count;
+}
+
+// stream compaction: every element is stored, the output position only
+// advances past the ones that are kept, so there is no branch per element
+static size_t scalar_remove( int *data, const size_t n, const int value ) {
+    size_t kept = 0;
+    for ( size_t i = 0; i < n; i++ ) {
+        const int element = data[i];
+        data[kept]        = element;
+        kept += element != value;
+    }
+    return kept;
+}
+
+static int64_t scalar_sum( const int *data, const size_t n ) {
+    int64_t sum = 0;
+    for ( size_t i = 0; i < n; i++ ) { sum += data[i]; }
+    return sum;
+}
+
+static int scalar_min( const int *data, const size_t n ) {
+    int min = INT_MAX;
+    for ( size_t i = 0; i < n; i++ ) { min = data[i] < min ? data[i] : min; }
+    return min;
+}
+
+static int scalar_max( const int *data, const size_t n ) {
+    int max = INT_MIN;
+    for ( size_t i = 0; i < n; i++ ) { max = data[i] > max ? data[i] : max; }
+    return max;
+}
+
+static void scalar_minmax( const int *data, const size_t n, int *min,
+                           int *max ) {
+    int lo = INT_MAX;
+    int hi = INT_MIN;
+    for ( size_t i = 0; i < n; i++ ) {
+        lo = data[i] < lo ? data[i] : lo;
+        hi = data[i] > hi ? data[i] : hi;
+    }
+    *min = lo;
+    *max = hi;
+}
+
+static inline uint32_t low_mask( const unsigned bits ) {
+    return bits == 32 ? UINT32_MAX : ( (uint32_t)1 << bits ) - 1;
+}
+
+static void scalar_unpack128( const uint32_t *packed, const unsigned bits,
+                              const int reference, const bool delta,
+                              int *out ) {
+    uint32_t acc[4];
+    for ( unsigned lane = 0; lane < 4; lane++ ) {
+        acc[lane] = (uint32_t)reference;
+    }
+    for ( unsigned row = 0; row < 32; row++ ) {
+        for ( unsigned lane = 0; lane < 4; lane++ ) {
+            uint32_t value =
+                bits ? dynamic_array_simd_extract( packed + lane, bits, row )
+                     : 0;
+            if ( delta ) {
+                acc[lane] += value;
+                value = acc[lane];
+            } else {
+                value += (uint32_t)reference;
+            }
+            out[4 * row + lane] = (int)value;
+        }
+    }
+}
+
+// appends value unless it repeats the last one written; the output is
+// ascending, so every value is written once
+static inline size_t append_distinct( int *out, size_t count,
+                                      const int value ) {
+    if ( count == 0 || out[count - 1] != value ) { out[count++] = value; }
+    return count;
+}
+
+// merge intersection from positions i and j, appending to `count` values
+// already written
+static size_t intersect_from( const int *a, const size_t na, size_t i,
+                              const int *b, const size_t nb, size_t j,
+                              int *out, size_t count ) {
+    while ( i < na && j < nb ) {
+        const int x = a[i];
+        const int y = b[j];
+        if ( x == y ) { count = append_distinct( out, count, x ); }
+        i += x <= y;
+        j += y <= x;
+    }
+    return count;
+}
+
+static size_t scalar_intersect( const int *a, const size_t na, const int *b,
+                                const size_t nb, int *out ) {
+    return intersect_from( a, na, 0, b, nb, 0, out, 0 );
+}
+
+static const struct kernels scalar_kernels = {
+    .find      = scalar_find,
+    .find_last = scalar_find_last,
+    .count     = scalar_count,
+    .find_all  = scalar_find_all,
+    .remove    = scalar_remove,
+    .sum       = scalar_sum,
+    .min       = scalar_min,
+    .max       = scalar_max,
+    .minmax    = scalar_minmax,
+    .unpack128 = scalar_unpack128,
+    .intersect = scalar_intersect,
+};
+
+#if SIMD_X86
+
+// appends the set bits of a comparison mask as indices relative to `base`
+static inline size_t emit_mask( uint32_t mask, const size_t base, size_t *out,
+                                const size_t max, size_t count ) {
+    while ( mask ) {
+        if ( count < max ) {
+            out[count] = base + (size_t)__builtin_ctz( mask );
+        }
+        count++;
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+// ============================================================================
+// SSE2 kernels: 4 lanes, 16 elements per unrolled step
+// ============================================================================
+
+__attribute__( ( target( "sse2" ) ) ) static inline uint32_t
+sse2_mask( const int *p, const __m128i needle ) {
+    __m128i eq = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)p ),
+                                  needle );
+    return (uint32_t)_mm_movemask_ps( _mm_castsi128_ps( eq ) );
+}
+
+__attribute__( ( target( "sse2" ) ) ) static inline bool
+sse2_any16( const int *p, const __m128i needle ) {
+    __m128i a = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)p ),
+                                 needle );
+    __m128i b = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)p + 1 ),
+                                 needle );
+    __m128i c = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)p + 2 ),
+                                 needle );
+    __m128i d = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)p + 3 ),
+                                 needle );
+    __m128i any = _mm_or_si128( _mm_or_si128( a, b ), _mm_or_si128( c, d ) );
+    return _mm_movemask_epi8( any ) != 0;
+}
+
+__attribute__( ( target( "sse2" ) ) ) static size_t
+sse2_find( const int *data, const size_t n, const int value ) {
+    const __m128i needle = _mm_set1_epi32( value );
+    size_t        i      = 0;
+    while ( i + 16 <= n && !sse2_any16( data + i, needle ) ) { i += 16; }
+    for ( ; i + 4 <= n; i += 4 ) {
+        uint32_t mask = sse2_mask( data + i, needle );
+        if ( mask ) { return i + (size_t)__builtin_ctz( mask ); }
+    }
+    for ( ; i < n; i++ ) {
+        if ( data[i] == value ) { return i; }
+    }
+    return n;
+}
+
+__attribute__( ( target( "sse2" ) ) ) static size_t
+sse2_find_last( const int *data, const size_t n, const int value ) {
+    const __m128i needle = _mm_set1_epi32( value );
+    size_t        i      = n;
+    while ( i >= 16 && !sse2_any16( data + i - 16, needle ) ) { i -= 16; }
+    for ( ; i >= 4; i -= 4 ) {
+        uint32_t mask = sse2_mask( data + i - 4, needle );
+        if ( mask ) { return i - 4 + (size_t)( 31 - __builtin_clz( mask ) ); }
+    }
+    while ( i > 0 ) {
+        i--;
+        if ( data[i] == value ) { return i; }
+    }
+    return n;
+}
+
+__attribute__( ( target( "sse2" ) ) ) static size_t
+sse2_count( const int *data, const size_t n, const int value ) {
+    const __m128i needle = _mm_set1_epi32( value );
+    size_t        count  = 0;
+    size_t        i      = 0;
+    while ( i + 4 <= n ) {
+        size_t  stop = n - i > COUNT_BLOCK ? i + COUNT_BLOCK : n - 3;
+        __m128i acc  = _mm_setzero_si128();
+        for ( ; i < stop; i += 4 ) {
+            // equal lanes are all ones (-1), so subtracting counts them
+            __m128i eq = _mm_cmpeq_epi32(
+                _mm_loadu_si128( (const __m128i *)( data + i ) ), needle );
+            acc = _mm_sub_epi32( acc, eq );
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128( (__m128i *)lanes, acc );
+        count += (size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    return count + scalar_count( data + i, n - i, value );
+}
+
+__attribute__( ( target( "sse2" ) ) ) static size_t
+sse2_find_all( const int *data, const size_t n, const int value, size_t *out,
+               const size_t max ) {
+    const __m128i needle = _mm_set1_epi32( value );
+    size_t        count  = 0;
+    size_t        i      = 0;
+    for ( ; i + 4 <= n; i += 4 ) {
+        count = emit_mask( sse2_mask( data + i, needle ), i, out, max, count );
+    }
+    for ( ; i < n; i++ ) {
+        if ( data[i] == value ) {
+            if ( count < max ) { out[count] = i; }
+            count++;
+        }
+    }
+    return count;
+}
+
+// SSE2 has no variable shuffle, so only match-free blocks are moved as whole
+// vectors; blocks containing the value fall back to the scalar loop
+__attribute__( ( target( "sse2" ) ) ) static size_t
+sse2_remove( int *data, const size_t n, const int value ) {
+    const __m128i needle = _mm_set1_epi32( value );
+    size_t        kept   = 0;
+    size_t        i      = 0;
+    for ( ; i < n; i += 4 ) {
+        size_t lanes = n - i < 4 ? n - i : 4;
+        if ( lanes == 4 && sse2_mask( data + i, needle ) == 0 ) {
+            __m128i block = _mm_loadu_si128( (const __m128i *)( data + i ) );
+            _mm_storeu_si128( (__m128i *)( data + kept ), block );
+            kept += 4;
+            continue;
+        }
+        for ( size_t j = i; j < i + lanes; j++ ) {
+            const int element = data[j];
+            data[kept]        = element;
+            kept += element != value;
+        }
+    }
+    return kept;
+}
+
+// SSE2 lacks pmovsxdq: each lane is paired with its sign to widen it
+__attribute__( ( target( "sse2" ) ) ) static inline __m128i
+sse2_add_widened( const __m128i acc, const __m128i v ) {
+    __m128i sign = _mm_srai_epi32( v, 31 );
+    return _mm_add_epi64( _mm_add_epi64( acc, _mm_unpacklo_epi32( v, sign ) ),
+                          _mm_unpackhi_epi32( v, sign ) );
+}
+
+__attribute__( ( target( "sse2" ) ) ) static int64_t
+sse2_sum( const int *data, const size_t n ) {
+    __m128i a = _mm_setzero_si128();
+    __m128i b = _mm_setzero_si128();
+    size_t  i = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        const __m128i *v = (const __m128i *)( data + i );
+        a                = sse2_add_widened( a, _mm_loadu_si128( v ) );
+        b                = sse2_add_widened( b, _mm_loadu_si128( v + 1 ) );
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128( (__m128i *)lanes, _mm_add_epi64( a, b ) );
+    return lanes[0] + lanes[1] + scalar_sum( data + i, n - i );
+}
+
+// pminsd/pmaxsd are SSE4.1, so SSE2 selects through a comparison mask
+__attribute__( ( target( "sse2" ) ) ) static inline __m128i
+sse2_min_epi32( const __m128i a, const __m128i b ) {
+    __m128i gt = _mm_cmpgt_epi32( a, b );
+    return _mm_or_si128( _mm_and_si128( gt, b ), _mm_andnot_si128( gt, a ) );
+}
+
+__attribute__( ( target( "sse2" ) ) ) static inline __m128i
+sse2_max_epi32( const __m128i a, const __m128i b ) {
+    __m128i gt = _mm_cmpgt_epi32( a, b );
+    return _mm_or_si128( _mm_and_si128( gt, a ), _mm_andnot_si128( gt, b ) );
+}
+
+__attribute__( ( target( "sse2" ) ) ) static void
+sse2_minmax( const int *data, const size_t n, int *min, int *max ) {
+    __m128i lo = _mm_set1_epi32( INT_MAX );
+    __m128i hi = _mm_set1_epi32( INT_MIN );
+    size_t  i  = 0;
+    for ( ; i + 4 <= n; i += 4 ) {
+        __m128i v = _mm_loadu_si128( (const __m128i *)( data + i ) );
+        lo        = sse2_min_epi32( lo, v );
+        hi        = sse2_max_epi32( hi, v );
+    }
+    int lows[4], highs[4];
+    _mm_storeu_si128( (__m128i *)lows, lo );
+    _mm_storeu_si128( (__m128i *)highs, hi );
+    scalar_minmax( data + i, n - i, min, max );
+    for ( int l = 0; l < 4; l++ ) {
+        *min = lows[l] < *min ? lows[l] : *min;
+        *max = highs[l] > *max ? highs[l] : *max;
+    }
+}
+
+__attribute__( ( target( "sse2" ) ) ) static int
+sse2_min( const int *data, const size_t n ) {
+    __m128i lo = _mm_set1_epi32( INT_MAX );
+    size_t  i  = 0;
+    for ( ; i + 4 <= n; i += 4 ) {
+        lo = sse2_min_epi32( lo,
+                             _mm_loadu_si128( (const __m128i *)( data + i ) ) );
+    }
+    int lanes[4];
+    _mm_storeu_si128( (__m128i *)lanes, lo );
+    int min = scalar_min( data + i, n - i );
+    for ( int l = 0; l < 4; l++ ) { min = lanes[l] < min ? lanes[l] : min; }
+    return min;
+}
+
+__attribute__( ( target( "sse2" ) ) ) static int
+sse2_max( const int *data, const size_t n ) {
+    __m128i hi = _mm_set1_epi32( INT_MIN );
+    size_t  i  = 0;
+    for ( ; i + 4 <= n; i += 4 ) {
+        hi = sse2_max_epi32( hi,
+                             _mm_loadu_si128( (const __m128i *)( data + i ) ) );
+    }
+    int lanes[4];
+    _mm_storeu_si128( (__m128i *)lanes, hi );
+    int max = scalar_max( data + i, n - i );
+    for ( int l = 0; l < 4; l++ ) { max = lanes[l] > max ? lanes[l] : max; }
+    return max;
+}
+
+// a row of four lanes per step; shifts are uniform across lanes, so the
+// variable-count psrld/pslld do the extraction
+__attribute__( ( target( "sse2" ) ) ) static void
+sse2_unpack128( const uint32_t *packed, const unsigned bits,
+                const int reference, const bool delta, int *out ) {
+    const __m128i *in   = (const __m128i *)packed;
+    const __m128i  mask = _mm_set1_epi32( (int)low_mask( bits ) );
+    const __m128i  base = _mm_set1_epi32( reference );
+    __m128i        acc  = base;
+    for ( unsigned row = 0; row < 32; row++ ) {
+        __m128i value = _mm_setzero_si128();
+        if ( bits > 0 ) {
+            const unsigned offset = row * bits;
+            const unsigned word   = offset / 32;
+            const unsigned shift  = offset % 32;
+            value = _mm_srl_epi32( _mm_loadu_si128( in + word ),
+                                   _mm_cvtsi32_si128( (int)shift ) );
+            if ( shift + bits > 32 ) {
+                value = _mm_or_si128(
+                    value,
+                    _mm_sll_epi32( _mm_loadu_si128( in + word + 1 ),
+                                   _mm_cvtsi32_si128( (int)( 32 - shift ) ) ) );
+            }
+            value = _mm_and_si128( value, mask );
+        }
+        acc = _mm_add_epi32( delta ? acc : base, value );
+        _mm_storeu_si128( (__m128i *)( out + 4 * row ), acc );
+    }
+}
+
+// Blocks of four from each side are compared all against all: b is rotated
+// through its lanes, so four compares mark the lanes of a found in b. Then
+// the block with the smaller maximum is passed, both on a tie. A value
+// shared by both sides always meets the block of b holding it before either
+// block is passed, and matches come out in ascending order.
+__attribute__( ( target( "sse2" ) ) ) static size_t
+sse2_intersect( const int *a, const size_t na, const int *b, const size_t nb,
+                int *out ) {
+    size_t i     = 0;
+    size_t j     = 0;
+    size_t count = 0;
+    while ( i + 4 <= na && j + 4 <= nb ) {
+        const __m128i x  = _mm_loadu_si128( (const __m128i *)( a + i ) );
+        __m128i       y  = _mm_loadu_si128( (const __m128i *)( b + j ) );
+        __m128i       eq = _mm_cmpeq_epi32( x, y );
+        y                = _mm_shuffle_epi32( y, _MM_SHUFFLE( 0, 3, 2, 1 ) );
+        eq               = _mm_or_si128( eq, _mm_cmpeq_epi32( x, y ) );
+        y                = _mm_shuffle_epi32( y, _MM_SHUFFLE( 0, 3, 2, 1 ) );
+        eq               = _mm_or_si128( eq, _mm_cmpeq_epi32( x, y ) );
+        y                = _mm_shuffle_epi32( y, _MM_SHUFFLE( 0, 3, 2, 1 ) );
+        eq               = _mm_or_si128( eq, _mm_cmpeq_epi32( x, y ) );
+        uint32_t mask = (uint32_t)_mm_movemask_ps( _mm_castsi128_ps( eq ) );
+        for ( ; mask; mask &= mask - 1 ) {
+            count = append_distinct( out, count,
+                                     a[i + (size_t)__builtin_ctz( mask )] );
+        }
+        const int a_max = a[i + 3];
+        const int b_max = b[j + 3];
+        i += a_max <= b_max ? 4 : 0;
+        j += b_max <= a_max ? 4 : 0;
+    }
+    return intersect_from( a, na, i, b, nb, j, out, count );
+}
+
+static const struct kernels sse2_kernels = {
+    .find      = sse2_find,
+    .find_last = sse2_find_last,
+    .count     = sse2_count,
+    .find_all  = sse2_find_all,
+    .remove    = sse2_remove,
+    .sum       = sse2_sum,
+    .min       = sse2_min,
+    .max       = sse2_max,
+    .minmax    = sse2_minmax,
+    .unpack128 = sse2_unpack128,
+    .intersect = sse2_intersect,
+};
+
+// ============================================================================
+// AVX2 kernels: 8 lanes, 32 elements per unrolled step
+// ============================================================================
+
+__attribute__( ( target( "avx2" ) ) ) static inline uint32_t
+avx2_mask( const int *p, const __m256i needle ) {
+    __m256i eq = _mm256_cmpeq_epi32(
+        _mm256_loadu_si256( (const __m256i *)p ), needle );
+    return (uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( eq ) );
+}
+
+__attribute__( ( target( "avx2" ) ) ) static inline bool
+avx2_any32( const int *p, const __m256i needle ) {
+    const __m256i *v = (const __m256i *)p;
+    __m256i a = _mm256_cmpeq_epi32( _mm256_loadu_si256( v ), needle );
+    __m256i b = _mm256_cmpeq_epi32( _mm256_loadu_si256( v + 1 ), needle );
+    __m256i c = _mm256_cmpeq_epi32( _mm256_loadu_si256( v + 2 ), needle );
+    __m256i d = _mm256_cmpeq_epi32( _mm256_loadu_si256( v + 3 ), needle );
+    __m256i any =
+        _mm256_or_si256( _mm256_or_si256( a, b ), _mm256_or_si256( c, d ) );
+    return !_mm256_testz_si256( any, any );
+}
+
+__attribute__( ( target( "avx2" ) ) ) static size_t
+avx2_find( const int *data, const size_t n, const int value ) {
+    const __m256i needle = _mm256_set1_epi32( value );
+    size_t        i      = 0;
+    while ( i + 32 <= n && !avx2_any32( data + i, needle ) ) { i += 32; }
+    for ( ; i + 8 <= n; i += 8 ) {
+        uint32_t mask = avx2_mask( data + i, needle );
+        if ( mask ) { return i + (size_t)__builtin_ctz( mask ); }
+    }
+    size_t tail = sse2_find( data + i, n - i, value );
+    return tail == n - i ? n : i + tail;
+}
+
+__attribute__( ( target( "avx2" ) ) ) static size_t
+avx2_find_last( const int *data, const size_t n, const int value ) {
+    const __m256i needle = _mm256_set1_epi32( value );
+    size_t        i      = n;
+    while ( i >= 32 && !avx2_any32( data + i - 32, needle ) ) { i -= 32; }
+    for ( ; i >= 8; i -= 8 ) {
+        uint32_t mask = avx2_mask( data + i - 8, needle );
+        if ( mask ) { return i - 8 + (size_t)( 31 - __builtin_clz( mask ) ); }
+    }
+    size_t head = sse2_find_last( data, i, value );
+    return head == i ? n : head;
+}
+
+__attribute__( ( target( "avx2" ) ) ) static size_t
+avx2_count( const int *data, const size_t n, const int value ) {
+    const __m256i needle = _mm256_set1_epi32( value );
+    size_t        count  = 0;
+    size_t        i      = 0;
+    while ( i + 8 <= n ) {
+        size_t  stop = n - i > COUNT_BLOCK ? i + COUNT_BLOCK : n - 7;
+        __m256i acc  = _mm256_setzero_si256();
+        for ( ; i < stop; i += 8 ) {
+            __m256i eq = _mm256_cmpeq_epi32(
+                _mm256_loadu_si256( (const __m256i *)( data + i ) ), needle );
+            acc = _mm256_sub_epi32( acc, eq );
+        }
+        uint32_t lanes[8];
+        _mm256_storeu_si256( (__m256i *)lanes, acc );
+        for ( int l = 0; l < 8; l++ ) { count += lanes[l]; }
+    }
+    return count + sse2_count( data + i, n - i, value );
+}
+
+__attribute__( ( target( "avx2" ) ) ) static size_t
+avx2_find_all( const int *data, const size_t n, const int value, size_t *out,
+               const size_t max ) {
+    const __m256i needle = _mm256_set1_epi32( value );
+    size_t        count  = 0;
+    size_t        i      = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        count = emit_mask( avx2_mask( data + i, needle ), i, out, max, count );
+    }
+    for ( ; i < n; i++ ) {
+        if ( data[i] == value ) {
+            if ( count < max ) { out[count] = i; }
+            count++;
+        }
+    }
+    return count;
+}
+
+// lane indices that pack the kept lanes of a 4-lane block to the front,
+// indexed by the keep mask
+static const int32_t pack4[16][4] = {
+    { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 },
+    { 2, 0, 0, 0 }, { 0, 2, 0, 0 }, { 1, 2, 0, 0 }, { 0, 1, 2, 0 },
+    { 3, 0, 0, 0 }, { 0, 3, 0, 0 }, { 1, 3, 0, 0 }, { 0, 1, 3, 0 },
+    { 2, 3, 0, 0 }, { 0, 2, 3, 0 }, { 1, 2, 3, 0 }, { 0, 1, 2, 3 },
+};
+
+__attribute__( ( target( "avx2" ) ) ) static inline size_t
+avx2_pack4( int *out, const __m128 half, const uint32_t keep ) {
+    __m128i order = _mm_loadu_si128( (const __m128i *)pack4[keep] );
+    _mm_storeu_ps( (float *)out, _mm_permutevar_ps( half, order ) );
+    return (size_t)__builtin_popcount( keep );
+}
+
+// each 8-lane block is packed as two halves with a table-driven permute; a
+// full 4-lane store is safe since the output never runs ahead of the input
+__attribute__( ( target( "avx2" ) ) ) static size_t
+avx2_remove( int *data, const size_t n, const int value ) {
+    const __m256i needle = _mm256_set1_epi32( value );
+    size_t        kept   = 0;
+    size_t        i      = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        __m256  block = _mm256_loadu_ps( (const float *)( data + i ) );
+        __m256i eq    = _mm256_cmpeq_epi32( _mm256_castps_si256( block ),
+                                            needle );
+        uint32_t keep =
+            ~(uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( eq ) ) & 0xFF;
+        if ( keep == 0xFF ) {
+            _mm256_storeu_ps( (float *)( data + kept ), block );
+            kept += 8;
+            continue;
+        }
+        kept += avx2_pack4( data + kept, _mm256_castps256_ps128( block ),
+                            keep & 0xF );
+        kept += avx2_pack4( data + kept, _mm256_extractf128_ps( block, 1 ),
+                            keep >> 4 );
+    }
+    for ( ; i < n; i++ ) {
+        const int element = data[i];
+        data[kept]        = element;
+        kept += element != value;
+    }
+    return kept;
+}
+
+// each half is sign-extended to four 64-bit lanes, so no block can overflow
+__attribute__( ( target( "avx2" ) ) ) static int64_t
+avx2_sum( const int *data, const size_t n ) {
+    __m256i a = _mm256_setzero_si256();
+    __m256i b = _mm256_setzero_si256();
+    size_t  i = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        __m256i v = _mm256_loadu_si256( (const __m256i *)( data + i ) );
+        a         = _mm256_add_epi64(
+            a, _mm256_cvtepi32_epi64( _mm256_castsi256_si128( v ) ) );
+        b = _mm256_add_epi64(
+            b, _mm256_cvtepi32_epi64( _mm256_extracti128_si256( v, 1 ) ) );
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256( (__m256i *)lanes, _mm256_add_epi64( a, b ) );
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+           sse2_sum( data + i, n - i );
+}
+
+__attribute__( ( target( "avx2" ) ) ) static int
+avx2_min( const int *data, const size_t n ) {
+    __m256i lo = _mm256_set1_epi32( INT_MAX );
+    size_t  i  = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        lo = _mm256_min_epi32(
+            lo, _mm256_loadu_si256( (const __m256i *)( data + i ) ) );
+    }
+    int lanes[8];
+    _mm256_storeu_si256( (__m256i *)lanes, lo );
+    int min = sse2_min( data + i, n - i );
+    for ( int l = 0; l < 8; l++ ) { min = lanes[l] < min ? lanes[l] : min; }
+    return min;
+}
+
+__attribute__( ( target( "avx2" ) ) ) static int
+avx2_max( const int *data, const size_t n ) {
+    __m256i hi = _mm256_set1_epi32( INT_MIN );
+    size_t  i  = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        hi = _mm256_max_epi32(
+            hi, _mm256_loadu_si256( (const __m256i *)( data + i ) ) );
+    }
+    int lanes[8];
+    _mm256_storeu_si256( (__m256i *)lanes, hi );
+    int max = sse2_max( data + i, n - i );
+    for ( int l = 0; l < 8; l++ ) { max = lanes[l] > max ? lanes[l] : max; }
+    return max;
+}
+
+__attribute__( ( target( "avx2" ) ) ) static void
+avx2_minmax( const int *data, const size_t n, int *min, int *max ) {
+    __m256i lo = _mm256_set1_epi32( INT_MAX );
+    __m256i hi = _mm256_set1_epi32( INT_MIN );
+    size_t  i  = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        __m256i v = _mm256_loadu_si256( (const __m256i *)( data + i ) );
+        lo        = _mm256_min_epi32( lo, v );
+        hi        = _mm256_max_epi32( hi, v );
+    }
+    int lows[8], highs[8];
+    _mm256_storeu_si256( (__m256i *)lows, lo );
+    _mm256_storeu_si256( (__m256i *)highs, hi );
+    sse2_minmax( data + i, n - i, min, max );
+    for ( int l = 0; l < 8; l++ ) {
+        *min = lows[l] < *min ? lows[l] : *min;
+        *max = highs[l] > *max ? highs[l] : *max;
+    }
+}
+
+// as sse2_intersect with blocks of eight, rotated by a lane permute
+__attribute__( ( target( "avx2" ) ) ) static size_t
+avx2_intersect( const int *a, const size_t na, const int *b, const size_t nb,
+                int *out ) {
+    const __m256i rotate = _mm256_setr_epi32( 1, 2, 3, 4, 5, 6, 7, 0 );
+    size_t        i      = 0;
+    size_t        j      = 0;
+    size_t        count  = 0;
+    while ( i + 8 <= na && j + 8 <= nb ) {
+        const __m256i x  = _mm256_loadu_si256( (const __m256i *)( a + i ) );
+        __m256i       y  = _mm256_loadu_si256( (const __m256i *)( b + j ) );
+        __m256i       eq = _mm256_cmpeq_epi32( x, y );
+        for ( int r = 1; r < 8; r++ ) {
+            y  = _mm256_permutevar8x32_epi32( y, rotate );
+            eq = _mm256_or_si256( eq, _mm256_cmpeq_epi32( x, y ) );
+        }
+        uint32_t mask =
+            (uint32_t)_mm256_movemask_ps( _mm256_castsi256_ps( eq ) );
+        for ( ; mask; mask &= mask - 1 ) {
+            count = append_distinct( out, count,
+                                     a[i + (size_t)__builtin_ctz( mask )] );
+        }
+        const int a_max = a[i + 7];
+        const int b_max = b[j + 7];
+        i += a_max <= b_max ? 8 : 0;
+        j += b_max <= a_max ? 8 : 0;
+    }
+    return intersect_from( a, na, i, b, nb, j, out, count );
+}
+
+static const struct kernels avx2_kernels = {
+    .find      = avx2_find,
+    .find_last = avx2_find_last,
+    .count     = avx2_count,
+    .find_all  = avx2_find_all,
+    .remove    = avx2_remove,
+    .sum       = avx2_sum,
+    .min       = avx2_min,
+    .max       = avx2_max,
+    .minmax    = avx2_minmax,
+    .unpack128 = sse2_unpack128, // the format has four lanes
+    .intersect = avx2_intersect,
+};
+
+// ============================================================================
+// AVX-512 kernels: 16 lanes, masked loads handle the tail
+// ============================================================================
+
+__attribute__( ( target( "avx512f" ) ) ) static inline __mmask16
+avx512_tail( const size_t remaining ) {
+    return (__mmask16)( ( 1u << remaining ) - 1u );
+}
+
+__attribute__( ( target( "avx512f" ) ) ) static size_t
+avx512_find( const int *data, const size_t n, const int value ) {
+    const __m512i needle = _mm512_set1_epi32( value );
+    size_t        i      = 0;
+    for ( ; i + 64 <= n; i += 64 ) {
+        __mmask16 a = _mm512_cmpeq_epi32_mask(
+            _mm512_loadu_si512( data + i ), needle );
+        __mmask16 b = _mm512_cmpeq_epi32_mask(
+            _mm512_loadu_si512( data + i + 16 ), needle );
+        __mmask16 c = _mm512_cmpeq_epi32_mask(
+            _mm512_loadu_si512( data + i + 32 ), needle );
+        __mmask16 d = _mm512_cmpeq_epi32_mask(
+            _mm512_loadu_si512( data + i + 48 ), needle );
+        if ( a | b | c | d ) { break; }
+    }
+    for ( ; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        __mmask16 mask  = _mm512_mask_cmpeq_epi32_mask(
+            lanes, _mm512_maskz_loadu_epi32( lanes, data + i ), needle );
+        if ( mask ) { return i + (size_t)__builtin_ctz( mask ); }
+    }
+    return n;
+}
+
+__attribute__( ( target( "avx512f" ) ) ) static size_t
+avx512_find_last( const int *data, const size_t n, const int value ) {
+    const __m512i needle = _mm512_set1_epi32( value );
+    size_t        i      = n;
+    for ( ; i >= 16; i -= 16 ) {
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(
+            _mm512_loadu_si512( data + i - 16 ), needle );
+        if ( mask ) { return i - 16 + (size_t)( 31 - __builtin_clz( mask ) ); }
+    }
+    if ( i > 0 ) {
+        __mmask16 lanes = avx512_tail( i );
+        __mmask16 mask  = _mm512_mask_cmpeq_epi32_mask(
+            lanes, _mm512_maskz_loadu_epi32( lanes, data ), needle );
+        if ( mask ) { return (size_t)( 31 - __builtin_clz( mask ) ); }
+    }
+    return n;
+}
+
+__attribute__( ( target( "avx512f" ) ) ) static size_t
+avx512_count( const int *data, const size_t n, const int value ) {
+    const __m512i needle = _mm512_set1_epi32( value );
+    size_t        count  = 0;
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        __mmask16 mask  = _mm512_mask_cmpeq_epi32_mask(
+            lanes, _mm512_maskz_loadu_epi32( lanes, data + i ), needle );
+        count += (size_t)__builtin_popcount( mask );
+    }
+    return count;
+}
+
+__attribute__( ( target( "avx512f" ) ) ) static size_t
+avx512_find_all( const int *data, const size_t n, const int value,
+                 size_t *out, const size_t max ) {
+    const __m512i needle = _mm512_set1_epi32( value );
+    size_t        count  = 0;
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        __mmask16 mask  = _mm512_mask_cmpeq_epi32_mask(
+            lanes, _mm512_maskz_loadu_epi32( lanes, data + i ), needle );
+        count = emit_mask( mask, i, out, max, count );
+    }
+    return count;
+}
+
+// vpcompressd stores exactly the kept lanes, masked loads handle the tail
+__attribute__( ( target( "avx512f" ) ) ) static size_t
+avx512_remove( int *data, const size_t n, const int value ) {
+    const __m512i needle = _mm512_set1_epi32( value );
+    size_t        kept   = 0;
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        __m512i   block = _mm512_maskz_loadu_epi32( lanes, data + i );
+        __mmask16 keep  = _mm512_mask_cmpneq_epi32_mask( lanes, block, needle );
+        _mm512_mask_compressstoreu_epi32( data + kept, keep, block );
+        kept += (size_t)__builtin_popcount( keep );
+    }
+    return kept;
+}
+
+// masked-off tail lanes load as zero, which leaves the sum unchanged
+__attribute__( ( target( "avx512f" ) ) ) static int64_t
+avx512_sum( const int *data, const size_t n ) {
+    __m512i a = _mm512_setzero_si512();
+    __m512i b = _mm512_setzero_si512();
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        __m512i v = _mm512_maskz_loadu_epi32( lanes, data + i );
+        a         = _mm512_add_epi64(
+            a, _mm512_cvtepi32_epi64( _mm512_castsi512_si256( v ) ) );
+        b = _mm512_add_epi64(
+            b, _mm512_cvtepi32_epi64( _mm512_extracti64x4_epi64( v, 1 ) ) );
+    }
+    return _mm512_reduce_add_epi64( _mm512_add_epi64( a, b ) );
+}
+
+// for min and max the tail lanes are filled with the identity instead
+__attribute__( ( target( "avx512f" ) ) ) static int
+avx512_min( const int *data, const size_t n ) {
+    const __m512i identity = _mm512_set1_epi32( INT_MAX );
+    __m512i       lo       = identity;
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        lo = _mm512_min_epi32(
+            lo, _mm512_mask_loadu_epi32( identity, lanes, data + i ) );
+    }
+    return _mm512_reduce_min_epi32( lo );
+}
+
+__attribute__( ( target( "avx512f" ) ) ) static int
+avx512_max( const int *data, const size_t n ) {
+    const __m512i identity = _mm512_set1_epi32( INT_MIN );
+    __m512i       hi       = identity;
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        hi = _mm512_max_epi32(
+            hi, _mm512_mask_loadu_epi32( identity, lanes, data + i ) );
+    }
+    return _mm512_reduce_max_epi32( hi );
+}
+
+__attribute__( ( target( "avx512f" ) ) ) static void
+avx512_minmax( const int *data, const size_t n, int *min, int *max ) {
+    __m512i lo = _mm512_set1_epi32( INT_MAX );
+    __m512i hi = _mm512_set1_epi32( INT_MIN );
+    for ( size_t i = 0; i < n; i += 16 ) {
+        __mmask16 lanes =
+            n - i >= 16 ? (__mmask16)0xFFFF : avx512_tail( n - i );
+        // masked min/max keep the accumulator in the tail lanes
+        __m512i v = _mm512_maskz_loadu_epi32( lanes, data + i );
+        lo        = _mm512_mask_min_epi32( lo, lanes, lo, v );
+        hi        = _mm512_mask_max_epi32( hi, lanes, hi, v );
+    }
+    *min = _mm512_reduce_min_epi32( lo );
+    *max = _mm512_reduce_max_epi32( hi );
+}
+
+static const struct kernels avx512_kernels = {
+    .find      = avx512_find,
+    .find_last = avx512_find_last,
+    .count     = avx512_count,
+    .find_all  = avx512_find_all,
+    .remove    = avx512_remove,
+    .sum       = avx512_sum,
+    .min       = avx512_min,
+    .max       = avx512_max,
+    .minmax    = avx512_minmax,
+    .unpack128 = sse2_unpack128,
+    .intersect = avx2_intersect, // 16 lanes would need 15 rotations per step
+};
+
+#endif // SIMD_X86
+
+// ============================================================================
+// Runtime dispatch
+// ============================================================================
+
+static const struct kernels *const kernel_table[] = {
+    [DYNAMIC_ARRAY_SIMD_SCALAR] = &scalar_kernels,
+#if SIMD_X86
+    [DYNAMIC_ARRAY_SIMD_SSE2]   = &sse2_kernels,
+    [DYNAMIC_ARRAY_SIMD_AVX2]   = &avx2_kernels,
+    [DYNAMIC_ARRAY_SIMD_AVX512] = &avx512_kernels,
+#else
+    [DYNAMIC_ARRAY_SIMD_SSE2]   = &scalar_kernels,
+    [DYNAMIC_ARRAY_SIMD_AVX2]   = &scalar_kernels,
+    [DYNAMIC_ARRAY_SIMD_AVX512] = &scalar_kernels,
+#endif
+};
+
+// -1 until the first kernel call resolves it from CPUID
+static atomic_int active_level = -1;
+
+enum dynamic_array_simd_level dynamic_array_simd_detect( void ) {
+#if SIMD_X86
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx512f" ) ) {
+        return DYNAMIC_ARRAY_SIMD_AVX512;
+    }
+    if ( __builtin_cpu_supports( "avx2" ) ) { return DYNAMIC_ARRAY_SIMD_AVX2; }
+    if ( __builtin_cpu_supports( "sse2" ) ) { return DYNAMIC_ARRAY_SIMD_SSE2; }
+#endif
+    return DYNAMIC_ARRAY_SIMD_SCALAR;
+}
+
+enum dynamic_array_simd_level dynamic_array_simd_level( void ) {
+    int level = atomic_load_explicit( &active_level, memory_order_relaxed );
+    if ( level < 0 ) {
+        level = (int)dynamic_array_simd_detect();
+        atomic_store_explicit( &active_level, level, memory_order_relaxed );
+    }
+    return (enum dynamic_array_simd_level)level;
+}
+
+enum dynamic_array_simd_level
+dynamic_array_simd_set_level( const enum dynamic_array_simd_level level ) {
+    enum dynamic_array_simd_level best = dynamic_array_simd_detect();
+    enum dynamic_array_simd_level used = level < best ? level : best;
+    atomic_store_explicit( &active_level, (int)used, memory_order_relaxed );
+    return used;
+}
+
+const char *
+dynamic_array_simd_level_name( const enum dynamic_array_simd_level level ) {
+    switch ( level ) {
+        case DYNAMIC_ARRAY_SIMD_SCALAR: return "scalar";
+        case DYNAMIC_ARRAY_SIMD_SSE2: return "sse2";
+        case DYNAMIC_ARRAY_SIMD_AVX2: return "avx2";
+        case DYNAMIC_ARRAY_SIMD_AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+static inline const struct kernels *kernels( void ) {
+    return kernel_table[dynamic_array_simd_level()];
+}
+
+size_t dynamic_array_simd_find( const int *data, const size_t n,
+                                const int value ) {
+    assert( data != NULL || n == 0 );
+    return kernels()->find( data, n, value );
+}
+
+size_t dynamic_array_simd_find_last( const int *data, const size_t n,
+                                     const int value ) {
+    assert( data != NULL || n == 0 );
+    return kernels()->find_last( data, n, value );
+}
+
+size_t dynamic_array_simd_count( const int *data, const size_t n,
+                                 const int value ) {
+    assert( data != NULL || n == 0 );
+    return kernels()->count( data, n, value );
+}
+
+size_t dynamic_array_simd_find_all( const int *data, const size_t n,
+                                    const int value, size_t *out,
+                                    const size_t max ) {
+    assert( data != NULL || n == 0 );
+    assert( out != NULL || max == 0 );
+    return kernels()->find_all( data, n, value, out, max );
+}
+
+// the prefix before the first match is located with the search kernel and
+// left untouched, compaction starts there
+size_t dynamic_array_simd_remove( int *data, const size_t n, const int value ) {
+    assert( data != NULL || n == 0 );
+    const struct kernels *k     = kernels();
+    size_t                first = k->find( data, n, value );
+    if ( first == n ) { return n; }
+    return first + k->remove( data + first, n - first, value );
+}
+
+// time: O(N); 64-bit lanes, so 2^32 elements of INT_MAX still fit
+int64_t dynamic_array_simd_sum( const int *data, const size_t n ) {
+    assert( data != NULL || n == 0 );
+    return kernels()->sum( data, n );
+}
+
+int dynamic_array_simd_min( const int *data, const size_t n ) {
+    assert( data != NULL || n == 0 );
+    return kernels()->min( data, n );
+}
+
+int dynamic_array_simd_max( const int *data, const size_t n ) {
+    assert( data != NULL || n == 0 );
+    return kernels()->max( data, n );
+}
+
+void dynamic_array_simd_minmax( const int *data, const size_t n, int *min,
+                                int *max ) {
+    assert( data != NULL || n == 0 );
+    assert( min != NULL && max != NULL );
+    kernels()->minmax( data, n, min, max );
+}
+
+// two vectorized passes: the extreme value, then its first position
+size_t dynamic_array_simd_argmin( const int *data, const size_t n ) {
+    assert( data != NULL || n == 0 );
+    const struct kernels *k = kernels();
+    return n == 0 ? n : k->find( data, n, k->min( data, n ) );
+}
+
+size_t dynamic_array_simd_argmax( const int *data, const size_t n ) {
+    assert( data != NULL || n == 0 );
+    const struct kernels *k = kernels();
+    return n == 0 ? n : k->find( data, n, k->max( data, n ) );
+}
+
+void dynamic_array_simd_pack128( const int *values, const unsigned bits,
+                                 const int reference, const bool delta,
+                                 uint32_t *packed ) {
+    assert( values != NULL );
+    assert( bits <= 32 );
+    for ( unsigned i = 0; i < 4 * bits; i++ ) { packed[i] = 0; }
+    if ( bits == 0 ) { return; }
+    for ( unsigned i = 0; i < 128; i++ ) {
+        const unsigned lane   = i % 4;
+        const unsigned offset = ( i / 4 ) * bits;
+        const unsigned word   = offset / 32;
+        const unsigned shift  = offset % 32;
+        const uint32_t before =
+            delta && i >= 4 ? (uint32_t)values[i - 4] : (uint32_t)reference;
+        const uint32_t value = (uint32_t)values[i] - before;
+        assert( ( value & ~low_mask( bits ) ) == 0 );
+        packed[4 * word + lane] |= value << shift;
+        if ( shift + bits > 32 ) {
+            packed[4 * ( word + 1 ) + lane] |= value >> ( 32 - shift );
+        }
+    }
+}
+
+void dynamic_array_simd_unpack128( const uint32_t *packed, const unsigned bits,
+                                   const int reference, const bool delta,
+                                   int *out ) {
+    assert( packed != NULL || bits == 0 );
+    assert( bits <= 32 );
+    assert( out != NULL );
+    kernels()->unpack128( packed, bits, reference, delta, out );
+}
+
+// time: O(na + nb)
+size_t dynamic_array_simd_intersect( const int *a, const size_t na,
+                                     const int *b, const size_t nb,
+                                     int *out ) {
+    assert( a != NULL || na == 0 );
+    assert( b != NULL || nb == 0 );
+    assert( out != NULL || na == 0 || nb == 0 );
+    return kernels()->intersect( a, na, b, nb, out );
+}
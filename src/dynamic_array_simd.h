@@ -0,0 +1,130 @@
+#ifndef DYNAMIC_ARRAY_SIMD_H
+#define DYNAMIC_ARRAY_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Kernels are picked once at runtime from CPUID. Each level can be forced
+// (clamped to what the CPU supports) so results can be checked against the
+// scalar reference.
+enum dynamic_array_simd_level {
+    DYNAMIC_ARRAY_SIMD_SCALAR,
+    DYNAMIC_ARRAY_SIMD_SSE2,
+    DYNAMIC_ARRAY_SIMD_AVX2,
+    DYNAMIC_ARRAY_SIMD_AVX512,
+};
+
+extern enum dynamic_array_simd_level dynamic_array_simd_detect( void );
+extern enum dynamic_array_simd_level dynamic_array_simd_level( void );
+extern enum dynamic_array_simd_level
+dynamic_array_simd_set_level( const enum dynamic_array_simd_level level );
+extern const char *
+dynamic_array_simd_level_name( const enum dynamic_array_simd_level level );
+
+// All positions are returned as size_t; `n` means "not found".
+extern size_t dynamic_array_simd_find( const int *data, const size_t n,
+                                       const int value );
+extern size_t dynamic_array_simd_find_last( const int *data, const size_t n,
+                                            const int value );
+extern size_t dynamic_array_simd_count( const int *data, const size_t n,
+                                        const int value );
+// writes at most `max` indices, returns the total number of matches
+extern size_t dynamic_array_simd_find_all( const int *data, const size_t n,
+                                           const int value, size_t *out,
+                                           const size_t max );
+// removes every `value` in place keeping the order of the rest, returns the
+// new length
+extern size_t dynamic_array_simd_remove( int *data, const size_t n,
+                                         const int value );
+
+// Reductions. The sum is accumulated in 64 bits; an empty range has minimum
+// INT_MAX and maximum INT_MIN. argmin/argmax return the first position of
+// the extreme value, `n` for an empty range.
+extern int64_t dynamic_array_simd_sum( const int *data, const size_t n );
+extern int     dynamic_array_simd_min( const int *data, const size_t n );
+extern int     dynamic_array_simd_max( const int *data, const size_t n );
+extern void    dynamic_array_simd_minmax( const int *data, const size_t n,
+                                          int *min, int *max );
+extern size_t  dynamic_array_simd_argmin( const int *data, const size_t n );
+extern size_t  dynamic_array_simd_argmax( const int *data, const size_t n );
+
+// Bit packing of 128 values in four interleaved lanes: value i belongs to
+// lane i % 4, and each lane packs its 32 values at `bits` each (0 to 32) into
+// every fourth word, so `packed` holds 4 * bits words and one SSE register
+// decodes a row of four values. Values are stored relative to `reference`;
+// with `delta`, values from the fifth on are relative to the value four
+// positions back instead, and decoding is a running sum down each lane.
+// The relative values must fit in `bits` (as uint32_t, so wraparound is
+// fine).
+extern void dynamic_array_simd_pack128( const int *values, const unsigned bits,
+                                        const int reference, const bool delta,
+                                        uint32_t *packed );
+extern void dynamic_array_simd_unpack128( const uint32_t *packed,
+                                          const unsigned bits,
+                                          const int reference,
+                                          const bool delta, int *out );
+// One packed value: row `row` of the lane starting at `lane` (packed + i for
+// lane i), before reference and delta are applied; `bits` > 0. The scalar
+// unpack is built on it, and frozen arrays use it for random access.
+static inline uint32_t dynamic_array_simd_extract( const uint32_t *lane,
+                                                   const unsigned  bits,
+                                                   const unsigned  row ) {
+    const unsigned offset = row * bits;
+    const unsigned word   = offset / 32;
+    const unsigned shift  = offset % 32;
+    uint32_t       value  = lane[4 * word] >> shift;
+    if ( shift + bits > 32 ) {
+        value |= lane[4 * ( word + 1 )] << ( 32 - shift );
+    }
+    return bits == 32 ? value : value & ( ( (uint32_t)1 << bits ) - 1 );
+}
+
+// Binary searches over an ascending range: the first position whose element
+// is not below (lower) or is above (upper) value. Branchless, the halving
+// loop compiles to a conditional move, so there is no mispredicted branch per
+// level; inline because they sit in the find and set loops.
+static inline size_t dynamic_array_simd_lower_bound( const int   *data,
+                                                     const size_t n,
+                                                     const int    value ) {
+    if ( n == 0 ) { return 0; }
+    const int *base = data;
+    size_t     len  = n;
+    while ( len > 1 ) {
+        size_t half = len / 2;
+        base        = base[half] < value ? base + half : base;
+        len -= half;
+    }
+    return (size_t)( base - data ) + ( *base < value );
+}
+
+static inline size_t dynamic_array_simd_upper_bound( const int   *data,
+                                                     const size_t n,
+                                                     const int    value ) {
+    if ( n == 0 ) { return 0; }
+    const int *base = data;
+    size_t     len  = n;
+    while ( len > 1 ) {
+        size_t half = len / 2;
+        base        = base[half] <= value ? base + half : base;
+        len -= half;
+    }
+    return (size_t)( base - data ) + ( *base <= value );
+}
+
+// Intersection of two ascending ranges: writes the values present in both to
+// out, ascending and each once, and returns how many were written. out needs
+// room for the smaller range.
+extern size_t dynamic_array_simd_intersect( const int *a, const size_t na,
+                                            const int *b, const size_t nb,
+                                            int *out );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_SIMD_H
@@ -0,0 +1,66 @@
+#include "dynamic_array_stats.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+// the counters, indexed by enum dynamic_array_stat
+static atomic_uint_fast64_t counters[4];
+// bytes held by all buffers right now, and its high-water mark
+static atomic_uint_fast64_t live_capacity;
+static atomic_uint_fast64_t peak_capacity;
+static atomic_uint_fast64_t wasted_capacity;
+
+void dynamic_array_stats_count( const enum dynamic_array_stat stat,
+                                const uint64_t                n ) {
+    assert( (size_t)stat < sizeof counters / sizeof *counters );
+    atomic_fetch_add_explicit( &counters[stat], n, memory_order_relaxed );
+}
+
+// the gauges move by differences, so unsigned wraparound cancels out
+void dynamic_array_stats_capacity( const uint64_t old_bytes,
+                                   const uint64_t new_bytes,
+                                   const uint64_t old_wasted,
+                                   const uint64_t new_wasted ) {
+    uint64_t live = atomic_fetch_add_explicit( &live_capacity,
+                                               new_bytes - old_bytes,
+                                               memory_order_relaxed ) +
+                    ( new_bytes - old_bytes );
+    atomic_fetch_add_explicit( &wasted_capacity, new_wasted - old_wasted,
+                               memory_order_relaxed );
+    uint_fast64_t peak =
+        atomic_load_explicit( &peak_capacity, memory_order_relaxed );
+    while ( live > peak && !atomic_compare_exchange_weak_explicit(
+                               &peak_capacity, &peak, live,
+                               memory_order_relaxed, memory_order_relaxed ) ) {
+    }
+}
+
+static uint64_t load( const enum dynamic_array_stat stat ) {
+    return atomic_load_explicit( &counters[stat], memory_order_relaxed );
+}
+
+void dynamic_array_stats_global( struct dynamic_array_stats *out ) {
+    assert( out != NULL );
+    *out = ( struct dynamic_array_stats ){
+        .reallocs      = load( DYNAMIC_ARRAY_STAT_REALLOCS ),
+        .bytes_copied  = load( DYNAMIC_ARRAY_STAT_BYTES_COPIED ),
+        .shifts        = load( DYNAMIC_ARRAY_STAT_SHIFTS ),
+        .comparisons   = load( DYNAMIC_ARRAY_STAT_COMPARISONS ),
+        .peak_capacity =
+            atomic_load_explicit( &peak_capacity, memory_order_relaxed ),
+        .wasted_capacity =
+            atomic_load_explicit( &wasted_capacity, memory_order_relaxed ),
+    };
+}
+
+// the peak restarts from the current live bytes
+void dynamic_array_stats_global_reset( void ) {
+    for ( size_t i = 0; i < sizeof counters / sizeof *counters; i++ ) {
+        atomic_store_explicit( &counters[i], 0, memory_order_relaxed );
+    }
+    atomic_store_explicit(
+        &peak_capacity,
+        atomic_load_explicit( &live_capacity, memory_order_relaxed ),
+        memory_order_relaxed );
+}
@@ -0,0 +1,84 @@
+#ifndef DYNAMIC_ARRAY_STATS_H
+#define DYNAMIC_ARRAY_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Hot-path counters, compiled in with -DDYNAMIC_ARRAY_STATS=1. The flag
+// changes the layout of every array, so all translation units must agree on
+// it. Without it the counting macro expands to nothing and the snapshot
+// functions report zeros, so callers need no #if of their own.
+#ifndef DYNAMIC_ARRAY_STATS
+#define DYNAMIC_ARRAY_STATS 0
+#endif
+
+// The first four fields are running counters cleared by a reset; the last two
+// are gauges and survive it.
+struct dynamic_array_stats {
+    uint64_t reallocs;     // buffer allocations and reallocations
+    uint64_t bytes_copied; // element bytes carried over by reallocations
+    uint64_t shifts;       // elements moved by insert and remove
+    uint64_t comparisons;  // elements compared by searches
+    // bytes: largest capacity of the array; globally, the high-water mark of
+    // all buffers together
+    uint64_t peak_capacity;
+    // bytes of capacity holding no element: for one array at the time of the
+    // snapshot; globally, summed over arrays as of their last reallocation
+    uint64_t wasted_capacity;
+};
+
+// what an array carries: the counters are relaxed atomics so that searches
+// on a const array shared by several threads count without racing; the
+// gauges change only with the buffer, under the writer
+struct dynamic_array_counters {
+    atomic_uint_fast64_t reallocs;
+    atomic_uint_fast64_t bytes_copied;
+    atomic_uint_fast64_t shifts;
+    atomic_uint_fast64_t comparisons;
+    uint64_t             peak_capacity;
+    uint64_t             wasted_capacity;
+};
+
+enum dynamic_array_stat {
+    DYNAMIC_ARRAY_STAT_REALLOCS,
+    DYNAMIC_ARRAY_STAT_BYTES_COPIED,
+    DYNAMIC_ARRAY_STAT_SHIFTS,
+    DYNAMIC_ARRAY_STAT_COMPARISONS,
+};
+
+// process-wide totals over every array and instantiation; thread-safe
+extern void dynamic_array_stats_global( struct dynamic_array_stats *out );
+extern void dynamic_array_stats_global_reset( void );
+
+// used by the templates
+extern void dynamic_array_stats_count( const enum dynamic_array_stat stat,
+                                       const uint64_t                n );
+extern void dynamic_array_stats_capacity( const uint64_t old_bytes,
+                                          const uint64_t new_bytes,
+                                          const uint64_t old_wasted,
+                                          const uint64_t new_wasted );
+
+// adds n to `field` of an array's counters and to the global counter `stat`;
+// arrays passed as const are still counted
+#if DYNAMIC_ARRAY_STATS
+#define DYNAMIC_ARRAY_COUNT( da, field, stat, n )                              \
+    do {                                                                       \
+        const uint64_t count_ = (uint64_t)( n );                               \
+        atomic_fetch_add_explicit(                                             \
+            &( (struct dynamic_array_counters *)&( da )->stats )->field,       \
+            count_, memory_order_relaxed );                                    \
+        dynamic_array_stats_count( stat, count_ );                             \
+    } while ( 0 )
+#else
+#define DYNAMIC_ARRAY_COUNT( da, field, stat, n ) ( (void)0 )
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_STATS_H
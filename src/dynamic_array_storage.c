@@ -0,0 +1,451 @@
+// mremap and MAP_ANONYMOUS are extensions on top of POSIX
+#define _GNU_SOURCE
+
+#include "dynamic_array_storage.h"
+
+#include "dynamic_array_allocator.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#define HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define HAVE_MMAP 0
+#endif
+
+const struct dynamic_array_growth dynamic_array_growth_default = {
+    .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+    .increment      = 0,
+    .callback       = NULL,
+    .context        = NULL,
+    .mmap_threshold = 0,
+    .shrink_divisor = 0,
+};
+
+// ============================================================================
+// Growth policies
+// ============================================================================
+
+size_t dynamic_array_growth_next( const struct dynamic_array_growth *growth,
+                                  const size_t                       capacity,
+                                  const size_t min_capacity,
+                                  const size_t initial_capacity ) {
+    assert( growth != NULL );
+    size_t next = capacity ? capacity : initial_capacity;
+    switch ( growth->kind ) {
+        case DYNAMIC_ARRAY_GROWTH_DOUBLE:
+            while ( next < min_capacity ) {
+                assert( next <= SIZE_MAX / 2 );
+                next <<= 1;
+            }
+            break;
+        case DYNAMIC_ARRAY_GROWTH_ONE_AND_HALF:
+            while ( next < min_capacity ) {
+                assert( next <= SIZE_MAX / 3 * 2 );
+                next += next > 1 ? next >> 1 : 1;
+            }
+            break;
+        case DYNAMIC_ARRAY_GROWTH_FIXED:
+            assert( growth->increment > 0 );
+            assert( capacity <= SIZE_MAX - growth->increment );
+            next = capacity + growth->increment;
+            if ( next < min_capacity ) { next = min_capacity; }
+            break;
+        case DYNAMIC_ARRAY_GROWTH_CALLBACK:
+            assert( growth->callback != NULL );
+            next = growth->callback( growth->context, capacity, min_capacity );
+            break;
+    }
+    assert( next >= min_capacity );
+    return next;
+}
+
+// ============================================================================
+// Anonymous mappings
+// ============================================================================
+
+#if HAVE_MMAP
+
+static size_t page_round( const size_t bytes ) {
+    const size_t page = (size_t)sysconf( _SC_PAGESIZE );
+    assert( bytes <= SIZE_MAX - page );
+    return ( bytes + page - 1 ) / page * page;
+}
+
+bool dynamic_array_map_supported( void ) { return true; }
+
+void *dynamic_array_map_alloc( size_t *bytes ) {
+    *bytes    = page_round( *bytes );
+    void *ptr = mmap( NULL, *bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+void *dynamic_array_map_resize( void *ptr, const size_t old_bytes,
+                                size_t *bytes ) {
+    const size_t mapped = page_round( old_bytes );
+    *bytes              = page_round( *bytes );
+    if ( *bytes == mapped ) { return ptr; }
+#ifdef __linux__
+    // the kernel moves page table entries, the data itself is never copied
+    void *moved = mremap( ptr, mapped, *bytes, MREMAP_MAYMOVE );
+    return moved == MAP_FAILED ? NULL : moved;
+#else
+    size_t new_bytes = *bytes;
+    void  *moved     = dynamic_array_map_alloc( &new_bytes );
+    if ( moved == NULL ) { return NULL; }
+    memcpy( moved, ptr, mapped < new_bytes ? mapped : new_bytes );
+    munmap( ptr, mapped );
+    return moved;
+#endif
+}
+
+void dynamic_array_map_free( void *ptr, const size_t bytes ) {
+    if ( ptr != NULL ) { munmap( ptr, page_round( bytes ) ); }
+}
+
+// MADV_DONTNEED drops private anonymous pages at once, where MADV_FREE
+// would leave them counted as resident until the kernel needs the memory
+void dynamic_array_map_discard( void *ptr, const size_t from,
+                                const size_t bytes ) {
+    const size_t page  = (size_t)sysconf( _SC_PAGESIZE );
+    const size_t first = page_round( from );
+    const size_t last  = bytes / page * page;
+    if ( first < last ) {
+        (void)madvise( (char *)ptr + first, last - first, MADV_DONTNEED );
+    }
+}
+
+#else
+
+bool dynamic_array_map_supported( void ) { return false; }
+
+void *dynamic_array_map_alloc( size_t *bytes ) {
+    (void)bytes;
+    return NULL;
+}
+
+void *dynamic_array_map_resize( void *ptr, const size_t old_bytes,
+                                size_t *bytes ) {
+    (void)ptr;
+    (void)old_bytes;
+    (void)bytes;
+    return NULL;
+}
+
+void dynamic_array_map_free( void *ptr, const size_t bytes ) {
+    (void)ptr;
+    (void)bytes;
+}
+
+void dynamic_array_map_discard( void *ptr, const size_t from,
+                                const size_t bytes ) {
+    (void)ptr;
+    (void)from;
+    (void)bytes;
+}
+
+#endif // HAVE_MMAP
+
+// ============================================================================
+// Shared buffers
+// ============================================================================
+
+struct dynamic_array_share {
+    atomic_size_t                         references;
+    const struct dynamic_array_allocator *allocator;
+};
+
+struct dynamic_array_share *
+dynamic_array_share_create( const struct dynamic_array_allocator *allocator ) {
+    assert( allocator != NULL );
+    struct dynamic_array_share *share =
+        allocator->alloc( allocator->context, sizeof *share );
+    if ( share == NULL ) { return NULL; }
+    atomic_init( &share->references, 2 );
+    share->allocator = allocator;
+    return share;
+}
+
+// a new holder is always made from an existing one, so relaxed suffices
+void dynamic_array_share_acquire( struct dynamic_array_share *share ) {
+    assert( share != NULL );
+    atomic_fetch_add_explicit( &share->references, 1, memory_order_relaxed );
+}
+
+// acq_rel orders every holder's reads of the buffer before the last one
+// frees or reuses it
+bool dynamic_array_share_release( struct dynamic_array_share *share ) {
+    assert( share != NULL );
+    if ( atomic_fetch_sub_explicit( &share->references, 1,
+                                    memory_order_acq_rel ) != 1 ) {
+        return false;
+    }
+    share->allocator->free( share->allocator->context, share, sizeof *share );
+    return true;
+}
+
+bool dynamic_array_share_unique( const struct dynamic_array_share *share ) {
+    assert( share != NULL );
+    return atomic_load_explicit( &share->references, memory_order_acquire ) ==
+           1;
+}
+
+// ============================================================================
+// File-backed storage
+// ============================================================================
+
+#define HEADER_SIZE sizeof( struct dynamic_array_file_header )
+
+static_assert( sizeof( struct dynamic_array_file_header ) == 64,
+               "the element data starts at offset 64" );
+
+struct dynamic_array_file {
+    struct dynamic_array_file_header *header; // start of the mapping
+    size_t                            bytes;  // mapped length
+    int                               fd;     // -1 unless shared
+    enum dynamic_array_file_mode      mode;
+};
+
+enum dynamic_array_file_mode
+dynamic_array_file_mode( const struct dynamic_array_file *file ) {
+    assert( file != NULL );
+    return file->mode;
+}
+
+void *dynamic_array_file_data( const struct dynamic_array_file *file ) {
+    assert( file != NULL );
+    return (char *)file->header + HEADER_SIZE;
+}
+
+const struct dynamic_array_file_header *
+dynamic_array_file_header( const struct dynamic_array_file *file ) {
+    assert( file != NULL );
+    return file->header;
+}
+
+#if HAVE_MMAP
+
+// the mapping length for `capacity` elements, and the capacity that length
+// really holds
+static size_t file_bytes( const size_t element_size, size_t *capacity ) {
+    assert( *capacity <= ( SIZE_MAX - HEADER_SIZE ) / element_size );
+    size_t bytes = page_round( HEADER_SIZE + element_size * *capacity );
+    *capacity    = ( bytes - HEADER_SIZE ) / element_size;
+    return bytes;
+}
+
+struct dynamic_array_file *
+dynamic_array_file_create( const char *path, const size_t element_size,
+                           const size_t capacity ) {
+    assert( path != NULL );
+    assert( element_size > 0 && element_size <= UINT32_MAX );
+    struct dynamic_array_file *file = malloc( sizeof *file );
+    if ( file == NULL ) { return NULL; }
+    file->mode = DYNAMIC_ARRAY_FILE_SHARED;
+    file->fd   = open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+    if ( file->fd < 0 ) {
+        free( file );
+        return NULL;
+    }
+    size_t elements = capacity;
+    file->bytes     = file_bytes( element_size, &elements );
+    void *ptr       = MAP_FAILED;
+    if ( ftruncate( file->fd, (off_t)file->bytes ) == 0 ) {
+        ptr = mmap( NULL, file->bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    file->fd, 0 );
+    }
+    if ( ptr == MAP_FAILED ) {
+        int error = errno;
+        close( file->fd );
+        free( file );
+        errno = error;
+        return NULL;
+    }
+    file->header = ptr;
+    *file->header = ( struct dynamic_array_file_header ){
+        .version      = DYNAMIC_ARRAY_FILE_VERSION,
+        .element_size = (uint32_t)element_size,
+        .size         = 0,
+        .capacity     = elements,
+    };
+    memcpy( file->header->magic, DYNAMIC_ARRAY_FILE_MAGIC,
+            sizeof file->header->magic );
+    return file;
+}
+
+static bool header_valid( const struct dynamic_array_file_header *header,
+                          const size_t element_size, const size_t bytes ) {
+    return memcmp( header->magic, DYNAMIC_ARRAY_FILE_MAGIC,
+                   sizeof header->magic ) == 0 &&
+           header->version == DYNAMIC_ARRAY_FILE_VERSION &&
+           header->element_size == element_size &&
+           header->size <= header->capacity &&
+           header->capacity <= ( bytes - HEADER_SIZE ) / element_size;
+}
+
+struct dynamic_array_file *
+dynamic_array_file_open( const char *path, const size_t element_size,
+                         const enum dynamic_array_file_mode mode ) {
+    assert( path != NULL );
+    assert( element_size > 0 );
+    const bool shared = mode == DYNAMIC_ARRAY_FILE_SHARED;
+    int        fd     = open( path, shared ? O_RDWR : O_RDONLY );
+    if ( fd < 0 ) { return NULL; }
+
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 ) {
+        int error = errno;
+        close( fd );
+        errno = error;
+        return NULL;
+    }
+    if ( (size_t)st.st_size < HEADER_SIZE ) {
+        close( fd );
+        errno = EINVAL;
+        return NULL;
+    }
+
+    const size_t bytes = (size_t)st.st_size;
+    const int    prot  = mode == DYNAMIC_ARRAY_FILE_READ_ONLY
+                             ? PROT_READ
+                             : PROT_READ | PROT_WRITE;
+    void *ptr = mmap( NULL, bytes, prot, shared ? MAP_SHARED : MAP_PRIVATE, fd,
+                      0 );
+    int   error = errno;
+    // a private or read-only mapping outlives its descriptor
+    if ( !shared || ptr == MAP_FAILED ) { close( fd ); }
+    if ( ptr == MAP_FAILED ) {
+        errno = error;
+        return NULL;
+    }
+    if ( !header_valid( ptr, element_size, bytes ) ) {
+        munmap( ptr, bytes );
+        if ( shared ) { close( fd ); }
+        errno = EINVAL;
+        return NULL;
+    }
+
+    struct dynamic_array_file *file = malloc( sizeof *file );
+    if ( file == NULL ) {
+        munmap( ptr, bytes );
+        if ( shared ) { close( fd ); }
+        return NULL;
+    }
+    file->header = ptr;
+    file->bytes  = bytes;
+    file->fd     = shared ? fd : -1;
+    file->mode   = mode;
+    return file;
+}
+
+void *dynamic_array_file_resize( struct dynamic_array_file *file,
+                                 size_t                    *capacity ) {
+    assert( file != NULL );
+    assert( file->mode == DYNAMIC_ARRAY_FILE_SHARED );
+    const size_t element_size = file->header->element_size;
+    const size_t bytes        = file_bytes( element_size, capacity );
+    if ( bytes != file->bytes ) {
+        // growing extends the file before the mapping, shrinking after
+        if ( bytes > file->bytes && ftruncate( file->fd, (off_t)bytes ) != 0 ) {
+            return NULL;
+        }
+#ifdef __linux__
+        void *ptr = mremap( file->header, file->bytes, bytes, MREMAP_MAYMOVE );
+        if ( ptr == MAP_FAILED ) { return NULL; }
+#else
+        // the old mapping stays in place until the new one exists, so a
+        // failure leaves the array on it
+        void *ptr = mmap( NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          file->fd, 0 );
+        if ( ptr == MAP_FAILED ) { return NULL; }
+        munmap( file->header, file->bytes );
+#endif
+        // a failed shrink only leaves unused bytes at the end of the file,
+        // past the smaller capacity the header records; kept in a variable
+        // since a (void) cast does not silence warn_unused_result
+        const int trimmed =
+            bytes < file->bytes ? ftruncate( file->fd, (off_t)bytes ) : 0;
+        (void)trimmed;
+        file->header = ptr;
+        file->bytes  = bytes;
+    }
+    file->header->capacity = *capacity;
+    return dynamic_array_file_data( file );
+}
+
+bool dynamic_array_file_sync( struct dynamic_array_file *file,
+                              const size_t size, const unsigned flags ) {
+    assert( file != NULL );
+    if ( file->mode != DYNAMIC_ARRAY_FILE_SHARED ) { return true; }
+    file->header->size  = size;
+    file->header->flags = flags & DYNAMIC_ARRAY_FLAG_SORTED;
+    return msync( file->header, file->bytes, MS_SYNC ) == 0;
+}
+
+void dynamic_array_file_close( struct dynamic_array_file *file,
+                               const size_t size, const unsigned flags ) {
+    if ( file == NULL ) { return; }
+    if ( file->mode == DYNAMIC_ARRAY_FILE_SHARED ) {
+        file->header->size  = size;
+        file->header->flags = flags & DYNAMIC_ARRAY_FLAG_SORTED;
+    }
+    munmap( file->header, file->bytes );
+    if ( file->fd >= 0 ) { close( file->fd ); }
+    free( file );
+}
+
+#else
+
+struct dynamic_array_file *
+dynamic_array_file_create( const char *path, const size_t element_size,
+                           const size_t capacity ) {
+    (void)path;
+    (void)element_size;
+    (void)capacity;
+    errno = ENOSYS;
+    return NULL;
+}
+
+struct dynamic_array_file *
+dynamic_array_file_open( const char *path, const size_t element_size,
+                         const enum dynamic_array_file_mode mode ) {
+    (void)path;
+    (void)element_size;
+    (void)mode;
+    errno = ENOSYS;
+    return NULL;
+}
+
+void *dynamic_array_file_resize( struct dynamic_array_file *file,
+                                 size_t                    *capacity ) {
+    (void)file;
+    (void)capacity;
+    return NULL;
+}
+
+bool dynamic_array_file_sync( struct dynamic_array_file *file,
+                              const size_t size, const unsigned flags ) {
+    (void)file;
+    (void)size;
+    (void)flags;
+    return false;
+}
+
+void dynamic_array_file_close( struct dynamic_array_file *file,
+                               const size_t size, const unsigned flags ) {
+    (void)file;
+    (void)size;
+    (void)flags;
+}
+
+#endif // HAVE_MMAP
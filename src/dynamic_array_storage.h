@@ -0,0 +1,154 @@
+#ifndef DYNAMIC_ARRAY_STORAGE_H
+#define DYNAMIC_ARRAY_STORAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bits of the `flags` field shared by every instantiation.
+enum {
+    // buffer is an anonymous mapping owned by the array, not by its allocator
+    DYNAMIC_ARRAY_FLAG_MAPPED = 1u << 0,
+    // elements are known to be in ascending order; set by the int sort and
+    // cleared by every operation that can break the order
+    DYNAMIC_ARRAY_FLAG_SORTED = 1u << 1,
+    // buffer lives in a mapped file (the array's `file` field)
+    DYNAMIC_ARRAY_FLAG_FILE = 1u << 2,
+    // the hash index (see dynamic_array_index.h) matches the elements;
+    // cleared by every change it does not follow
+    DYNAMIC_ARRAY_FLAG_INDEXED = 1u << 3,
+    // the growth policy has a shrink_divisor, so pop tests a bit instead of
+    // loading the policy; set by set_growth
+    DYNAMIC_ARRAY_FLAG_SHRINK = 1u << 4,
+};
+
+enum dynamic_array_growth_kind {
+    DYNAMIC_ARRAY_GROWTH_DOUBLE,
+    DYNAMIC_ARRAY_GROWTH_ONE_AND_HALF,
+    DYNAMIC_ARRAY_GROWTH_FIXED,
+    DYNAMIC_ARRAY_GROWTH_CALLBACK,
+};
+
+// Per-array growth policy. `increment` is in elements and only used by
+// DYNAMIC_ARRAY_GROWTH_FIXED; `callback` must return at least `min_capacity`.
+// Once a buffer reaches `mmap_threshold` bytes (0 disables it) it moves to
+// an anonymous mapping and grows with mremap, which remaps pages instead of
+// copying them.
+// Shrinking is opt-in: once pop or a removal leaves fewer than
+// capacity / `shrink_divisor` elements (0 disables it; it must be at least
+// 3, 4 is typical) the capacity halves until that no longer holds. A shrunk
+// buffer is under half full, so a push/pop pair at the boundary never
+// reallocates. Mapped buffers stop at `mmap_threshold` and give the pages
+// past the elements back with madvise; shared and file-backed buffers are
+// not shrunk.
+struct dynamic_array_growth {
+    enum dynamic_array_growth_kind kind;
+    size_t                         increment;
+    size_t ( *callback )( void *context, const size_t capacity,
+                          const size_t min_capacity );
+    void  *context;
+    size_t mmap_threshold;
+    size_t shrink_divisor;
+};
+
+// doubling, no mapping: the policy every array starts with
+extern const struct dynamic_array_growth dynamic_array_growth_default;
+
+// first capacity of at least `min_capacity` reachable from `capacity`
+extern size_t
+dynamic_array_growth_next( const struct dynamic_array_growth *growth,
+                           const size_t capacity, const size_t min_capacity,
+                           const size_t initial_capacity );
+
+// Anonymous mappings for the mmap growth mode. Sizes are rounded up to whole
+// pages; the usable size is returned through `bytes`.
+extern bool  dynamic_array_map_supported( void );
+extern void *dynamic_array_map_alloc( size_t *bytes );
+extern void *dynamic_array_map_resize( void *ptr, const size_t old_bytes,
+                                       size_t *bytes );
+extern void  dynamic_array_map_free( void *ptr, const size_t bytes );
+// returns the whole pages of [from, bytes) to the kernel, keeping the
+// mapping; they read as zeros when touched again
+extern void  dynamic_array_map_discard( void *ptr, const size_t from,
+                                        const size_t bytes );
+
+// Reference count of a buffer shared by copy-on-write clones. It lives in
+// its own allocation from the array's allocator, so heap and mapped buffers
+// can both be shared; each holder keeps a pointer to it.
+struct dynamic_array_allocator;
+struct dynamic_array_share;
+
+// starts at 2, the array and its first clone; NULL when out of memory
+extern struct dynamic_array_share *
+dynamic_array_share_create( const struct dynamic_array_allocator *allocator );
+extern void dynamic_array_share_acquire( struct dynamic_array_share *share );
+// drops one reference; true when it was the last, the count is then freed
+// and the caller owns the buffer again
+extern bool dynamic_array_share_release( struct dynamic_array_share *share );
+// true when the caller holds the only reference
+extern bool
+dynamic_array_share_unique( const struct dynamic_array_share *share );
+
+// File-backed storage: the file is a 64-byte header followed by the raw
+// elements, and the whole file is mapped so the elements are used in place.
+// Files are only portable between builds with the same element layout and
+// byte order.
+#define DYNAMIC_ARRAY_FILE_MAGIC   "DYNARRAY"
+#define DYNAMIC_ARRAY_FILE_VERSION 1u
+
+struct dynamic_array_file_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t size;     // written by sync and close, not by every push
+    uint64_t capacity; // elements that fit in the file after the header
+    uint32_t flags;    // DYNAMIC_ARRAY_FLAG_SORTED is persisted
+    uint8_t  reserved[28];
+};
+
+enum dynamic_array_file_mode {
+    // PROT_READ mapping; writing to the array faults, growing it asserts
+    DYNAMIC_ARRAY_FILE_READ_ONLY,
+    // copy-on-write: changes stay in this process and the file is untouched;
+    // growing copies the elements to the allocator and lets go of the file
+    DYNAMIC_ARRAY_FILE_PRIVATE,
+    // changes go to the file, growth extends it with ftruncate + mremap
+    DYNAMIC_ARRAY_FILE_SHARED,
+};
+
+struct dynamic_array_file;
+
+// Both return NULL with errno set on failure; EINVAL means the file is not an
+// array of `element_size` elements. create truncates an existing file.
+extern struct dynamic_array_file *
+dynamic_array_file_create( const char *path, const size_t element_size,
+                           const size_t capacity );
+extern struct dynamic_array_file *
+dynamic_array_file_open( const char *path, const size_t element_size,
+                         const enum dynamic_array_file_mode mode );
+extern enum dynamic_array_file_mode
+dynamic_array_file_mode( const struct dynamic_array_file *file );
+extern void *dynamic_array_file_data( const struct dynamic_array_file *file );
+extern const struct dynamic_array_file_header *
+dynamic_array_file_header( const struct dynamic_array_file *file );
+// shared files only; grows or shrinks the file to at least `capacity`
+// elements (page rounded, updated in place), returns the new data pointer
+// or NULL
+extern void *dynamic_array_file_resize( struct dynamic_array_file *file,
+                                        size_t                    *capacity );
+// stores size and flags in the header and flushes a shared file to disk
+extern bool dynamic_array_file_sync( struct dynamic_array_file *file,
+                                     const size_t size, const unsigned flags );
+// stores size and flags (shared files), unmaps and closes the file
+extern void dynamic_array_file_close( struct dynamic_array_file *file,
+                                      const size_t size, const unsigned flags );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_STORAGE_H
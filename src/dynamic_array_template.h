@@ -0,0 +1,1288 @@
+// Type-generic dynamic array template.
+//
+// Include this file with DYNAMIC_ARRAY_NAME and DYNAMIC_ARRAY_TYPE defined to
+// generate `struct NAME` holding `TYPE *buffer` and the NAME_* functions.
+// Every function is specialized for TYPE, so element sizes and copies are
+// compile-time constants. The file may be included any number of times; the
+// parameters are undefined again at the end.
+//
+// Modes:
+//   (default)                     struct definition and extern prototypes,
+//                                 for a public header
+//   DYNAMIC_ARRAY_IMPLEMENTATION  function definitions only, for exactly one
+//                                 .c file that already saw the declarations
+//   DYNAMIC_ARRAY_STATIC          struct definition and static functions,
+//                                 for an array private to one .c file
+//
+// Optional parameters:
+//   DYNAMIC_ARRAY_EQUAL(a, b)     equality used by find/find_last/count/
+//                                 remove_value, defaults to ((a) == (b));
+//                                 define it for struct element types
+//   DYNAMIC_ARRAY_CUSTOM_SEARCH   do not generate find/find_last/count/
+//                                 remove_value, the instantiation provides
+//                                 its own
+//   DYNAMIC_ARRAY_INLINE_CAPACITY number of elements stored inside the struct
+//                                 itself (default 0). Arrays start on this
+//                                 inline region without allocating and only
+//                                 move to the allocator once it overflows.
+//                                 Such arrays must not be copied by value.
+//   DYNAMIC_ARRAY_HASH_INDEX      add the `index` field and keep it current in
+//                                 push/pop/set (int elements only, see
+//                                 dynamic_array_index.h)
+//
+// clone shares the buffer with the new array; the first write to either
+// side copies it (copy-on-write), so a clone is a cheap consistent snapshot.
+//
+// With -DDYNAMIC_ARRAY_STATS=1 every array also carries a
+// struct dynamic_array_counters, read through dynamic_array_stats (see
+// dynamic_array_stats.h).
+//
+// Example:
+//   #define DYNAMIC_ARRAY_NAME u8_array
+//   #define DYNAMIC_ARRAY_TYPE uint8_t
+//   #define DYNAMIC_ARRAY_STATIC
+//   #include "dynamic_array_template.h"
+//
+//   struct u8_array *flags = u8_array_create();
+//   u8_array_push( flags, 1 );
+
+#include "dynamic_array_common.h"
+
+#if !defined( DYNAMIC_ARRAY_NAME ) || !defined( DYNAMIC_ARRAY_TYPE )
+#error "DYNAMIC_ARRAY_NAME and DYNAMIC_ARRAY_TYPE must be defined"
+#endif
+
+#if defined( DYNAMIC_ARRAY_STATIC )
+#define DA_DECLARE 1
+#define DA_DEFINE  1
+#define DA_API     [[maybe_unused]] static
+#elif defined( DYNAMIC_ARRAY_IMPLEMENTATION )
+#define DA_DECLARE 0
+#define DA_DEFINE  1
+#define DA_API
+#else
+#define DA_DECLARE 1
+#define DA_DEFINE  0
+#define DA_API     extern
+#endif
+
+#ifndef DYNAMIC_ARRAY_EQUAL
+#define DYNAMIC_ARRAY_EQUAL( a, b ) ( ( a ) == ( b ) )
+#endif
+
+#ifndef DYNAMIC_ARRAY_INLINE_CAPACITY
+#define DYNAMIC_ARRAY_INLINE_CAPACITY 0
+#endif
+
+#ifndef DYNAMIC_ARRAY_HASH_INDEX
+#define DYNAMIC_ARRAY_HASH_INDEX 0
+#endif
+
+#define DA_T       DYNAMIC_ARRAY_TYPE
+#define DA_ARRAY   struct DYNAMIC_ARRAY_NAME
+#define DA_FN( x ) DYNAMIC_ARRAY_CONCAT( DYNAMIC_ARRAY_NAME, _##x )
+
+#if DA_DECLARE
+
+#include <assert.h>
+
+DA_ARRAY {
+    DA_T                                 *buffer;
+    size_t                                size;
+    size_t                                capacity;
+    const struct dynamic_array_allocator *allocator;
+    const struct dynamic_array_allocator *header_allocator;
+    const struct dynamic_array_growth    *growth;
+    struct dynamic_array_file            *file;
+    struct dynamic_array_share           *share; // NULL unless cloned
+    unsigned                              flags;
+#if DYNAMIC_ARRAY_STATS
+    struct dynamic_array_counters stats;
+#endif
+#if DYNAMIC_ARRAY_HASH_INDEX
+    struct dynamic_array_index *index; // NULL unless enabled
+#endif
+#if DYNAMIC_ARRAY_INLINE_CAPACITY > 0
+    DA_T inline_buffer[DYNAMIC_ARRAY_INLINE_CAPACITY];
+#endif
+};
+
+DA_API DA_ARRAY *DA_FN( create )( void );
+DA_API DA_ARRAY *
+DA_FN( create_with )( const struct dynamic_array_allocator *header_allocator,
+                      const struct dynamic_array_allocator *allocator );
+DA_API void DA_FN( init )( DA_ARRAY *da );
+DA_API void
+DA_FN( init_with )( DA_ARRAY                             *da,
+                    const struct dynamic_array_allocator *allocator );
+DA_API void
+DA_FN( set_growth )( DA_ARRAY *da, const struct dynamic_array_growth *growth );
+DA_API DA_ARRAY *DA_FN( create_file )( const char *path );
+DA_API DA_ARRAY *DA_FN( open )( const char                        *path,
+                                const enum dynamic_array_file_mode mode );
+DA_API bool      DA_FN( sync )( DA_ARRAY *da );
+DA_API void      DA_FN( clear )( DA_ARRAY *da );
+DA_API void      DA_FN( reset )( DA_ARRAY *da );
+DA_API void      DA_FN( reserve )( DA_ARRAY *da, const size_t capacity );
+DA_API void      DA_FN( shrink_to_fit )( DA_ARRAY *da );
+DA_API void      DA_FN( release )( DA_ARRAY *da );
+DA_API void      DA_FN( destroy )( DA_ARRAY *da );
+DA_API DA_ARRAY *DA_FN( clone )( DA_ARRAY *da );
+DA_API void      DA_FN( unshare )( DA_ARRAY *da );
+DA_API bool      DA_FN( is_shared )( const DA_ARRAY *da );
+DA_API void      DA_FN( stats )( const DA_ARRAY             *da,
+                                 struct dynamic_array_stats *out );
+DA_API void      DA_FN( stats_reset )( DA_ARRAY *da );
+DA_API DA_T      DA_FN( pop )( DA_ARRAY *da );
+DA_API void DA_FN( push_n )( DA_ARRAY *da, const DA_T *src, const size_t n );
+DA_API void DA_FN( extend )( DA_ARRAY *dst, const DA_ARRAY *src );
+DA_API void DA_FN( pop_n )( DA_ARRAY *da, DA_T *out, const size_t n );
+DA_API size_t DA_FN( size )( const DA_ARRAY *da );
+DA_API size_t DA_FN( capacity )( const DA_ARRAY *da );
+DA_API bool   DA_FN( empty )( const DA_ARRAY *da );
+DA_API void   DA_FN( fill )( DA_ARRAY *da, const DA_T value );
+DA_API void   DA_FN( expand )( DA_ARRAY *da );
+DA_API void   DA_FN( rotate_right )( DA_ARRAY *da );
+DA_API void   DA_FN( rotate_left )( DA_ARRAY *da );
+DA_API void   DA_FN( rotate_right_n )( DA_ARRAY *da, const int count );
+DA_API void   DA_FN( rotate_left_n )( DA_ARRAY *da, const int count );
+DA_API void   DA_FN( insert )( DA_ARRAY *da, const size_t index,
+                               const DA_T value );
+DA_API DA_T   DA_FN( remove )( DA_ARRAY *da, const size_t index );
+DA_API void   DA_FN( insert_range )( DA_ARRAY *da, const size_t index,
+                                     const DA_T *src, const size_t n );
+DA_API void   DA_FN( remove_range )( DA_ARRAY *da, const size_t first,
+                                     const size_t last );
+DA_API size_t DA_FN( remove_if )( DA_ARRAY *da,
+                                  bool ( *predicate )( const DA_T value,
+                                                       void      *context ),
+                                  void *context );
+DA_API size_t DA_FN( retain_if )( DA_ARRAY *da,
+                                  bool ( *predicate )( const DA_T value,
+                                                       void      *context ),
+                                  void *context );
+#ifndef DYNAMIC_ARRAY_CUSTOM_SEARCH
+DA_API ptrdiff_t DA_FN( find )( const DA_ARRAY *da, const DA_T value );
+DA_API ptrdiff_t DA_FN( find_last )( const DA_ARRAY *da, const DA_T value );
+DA_API size_t    DA_FN( count )( const DA_ARRAY *da, const DA_T value );
+DA_API size_t    DA_FN( remove_value )( DA_ARRAY *da, const DA_T value );
+#endif
+
+// Checked access tests at runtime what the functions below assert, and
+// reports it instead of failing, also in release builds. Nothing is changed
+// unless DYNAMIC_ARRAY_OK is returned.
+DA_API enum dynamic_array_status DA_FN( push_checked )( DA_ARRAY  *da,
+                                                        const DA_T value );
+DA_API enum dynamic_array_status DA_FN( pop_checked )( DA_ARRAY *da,
+                                                       DA_T     *out );
+DA_API enum dynamic_array_status
+DA_FN( get_checked )( const DA_ARRAY *da, const size_t index, DA_T *out );
+DA_API enum dynamic_array_status
+DA_FN( set_checked )( DA_ARRAY *da, const size_t index, const DA_T value );
+DA_API enum dynamic_array_status DA_FN( front_checked )( const DA_ARRAY *da,
+                                                         DA_T           *out );
+DA_API enum dynamic_array_status DA_FN( back_checked )( const DA_ARRAY *da,
+                                                        DA_T           *out );
+
+// the out-of-line halves of push and set, for the cases the inline fast
+// paths below leave to them; not meant to be called directly
+DA_API DYNAMIC_ARRAY_COLD void DA_FN( push_slow )( DA_ARRAY  *da,
+                                                   const DA_T value );
+DA_API DYNAMIC_ARRAY_COLD void
+DA_FN( set_slow )( DA_ARRAY *da, const size_t index, const DA_T value );
+
+// Element access is inline, so the caller's loops see plain loads and
+// stores they can optimize and vectorize. Writes fall back to the slow path
+// for growth, a hash index to update, a file that may be read-only and a
+// buffer shared with clones.
+static inline bool DA_FN( is_plain )( const DA_ARRAY *da ) {
+    return da->share == NULL &&
+           !( da->flags &
+              ( DYNAMIC_ARRAY_FLAG_INDEXED | DYNAMIC_ARRAY_FLAG_FILE ) );
+}
+
+static inline void DA_FN( push )( DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+    if ( DYNAMIC_ARRAY_UNLIKELY( da->size == da->capacity ||
+                                 !DA_FN( is_plain )( da ) ) ) {
+        DA_FN( push_slow )( da, value );
+        return;
+    }
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_SORTED;
+    da->buffer[da->size++] = value;
+}
+
+static inline DA_T DA_FN( get )( const DA_ARRAY *da, const size_t index ) {
+    assert( da != NULL );
+    assert( index < da->size );
+    return da->buffer[index];
+}
+
+static inline void DA_FN( set )( DA_ARRAY *da, const size_t index,
+                                 const DA_T value ) {
+    assert( da != NULL );
+    assert( index < da->size );
+    if ( DYNAMIC_ARRAY_UNLIKELY( !DA_FN( is_plain )( da ) ) ) {
+        DA_FN( set_slow )( da, index, value );
+        return;
+    }
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_SORTED;
+    da->buffer[index] = value;
+}
+
+static inline DA_T DA_FN( front )( const DA_ARRAY *da ) {
+    assert( da != NULL );
+    assert( da->size > 0 );
+    return da->buffer[0];
+}
+
+static inline DA_T DA_FN( back )( const DA_ARRAY *da ) {
+    assert( da != NULL );
+    assert( da->size > 0 );
+    return da->buffer[da->size - 1];
+}
+
+// Unchecked access asserts nothing: the caller guarantees index < size, a
+// non-empty array for front and back, and room for push_unchecked
+// (size < capacity, e.g. after reserve). The writes also need an array
+// that is writable and not shared with clones (see unshare); they mark a
+// hash index stale instead of updating it.
+static inline DA_T DA_FN( get_unchecked )( const DA_ARRAY *da,
+                                           const size_t    index ) {
+    return da->buffer[index];
+}
+
+static inline DA_T DA_FN( front_unchecked )( const DA_ARRAY *da ) {
+    return da->buffer[0];
+}
+
+static inline DA_T DA_FN( back_unchecked )( const DA_ARRAY *da ) {
+    return da->buffer[da->size - 1];
+}
+
+static inline void DA_FN( set_unchecked )( DA_ARRAY *da, const size_t index,
+                                           const DA_T value ) {
+    da->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                              DYNAMIC_ARRAY_FLAG_INDEXED );
+    da->buffer[index] = value;
+}
+
+static inline void DA_FN( push_unchecked )( DA_ARRAY *da, const DA_T value ) {
+    da->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                              DYNAMIC_ARRAY_FLAG_INDEXED );
+    da->buffer[da->size++] = value;
+}
+
+#endif // DA_DECLARE
+
+#if DA_DEFINE
+
+#include <assert.h>
+#include <string.h>
+
+#if DYNAMIC_ARRAY_HASH_INDEX
+static_assert( _Generic( (DA_T)0, int: 1, default: 0 ),
+               "the hash index is keyed by int" );
+#endif
+
+static inline bool DA_FN( is_read_only )( const DA_ARRAY *da ) {
+    return ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) &&
+           dynamic_array_file_mode( da->file ) == DYNAMIC_ARRAY_FILE_READ_ONLY;
+}
+
+// Called before writing elements, by every writer in the template (code
+// outside it calls unshare, which makes the same check). A read-only file
+// would fault on the first store, so it fails an assert here instead; a
+// buffer shared with clones is copied first, so they keep their contents.
+static inline void DA_FN( own )( DA_ARRAY *da ) {
+    assert( !DA_FN( is_read_only )( da ) );
+    if ( da->share != NULL ) { DA_FN( unshare )( da ); }
+}
+
+// called by every operation that may reorder or add elements; removals keep
+// the relative order and leave the sorted flag alone
+static inline void DA_FN( touch )( DA_ARRAY *da ) {
+    DA_FN( own )( da );
+    da->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                              DYNAMIC_ARRAY_FLAG_INDEXED );
+}
+
+// called by bulk removals and rewrites before they shift or change the
+// positions a hash index points at; reindex follows once they are done
+static inline void DA_FN( forget_index )( DA_ARRAY *da ) {
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_INDEXED;
+}
+
+// called by bulk changes once done: they move too many positions to follow
+// one by one, so an index is rebuilt in a pass no dearer than the change
+static inline void DA_FN( reindex )( DA_ARRAY *da ) {
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( da->index != NULL ) { dynamic_array_index_refresh( da ); }
+#else
+    (void)da;
+#endif
+}
+
+// called once the array is empty: an empty table is current, so an index
+// survives reset and release instead of going stale
+static inline void DA_FN( empty_index )( DA_ARRAY *da ) {
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( da->index != NULL ) {
+        dynamic_array_index_clear( da->index );
+        da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED;
+    }
+#else
+    (void)da;
+#endif
+}
+
+static inline bool DA_FN( is_inline )( const DA_ARRAY *da ) {
+#if DYNAMIC_ARRAY_INLINE_CAPACITY > 0
+    return da->buffer == da->inline_buffer;
+#else
+    (void)da;
+    return false;
+#endif
+}
+
+// points an empty array at its initial storage without allocating: the
+// inline region when there is one, otherwise no buffer and zero capacity until
+// the first push
+static void DA_FN( initial_storage )( DA_ARRAY *da ) {
+    da->size = 0;
+#if DYNAMIC_ARRAY_INLINE_CAPACITY > 0
+    da->buffer   = da->inline_buffer;
+    da->capacity = DYNAMIC_ARRAY_INLINE_CAPACITY;
+#else
+    da->buffer   = NULL;
+    da->capacity = 0;
+#endif
+}
+
+// a shared file records the current size on the way out; a buffer shared
+// with clones is only freed by the last holder
+static void DA_FN( free_storage )( DA_ARRAY *da ) {
+    if ( da->share != NULL ) {
+        struct dynamic_array_share *share = da->share;
+        da->share                         = NULL;
+        if ( !dynamic_array_share_release( share ) ) {
+            da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_MAPPED;
+            return;
+        }
+    }
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) {
+        dynamic_array_file_close( da->file, da->size, da->flags );
+        da->file = NULL;
+        da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_FILE;
+    } else if ( da->flags & DYNAMIC_ARRAY_FLAG_MAPPED ) {
+        dynamic_array_map_free( da->buffer, sizeof *da->buffer * da->capacity );
+        da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_MAPPED;
+    } else if ( da->buffer != NULL && !DA_FN( is_inline )( da ) ) {
+        da->allocator->free( da->allocator->context, da->buffer,
+                             sizeof *da->buffer * da->capacity );
+    }
+}
+
+// reports a capacity change to the array's peak and to the global gauges;
+// stats.wasted_capacity holds the slack last reported
+static void DA_FN( track_capacity )( DA_ARRAY    *da,
+                                     const size_t old_capacity ) {
+#if DYNAMIC_ARRAY_STATS
+    const uint64_t bytes  = sizeof *da->buffer * da->capacity;
+    const uint64_t wasted = sizeof *da->buffer * ( da->capacity - da->size );
+    dynamic_array_stats_capacity( sizeof *da->buffer * old_capacity, bytes,
+                                  da->stats.wasted_capacity, wasted );
+    da->stats.wasted_capacity = wasted;
+    if ( bytes > da->stats.peak_capacity ) { da->stats.peak_capacity = bytes; }
+#else
+    (void)da;
+    (void)old_capacity;
+#endif
+}
+
+// mapped buffers are resized with mremap unless clones share them; the page
+// rounding becomes extra capacity
+static bool DA_FN( remap )( DA_ARRAY *da, const size_t capacity ) {
+    size_t bytes = sizeof *da->buffer * capacity;
+    DA_T  *buffer;
+    if ( ( da->flags & DYNAMIC_ARRAY_FLAG_MAPPED ) && da->share == NULL ) {
+        buffer = dynamic_array_map_resize(
+            da->buffer, sizeof *da->buffer * da->capacity, &bytes );
+        if ( buffer == NULL ) { return false; }
+    } else {
+        buffer = dynamic_array_map_alloc( &bytes );
+        if ( buffer == NULL ) { return false; }
+        if ( da->size > 0 ) {
+            memcpy( buffer, da->buffer, sizeof *da->buffer * da->size );
+        }
+        DA_FN( free_storage )( da );
+        da->flags |= DYNAMIC_ARRAY_FLAG_MAPPED;
+    }
+    da->buffer   = buffer;
+    da->capacity = bytes / sizeof *da->buffer;
+    return true;
+}
+
+// Moves the elements to a buffer of `capacity` elements; leaving the inline
+// region, a private file mapping or a buffer shared with clones is an alloc
+// + copy since none can be passed to realloc. Returns false, with the array
+// unchanged, when the memory or the file can't be had.
+static bool DA_FN( try_reallocate )( DA_ARRAY *da, const size_t capacity ) {
+    assert( capacity >= da->size );
+    if ( capacity > SIZE_MAX / sizeof *da->buffer ) { return false; }
+    const size_t old_capacity = da->capacity;
+    const size_t threshold    = da->growth->mmap_threshold;
+    DYNAMIC_ARRAY_COUNT( da, reallocs, DYNAMIC_ARRAY_STAT_REALLOCS, 1 );
+    DYNAMIC_ARRAY_COUNT( da, bytes_copied, DYNAMIC_ARRAY_STAT_BYTES_COPIED,
+                         sizeof *da->buffer * da->size );
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) {
+        const enum dynamic_array_file_mode mode =
+            dynamic_array_file_mode( da->file );
+        assert( mode != DYNAMIC_ARRAY_FILE_READ_ONLY );
+        if ( mode == DYNAMIC_ARRAY_FILE_SHARED ) {
+            size_t elements = capacity;
+            DA_T  *buffer = dynamic_array_file_resize( da->file, &elements );
+            if ( buffer == NULL ) { return false; }
+            da->buffer   = buffer;
+            da->capacity = elements;
+            DA_FN( track_capacity )( da, old_capacity );
+            return true;
+        }
+        // a private mapping falls through and is copied off the file
+    }
+    if ( ( da->flags & DYNAMIC_ARRAY_FLAG_MAPPED ) ||
+         ( threshold > 0 && sizeof *da->buffer * capacity >= threshold &&
+           dynamic_array_map_supported() ) ) {
+        if ( !DA_FN( remap )( da, capacity ) ) { return false; }
+        DA_FN( track_capacity )( da, old_capacity );
+        return true;
+    }
+    DA_T *buffer;
+    if ( da->buffer == NULL || DA_FN( is_inline )( da ) ||
+         ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) || da->share != NULL ) {
+        buffer = da->allocator->alloc( da->allocator->context,
+                                       sizeof *da->buffer * capacity );
+        if ( buffer == NULL ) { return false; }
+        if ( da->size > 0 ) {
+            memcpy( buffer, da->buffer, sizeof *da->buffer * da->size );
+        }
+        DA_FN( free_storage )( da );
+    } else {
+        buffer = da->allocator->realloc(
+            da->allocator->context, da->buffer,
+            sizeof *da->buffer * da->capacity, sizeof *da->buffer * capacity );
+        if ( buffer == NULL ) { return false; }
+    }
+    da->buffer   = buffer;
+    da->capacity = capacity;
+    DA_FN( track_capacity )( da, old_capacity );
+    return true;
+}
+
+static void DA_FN( reallocate )( DA_ARRAY *da, const size_t capacity ) {
+    const bool moved = DA_FN( try_reallocate )( da, capacity );
+    assert( moved );
+    (void)moved;
+}
+
+// single reallocation to the first capacity the growth policy reaches that
+// holds `min_capacity`, instead of one step per push
+static void DA_FN( grow )( DA_ARRAY *da, const size_t min_capacity ) {
+    if ( min_capacity <= da->capacity ) { return; }
+    DA_FN( reallocate )( da, dynamic_array_growth_next(
+                                 da->growth, da->capacity, min_capacity,
+                                 DYNAMIC_ARRAY_DEFAULT_CAPACITY ) );
+}
+
+// Halves the capacity while fewer than capacity / shrink_divisor elements
+// remain, in one reallocation; a failed one keeps the larger buffer. A
+// clone would keep a shared buffer alive anyway, and files keep their size.
+static DYNAMIC_ARRAY_COLD void DA_FN( shrink )( DA_ARRAY *da ) {
+    if ( da->share != NULL || DA_FN( is_inline )( da ) ||
+         ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) ) {
+        return;
+    }
+    const bool   mapped  = da->flags & DYNAMIC_ARRAY_FLAG_MAPPED;
+    const size_t divisor = da->growth->shrink_divisor;
+    size_t       floor   = DYNAMIC_ARRAY_DEFAULT_CAPACITY;
+    if ( mapped && da->growth->mmap_threshold / sizeof *da->buffer > floor ) {
+        floor = da->growth->mmap_threshold / sizeof *da->buffer;
+    }
+    size_t capacity = da->capacity;
+    while ( capacity / 2 >= floor && da->size < capacity / divisor ) {
+        capacity /= 2;
+    }
+    if ( capacity == da->capacity ) { return; }
+    if ( !DA_FN( try_reallocate )( da, capacity ) ) { return; }
+    // mremap only unmapped the tail; the pages between the elements and the
+    // new end are still resident
+    if ( mapped ) {
+        dynamic_array_map_discard( da->buffer, sizeof *da->buffer * da->size,
+                                   sizeof *da->buffer * da->capacity );
+    }
+}
+
+// called by pop and the removals once the size has dropped; arrays that
+// never shrink only test a flag
+static inline void DA_FN( settle )( DA_ARRAY *da ) {
+    if ( DYNAMIC_ARRAY_UNLIKELY( da->flags & DYNAMIC_ARRAY_FLAG_SHRINK ) &&
+         da->capacity > DYNAMIC_ARRAY_DEFAULT_CAPACITY &&
+         da->size < da->capacity / da->growth->shrink_divisor ) {
+        DA_FN( shrink )( da );
+    }
+}
+
+// single pass that keeps every element for which predicate != `drop`; the
+// prefix before the first dropped element is never rewritten
+static size_t DA_FN( compact )( DA_ARRAY *da,
+                                bool ( *predicate )( const DA_T value,
+                                                     void      *context ),
+                                void *context, const bool drop ) {
+    assert( da != NULL );
+    assert( predicate != NULL );
+    DA_FN( own )( da );
+    DA_FN( forget_index )( da );
+    size_t kept = 0;
+    for ( size_t i = 0; i < da->size; i++ ) {
+        if ( predicate( da->buffer[i], context ) == drop ) { continue; }
+        if ( kept != i ) { da->buffer[kept] = da->buffer[i]; }
+        kept++;
+    }
+    size_t removed = da->size - kept;
+    da->size       = kept;
+    DA_FN( settle )( da );
+    DA_FN( reindex )( da );
+    return removed;
+}
+
+static void DA_FN( reverse )( DA_T *buffer, const size_t n ) {
+    if ( n < 2 ) { return; }
+    for ( size_t i = 0, j = n - 1; i < j; i++, j-- ) {
+        DA_T temp = buffer[i];
+        buffer[i] = buffer[j];
+        buffer[j] = temp;
+    }
+}
+
+DA_API DA_ARRAY *DA_FN( create )( void ) {
+    return DA_FN( create_with )( NULL, NULL );
+}
+
+// the header comes from `header_allocator` and the elements from `allocator`
+// (NULL selects the heap for either), e.g. a pool for headers and an arena
+// for buffers; both must outlive the array
+DA_API DA_ARRAY *
+DA_FN( create_with )( const struct dynamic_array_allocator *header_allocator,
+                      const struct dynamic_array_allocator *allocator ) {
+    if ( header_allocator == NULL ) {
+        header_allocator = &dynamic_array_heap_allocator;
+    }
+    DA_ARRAY *da;
+    da = header_allocator->alloc( header_allocator->context, sizeof *da );
+    assert( da != NULL );
+    DA_FN( init_with )( da, allocator );
+    da->header_allocator = header_allocator;
+    return da;
+}
+
+DA_API void DA_FN( init )( DA_ARRAY *da ) { DA_FN( init_with )( da, NULL ); }
+
+// `allocator` (NULL selects the heap) must outlive the array
+DA_API void
+DA_FN( init_with )( DA_ARRAY                             *da,
+                    const struct dynamic_array_allocator *allocator ) {
+    assert( da != NULL );
+    da->allocator = allocator ? allocator : &dynamic_array_heap_allocator;
+    da->header_allocator = &dynamic_array_heap_allocator;
+    da->growth           = &dynamic_array_growth_default;
+    da->file             = NULL;
+    da->share            = NULL;
+    da->flags            = 0;
+#if DYNAMIC_ARRAY_STATS
+    da->stats = ( struct dynamic_array_counters ){ 0 };
+#endif
+#if DYNAMIC_ARRAY_HASH_INDEX
+    da->index = NULL;
+#endif
+    DA_FN( initial_storage )( da );
+    DA_FN( track_capacity )( da, 0 );
+}
+
+// `growth` (NULL restores doubling) must outlive the array; it applies from
+// the next reallocation or removal on
+DA_API void
+DA_FN( set_growth )( DA_ARRAY *da, const struct dynamic_array_growth *growth ) {
+    assert( da != NULL );
+    assert( growth == NULL || growth->shrink_divisor == 0 ||
+            growth->shrink_divisor >= 3 );
+    da->growth = growth ? growth : &dynamic_array_growth_default;
+    da->flags &= ~(unsigned)DYNAMIC_ARRAY_FLAG_SHRINK;
+    if ( da->growth->shrink_divisor != 0 ) {
+        da->flags |= DYNAMIC_ARRAY_FLAG_SHRINK;
+    }
+}
+
+// wraps a mapped file in a new heap-allocated array
+static DA_ARRAY *DA_FN( adopt_file )( struct dynamic_array_file *file ) {
+    const struct dynamic_array_file_header *header =
+        dynamic_array_file_header( file );
+    DA_ARRAY    *da           = DA_FN( create )();
+    const size_t old_capacity = da->capacity;
+    da->file                  = file;
+    da->buffer                = dynamic_array_file_data( file );
+    da->size                  = header->size;
+    da->capacity              = header->capacity;
+    da->flags = DYNAMIC_ARRAY_FLAG_FILE | ( header->flags &
+                                            DYNAMIC_ARRAY_FLAG_SORTED );
+    DA_FN( track_capacity )( da, old_capacity );
+    return da;
+}
+
+// creates (or truncates) `path` and keeps the elements in it: growth extends
+// the file, and sync, release and destroy record the size in its header.
+// Returns NULL with errno set when the file cannot be created.
+DA_API DA_ARRAY *DA_FN( create_file )( const char *path ) {
+    struct dynamic_array_file *file = dynamic_array_file_create(
+        path, sizeof( DA_T ), DYNAMIC_ARRAY_DEFAULT_CAPACITY );
+    return file ? DA_FN( adopt_file )( file ) : NULL;
+}
+
+// time: O(1), pages are read on first access
+// maps an array saved by create_file without reading it; returns NULL with
+// errno set (EINVAL for a file of another element size or not an array)
+DA_API DA_ARRAY *DA_FN( open )( const char                        *path,
+                                const enum dynamic_array_file_mode mode ) {
+    struct dynamic_array_file *file =
+        dynamic_array_file_open( path, sizeof( DA_T ), mode );
+    return file ? DA_FN( adopt_file )( file ) : NULL;
+}
+
+// writes the size to a shared file's header and flushes it to disk; a no-op
+// returning true for other arrays
+DA_API bool DA_FN( sync )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    if ( !( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) ) { return true; }
+    return dynamic_array_file_sync( da->file, da->size, da->flags );
+}
+
+// kept for compatibility, same as reset
+DA_API void DA_FN( clear )( DA_ARRAY *da ) { DA_FN( reset )( da ); }
+
+// empties the array but keeps the buffer, so refilling it up to the previous
+// size does not touch the allocator
+DA_API void DA_FN( reset )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    da->size = 0;
+    DA_FN( empty_index )( da );
+}
+
+// ensures room for `capacity` elements without changing the size
+DA_API void DA_FN( reserve )( DA_ARRAY *da, const size_t capacity ) {
+    assert( da != NULL );
+    if ( capacity > da->capacity ) { DA_FN( reallocate )( da, capacity ); }
+}
+
+// reduces capacity to the size, falling back to the initial (inline or
+// empty) storage when the elements fit there. A shared file is shrunk in
+// place instead, down to its header page when empty: leaving it would close
+// the file, and later writes would never reach it.
+DA_API void DA_FN( shrink_to_fit )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    if ( da->size == da->capacity || DA_FN( is_inline )( da ) ) { return; }
+    const bool shared_file =
+        ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) &&
+        dynamic_array_file_mode( da->file ) == DYNAMIC_ARRAY_FILE_SHARED;
+#if DYNAMIC_ARRAY_INLINE_CAPACITY > 0
+    if ( !shared_file && da->size <= DYNAMIC_ARRAY_INLINE_CAPACITY ) {
+        const size_t old_capacity = da->capacity;
+        memcpy( da->inline_buffer, da->buffer, sizeof *da->buffer * da->size );
+        DA_FN( free_storage )( da );
+        da->buffer   = da->inline_buffer;
+        da->capacity = DYNAMIC_ARRAY_INLINE_CAPACITY;
+        DA_FN( track_capacity )( da, old_capacity );
+        return;
+    }
+#endif
+    if ( !shared_file && da->size == 0 ) {
+        DA_FN( release )( da );
+        return;
+    }
+    DA_FN( reallocate )( da, da->size );
+}
+
+// frees the buffer and returns to the allocation-free empty state; the array
+// stays usable
+DA_API void DA_FN( release )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    const size_t old_capacity = da->capacity;
+    DA_FN( free_storage )( da );
+    DA_FN( initial_storage )( da );
+    DA_FN( track_capacity )( da, old_capacity );
+    DA_FN( empty_index )( da );
+}
+
+DA_API void DA_FN( destroy )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    const struct dynamic_array_allocator *header = da->header_allocator;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    dynamic_array_index_destroy( da->index );
+#endif
+    DA_FN( free_storage )( da );
+#if DYNAMIC_ARRAY_STATS
+    const size_t old_capacity = da->capacity;
+    da->size                  = 0;
+    da->capacity              = 0;
+    DA_FN( track_capacity )( da, old_capacity );
+#endif
+    header->free( header->context, da, sizeof *da );
+    da = NULL;
+}
+
+// time: O(1) for heap and mapped buffers, which the clone shares until one
+// side writes; O(N) for inline and file-backed elements, which are copied.
+// The clone gets the allocators, growth policy and sorted flag, but no hash
+// index. The first clone of an array writes da->share, so it must not race
+// with other users of `da`; later clones only bump the shared count.
+DA_API DA_ARRAY *DA_FN( clone )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    DA_ARRAY *copy =
+        DA_FN( create_with )( da->header_allocator, da->allocator );
+    copy->growth = da->growth;
+    // the policy's flag travels with it
+    const unsigned inherited =
+        da->flags & ( DYNAMIC_ARRAY_FLAG_SORTED | DYNAMIC_ARRAY_FLAG_SHRINK );
+    if ( da->size == 0 ) {
+        copy->flags = inherited;
+        return copy;
+    }
+    if ( DA_FN( is_inline )( da ) || ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) ) {
+        DA_FN( push_n )( copy, da->buffer, da->size );
+        copy->flags |= inherited;
+        return copy;
+    }
+    if ( da->share == NULL ) {
+        da->share = dynamic_array_share_create( da->allocator );
+        assert( da->share != NULL );
+    } else {
+        dynamic_array_share_acquire( da->share );
+    }
+    const size_t old_capacity = copy->capacity;
+    copy->buffer              = da->buffer;
+    copy->size                = da->size;
+    copy->capacity            = da->capacity;
+    copy->share               = da->share;
+    copy->flags = inherited | ( da->flags & DYNAMIC_ARRAY_FLAG_MAPPED );
+    DA_FN( track_capacity )( copy, old_capacity );
+    return copy;
+}
+
+// time: O(N) while clones share the buffer, O(1) otherwise
+// gives the array its own copy of a shared buffer; every mutation does this
+// first, and so must code that writes through da->buffer. Asserts that the
+// array is not a read-only file.
+DA_API void DA_FN( unshare )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    assert( !DA_FN( is_read_only )( da ) );
+    if ( da->share == NULL ) { return; }
+    if ( dynamic_array_share_unique( da->share ) ) {
+        // every clone is gone, the buffer is ours again
+        (void)dynamic_array_share_release( da->share );
+        da->share = NULL;
+        return;
+    }
+    DA_FN( reallocate )( da, da->capacity );
+}
+
+// true while a clone still holds the buffer
+DA_API bool DA_FN( is_shared )( const DA_ARRAY *da ) {
+    assert( da != NULL );
+    return da->share != NULL && !dynamic_array_share_unique( da->share );
+}
+
+// copies the array's counters; wasted_capacity is the slack right now
+DA_API void DA_FN( stats )( const DA_ARRAY             *da,
+                            struct dynamic_array_stats *out ) {
+    assert( da != NULL );
+    assert( out != NULL );
+#if DYNAMIC_ARRAY_STATS
+    const struct dynamic_array_counters *c       = &da->stats;
+    const memory_order                   relaxed = memory_order_relaxed;
+    out->reallocs        = atomic_load_explicit( &c->reallocs, relaxed );
+    out->bytes_copied    = atomic_load_explicit( &c->bytes_copied, relaxed );
+    out->shifts          = atomic_load_explicit( &c->shifts, relaxed );
+    out->comparisons     = atomic_load_explicit( &c->comparisons, relaxed );
+    out->peak_capacity   = c->peak_capacity;
+    out->wasted_capacity = sizeof *da->buffer * ( da->capacity - da->size );
+#else
+    (void)da;
+    *out = ( struct dynamic_array_stats ){ 0 };
+#endif
+}
+
+// clears the counters; the peak restarts from the current capacity
+DA_API void DA_FN( stats_reset )( DA_ARRAY *da ) {
+    assert( da != NULL );
+#if DYNAMIC_ARRAY_STATS
+    struct dynamic_array_counters *c       = &da->stats;
+    const memory_order             relaxed = memory_order_relaxed;
+    atomic_store_explicit( &c->reallocs, 0, relaxed );
+    atomic_store_explicit( &c->bytes_copied, 0, relaxed );
+    atomic_store_explicit( &c->shifts, 0, relaxed );
+    atomic_store_explicit( &c->comparisons, 0, relaxed );
+    c->peak_capacity = sizeof *da->buffer * da->capacity;
+#else
+    (void)da;
+#endif
+}
+
+DA_API size_t DA_FN( size )( const DA_ARRAY *da ) {
+    assert( da != NULL );
+    return da->size;
+}
+
+DA_API size_t DA_FN( capacity )( const DA_ARRAY *da ) {
+    assert( da != NULL );
+    return da->capacity;
+}
+
+// one growth step of the array's policy (doubling by default); an empty
+// array starts at the default capacity
+DA_API void DA_FN( expand )( DA_ARRAY *da ) {
+    assert( da != NULL );
+    assert( da->capacity < SIZE_MAX / sizeof *da->buffer );
+    DA_FN( grow )( da, da->capacity + 1 );
+}
+
+DA_API void DA_FN( push_slow )( DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+#if DYNAMIC_ARRAY_HASH_INDEX
+    const bool indexed = da->flags & DYNAMIC_ARRAY_FLAG_INDEXED;
+#endif
+    DA_FN( touch )( da );
+    if ( da->size == da->capacity ) { DA_FN( expand )( da ); }
+    da->buffer[da->size++] = value;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( indexed &&
+         dynamic_array_index_add( da->index, value, da->size - 1 ) ) {
+        da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED;
+    }
+#endif
+}
+
+// the array must not be empty; pop_checked reports it instead
+DA_API DA_T DA_FN( pop )( DA_ARRAY *da ) {
+    assert( da->size > 0 );
+    const DA_T value = da->buffer[--da->size];
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) {
+        dynamic_array_index_pop( da->index, value, da->size );
+    }
+#endif
+    DA_FN( settle )( da );
+    return value;
+}
+
+// time: O(N)
+// grows at most once, then copies the whole batch in one memcpy
+DA_API void DA_FN( push_n )( DA_ARRAY *da, const DA_T *src, const size_t n ) {
+    assert( da != NULL );
+    assert( src != NULL || n == 0 );
+    if ( n == 0 ) { return; }
+    assert( n <= SIZE_MAX / sizeof *da->buffer - da->size );
+#if DYNAMIC_ARRAY_HASH_INDEX
+    bool indexed = da->flags & DYNAMIC_ARRAY_FLAG_INDEXED;
+#endif
+    DA_FN( touch )( da );
+    DA_FN( grow )( da, da->size + n );
+    memcpy( da->buffer + da->size, src, sizeof *da->buffer * n );
+    da->size += n;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    for ( size_t i = da->size - n; indexed && i < da->size; i++ ) {
+        indexed = dynamic_array_index_add( da->index, da->buffer[i], i );
+    }
+    if ( indexed ) { da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED; }
+#endif
+}
+
+// time: O(N)
+DA_API void DA_FN( extend )( DA_ARRAY *dst, const DA_ARRAY *src ) {
+    assert( dst != NULL );
+    assert( src != NULL );
+    // src may alias dst, so the count is read before the buffer moves
+    const size_t n = src->size;
+    if ( n == 0 ) { return; }
+    assert( n <= SIZE_MAX / sizeof *dst->buffer - dst->size );
+#if DYNAMIC_ARRAY_HASH_INDEX
+    bool indexed = dst->flags & DYNAMIC_ARRAY_FLAG_INDEXED;
+#endif
+    DA_FN( touch )( dst );
+    DA_FN( grow )( dst, dst->size + n );
+    memcpy( dst->buffer + dst->size, src->buffer, sizeof *dst->buffer * n );
+    dst->size += n;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    for ( size_t i = dst->size - n; indexed && i < dst->size; i++ ) {
+        indexed = dynamic_array_index_add( dst->index, dst->buffer[i], i );
+    }
+    if ( indexed ) { dst->flags |= DYNAMIC_ARRAY_FLAG_INDEXED; }
+#endif
+}
+
+// time: O(N)
+// removes the last `n` elements; `out` (may be NULL) receives them in array
+// order, so out[0] is the element that was at index size - n
+DA_API void DA_FN( pop_n )( DA_ARRAY *da, DA_T *out, const size_t n ) {
+    assert( da != NULL );
+    assert( n <= da->size );
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) {
+        // from the back, so each pop sees the positions before it
+        for ( size_t i = da->size; i > da->size - n; i-- ) {
+            dynamic_array_index_pop( da->index, da->buffer[i - 1], i - 1 );
+        }
+    }
+#endif
+    da->size -= n;
+    if ( out != NULL && n > 0 ) {
+        memcpy( out, da->buffer + da->size, sizeof *da->buffer * n );
+    }
+    DA_FN( settle )( da );
+}
+
+DA_API void DA_FN( set_slow )( DA_ARRAY *da, const size_t index,
+                               const DA_T value ) {
+    assert( da != NULL );
+    assert( index < da->size );
+#if DYNAMIC_ARRAY_HASH_INDEX
+    const bool indexed   = da->flags & DYNAMIC_ARRAY_FLAG_INDEXED;
+    const DA_T old_value = da->buffer[index];
+#endif
+    DA_FN( touch )( da );
+    da->buffer[index] = value;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( indexed && dynamic_array_index_replace( da->index, old_value, value,
+                                                 index ) ) {
+        da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED;
+    }
+#endif
+}
+
+// The allocations a write may need, growth and the copy of a buffer shared
+// with clones, are made here where they can fail; the write that follows
+// then cannot.
+static bool DA_FN( make_room )( DA_ARRAY *da, const size_t size ) {
+    if ( size > da->capacity ) {
+        if ( da->capacity >= SIZE_MAX / sizeof *da->buffer ) { return false; }
+        return DA_FN( try_reallocate )(
+            da, dynamic_array_growth_next( da->growth, da->capacity, size,
+                                           DYNAMIC_ARRAY_DEFAULT_CAPACITY ) );
+    }
+    return !DA_FN( is_shared )( da ) ||
+           DA_FN( try_reallocate )( da, da->capacity );
+}
+
+DA_API enum dynamic_array_status DA_FN( push_checked )( DA_ARRAY  *da,
+                                                        const DA_T value ) {
+    if ( da == NULL ) { return DYNAMIC_ARRAY_ERROR_NULL; }
+    if ( DA_FN( is_read_only )( da ) ) { return DYNAMIC_ARRAY_ERROR_READ_ONLY; }
+    if ( !DA_FN( make_room )( da, da->size + 1 ) ) {
+        return DYNAMIC_ARRAY_ERROR_NO_MEMORY;
+    }
+    DA_FN( push )( da, value );
+    return DYNAMIC_ARRAY_OK;
+}
+
+DA_API enum dynamic_array_status DA_FN( pop_checked )( DA_ARRAY *da,
+                                                       DA_T     *out ) {
+    if ( da == NULL || out == NULL ) { return DYNAMIC_ARRAY_ERROR_NULL; }
+    if ( da->size == 0 ) { return DYNAMIC_ARRAY_ERROR_EMPTY; }
+    *out = DA_FN( pop )( da );
+    return DYNAMIC_ARRAY_OK;
+}
+
+DA_API enum dynamic_array_status
+DA_FN( get_checked )( const DA_ARRAY *da, const size_t index, DA_T *out ) {
+    if ( da == NULL || out == NULL ) { return DYNAMIC_ARRAY_ERROR_NULL; }
+    if ( index >= da->size ) { return DYNAMIC_ARRAY_ERROR_BOUNDS; }
+    *out = da->buffer[index];
+    return DYNAMIC_ARRAY_OK;
+}
+
+DA_API enum dynamic_array_status
+DA_FN( set_checked )( DA_ARRAY *da, const size_t index, const DA_T value ) {
+    if ( da == NULL ) { return DYNAMIC_ARRAY_ERROR_NULL; }
+    if ( index >= da->size ) { return DYNAMIC_ARRAY_ERROR_BOUNDS; }
+    if ( DA_FN( is_read_only )( da ) ) { return DYNAMIC_ARRAY_ERROR_READ_ONLY; }
+    if ( !DA_FN( make_room )( da, da->size ) ) {
+        return DYNAMIC_ARRAY_ERROR_NO_MEMORY;
+    }
+    DA_FN( set )( da, index, value );
+    return DYNAMIC_ARRAY_OK;
+}
+
+DA_API enum dynamic_array_status DA_FN( front_checked )( const DA_ARRAY *da,
+                                                         DA_T           *out ) {
+    if ( da == NULL || out == NULL ) { return DYNAMIC_ARRAY_ERROR_NULL; }
+    if ( da->size == 0 ) { return DYNAMIC_ARRAY_ERROR_EMPTY; }
+    *out = da->buffer[0];
+    return DYNAMIC_ARRAY_OK;
+}
+
+DA_API enum dynamic_array_status DA_FN( back_checked )( const DA_ARRAY *da,
+                                                        DA_T           *out ) {
+    if ( da == NULL || out == NULL ) { return DYNAMIC_ARRAY_ERROR_NULL; }
+    if ( da->size == 0 ) { return DYNAMIC_ARRAY_ERROR_EMPTY; }
+    *out = da->buffer[da->size - 1];
+    return DYNAMIC_ARRAY_OK;
+}
+
+// time: O(N)
+DA_API void DA_FN( insert )( DA_ARRAY *da, const size_t index,
+                             const DA_T value ) {
+    assert( index <= da->size );
+#if DYNAMIC_ARRAY_HASH_INDEX
+    const bool indexed = da->flags & DYNAMIC_ARRAY_FLAG_INDEXED;
+#endif
+    DA_FN( touch )( da );
+    if ( da->size == da->capacity ) { DA_FN( expand )( da ); }
+    DYNAMIC_ARRAY_COUNT( da, shifts, DYNAMIC_ARRAY_STAT_SHIFTS,
+                         da->size - index );
+    memmove( da->buffer + index + 1, da->buffer + index,
+             sizeof *da->buffer * ( da->size - index ) );
+    da->buffer[index] = value;
+    da->size++;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( indexed && dynamic_array_index_insert( da->index, value, index ) ) {
+        da->flags |= DYNAMIC_ARRAY_FLAG_INDEXED;
+    }
+#endif
+}
+
+// time: O(N)
+DA_API DA_T DA_FN( remove )( DA_ARRAY *da, const size_t index ) {
+    assert( index < da->size && da->size > 0 );
+    DA_FN( own )( da );
+    DA_T item = da->buffer[index];
+    DYNAMIC_ARRAY_COUNT( da, shifts, DYNAMIC_ARRAY_STAT_SHIFTS,
+                         da->size - index - 1 );
+    memmove( da->buffer + index, da->buffer + index + 1,
+             sizeof *da->buffer * ( da->size - index - 1 ) );
+    da->size--;
+#if DYNAMIC_ARRAY_HASH_INDEX
+    if ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) {
+        dynamic_array_index_remove( da->index, da->buffer, da->size, item,
+                                    index );
+    }
+#endif
+    DA_FN( settle )( da );
+    return item;
+}
+
+// time: O(N + n)
+// inserts src[0..n) before `index` with one move of the tail; `src` must not
+// point into the array itself
+DA_API void DA_FN( insert_range )( DA_ARRAY *da, const size_t index,
+                                   const DA_T *src, const size_t n ) {
+    assert( da != NULL );
+    assert( index <= da->size );
+    assert( src != NULL || n == 0 );
+    if ( n == 0 ) { return; }
+    assert( n <= SIZE_MAX / sizeof *da->buffer - da->size );
+    DA_FN( touch )( da );
+    DA_FN( grow )( da, da->size + n );
+    DYNAMIC_ARRAY_COUNT( da, shifts, DYNAMIC_ARRAY_STAT_SHIFTS,
+                         da->size - index );
+    memmove( da->buffer + index + n, da->buffer + index,
+             sizeof *da->buffer * ( da->size - index ) );
+    memcpy( da->buffer + index, src, sizeof *da->buffer * n );
+    da->size += n;
+    DA_FN( reindex )( da );
+}
+
+// time: O(N)
+// removes the half-open range [first, last)
+DA_API void DA_FN( remove_range )( DA_ARRAY *da, const size_t first,
+                                   const size_t last ) {
+    assert( da != NULL );
+    assert( first <= last && last <= da->size );
+    DA_FN( own )( da );
+    DA_FN( forget_index )( da );
+    DYNAMIC_ARRAY_COUNT( da, shifts, DYNAMIC_ARRAY_STAT_SHIFTS,
+                         da->size - last );
+    memmove( da->buffer + first, da->buffer + last,
+             sizeof *da->buffer * ( da->size - last ) );
+    da->size -= last - first;
+    DA_FN( settle )( da );
+    DA_FN( reindex )( da );
+}
+
+// time: O(N)
+// removes every element the predicate accepts, keeping the order of the rest,
+// and returns how many were removed
+DA_API size_t DA_FN( remove_if )( DA_ARRAY *da,
+                                  bool ( *predicate )( const DA_T value,
+                                                       void      *context ),
+                                  void *context ) {
+    return DA_FN( compact )( da, predicate, context, true );
+}
+
+// time: O(N)
+// keeps only the elements the predicate accepts, returns how many were removed
+DA_API size_t DA_FN( retain_if )( DA_ARRAY *da,
+                                  bool ( *predicate )( const DA_T value,
+                                                       void      *context ),
+                                  void *context ) {
+    return DA_FN( compact )( da, predicate, context, false );
+}
+
+#ifndef DYNAMIC_ARRAY_CUSTOM_SEARCH
+// time: O(N)
+DA_API ptrdiff_t DA_FN( find )( const DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+    for ( size_t i = 0; i < da->size; i++ ) {
+        if ( DYNAMIC_ARRAY_EQUAL( da->buffer[i], value ) ) {
+            DYNAMIC_ARRAY_COUNT( da, comparisons,
+                                 DYNAMIC_ARRAY_STAT_COMPARISONS, i + 1 );
+            return (ptrdiff_t)i;
+        }
+    }
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    return -1;
+}
+
+// time: O(N)
+DA_API ptrdiff_t DA_FN( find_last )( const DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+    for ( size_t i = da->size; i > 0; i-- ) {
+        if ( DYNAMIC_ARRAY_EQUAL( da->buffer[i - 1], value ) ) {
+            DYNAMIC_ARRAY_COUNT( da, comparisons,
+                                 DYNAMIC_ARRAY_STAT_COMPARISONS,
+                                 da->size - i + 1 );
+            return (ptrdiff_t)( i - 1 );
+        }
+    }
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    return -1;
+}
+
+// time: O(N)
+DA_API size_t DA_FN( count )( const DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    size_t count = 0;
+    for ( size_t i = 0; i < da->size; i++ ) {
+        count += DYNAMIC_ARRAY_EQUAL( da->buffer[i], value ) ? 1 : 0;
+    }
+    return count;
+}
+
+// time: O(N)
+// removes every element equal to `value`, returns how many were removed
+DA_API size_t DA_FN( remove_value )( DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+    DYNAMIC_ARRAY_COUNT( da, comparisons, DYNAMIC_ARRAY_STAT_COMPARISONS,
+                         da->size );
+    DA_FN( own )( da );
+    DA_FN( forget_index )( da );
+    size_t kept = 0;
+    for ( size_t i = 0; i < da->size; i++ ) {
+        if ( DYNAMIC_ARRAY_EQUAL( da->buffer[i], value ) ) { continue; }
+        if ( kept != i ) { da->buffer[kept] = da->buffer[i]; }
+        kept++;
+    }
+    size_t removed = da->size - kept;
+    da->size       = kept;
+    DA_FN( settle )( da );
+    DA_FN( reindex )( da );
+    return removed;
+}
+#endif // DYNAMIC_ARRAY_CUSTOM_SEARCH
+
+// time: O(N)
+DA_API void DA_FN( rotate_right )( DA_ARRAY *da ) {
+    // retrieve the last element
+    // shift all elements to the right
+    // set first element to previously saved last element
+    DA_FN( touch )( da );
+    DA_T last = da->buffer[da->size - 1];
+    for ( size_t i = da->size - 1; i > 0; i-- ) {
+        da->buffer[i] = da->buffer[i - 1];
+    }
+    da->buffer[0] = last;
+    DA_FN( reindex )( da );
+}
+
+// time: O(N)
+DA_API void DA_FN( rotate_left )( DA_ARRAY *da ) {
+    // retrieve the first element
+    // shift all elements to the left
+    // set last element to previously saved first element
+    DA_FN( touch )( da );
+    DA_T first = da->buffer[0];
+    for ( size_t i = 0; i < da->size - 1; i++ ) {
+        da->buffer[i] = da->buffer[i + 1];
+    }
+    da->buffer[da->size - 1] = first;
+    DA_FN( reindex )( da );
+}
+
+// time: O(N), single pass of three in-place reversals regardless of count
+// [a b c d e] -> reverse all -> [e d c b a] -> reverse [0,k) and [k,N)
+DA_API void DA_FN( rotate_right_n )( DA_ARRAY *da, const int count ) {
+    assert( da != NULL );
+    if ( da->size < 2 ) { return; }
+    // get the mod so as not to do redundant operations
+    size_t rotations = dynamic_array_euclidean_division( count, da->size );
+    if ( rotations == 0 ) { return; }
+    DA_FN( touch )( da );
+    DA_FN( reverse )( da->buffer, da->size );
+    DA_FN( reverse )( da->buffer, rotations );
+    DA_FN( reverse )( da->buffer + rotations, da->size - rotations );
+    DA_FN( reindex )( da );
+}
+
+// time: O(N)
+DA_API void DA_FN( rotate_left_n )( DA_ARRAY *da, const int count ) {
+    assert( da != NULL );
+    if ( da->size < 2 ) { return; }
+    size_t rotations = dynamic_array_euclidean_division( count, da->size );
+    if ( rotations == 0 ) { return; }
+    DA_FN( touch )( da );
+    DA_FN( reverse )( da->buffer, rotations );
+    DA_FN( reverse )( da->buffer + rotations, da->size - rotations );
+    DA_FN( reverse )( da->buffer, da->size );
+    DA_FN( reindex )( da );
+}
+
+DA_API void DA_FN( fill )( DA_ARRAY *da, const DA_T value ) {
+    assert( da != NULL );
+    assert( da->size > 0 );
+    DA_FN( own )( da );
+    DA_FN( forget_index )( da );
+    for ( size_t i = 0; i < da->size; i++ ) { da->buffer[i] = value; }
+    DA_FN( reindex )( da );
+}
+
+DA_API bool DA_FN( empty )( const DA_ARRAY *da ) {
+    assert( da != NULL );
+    return da->size == 0;
+}
+
+#endif // DA_DEFINE
+
+#undef DA_FN
+#undef DA_ARRAY
+#undef DA_T
+#undef DA_API
+#undef DA_DEFINE
+#undef DA_DECLARE
+#undef DYNAMIC_ARRAY_EQUAL
+#undef DYNAMIC_ARRAY_INLINE_CAPACITY
+#undef DYNAMIC_ARRAY_CUSTOM_SEARCH
+#undef DYNAMIC_ARRAY_HASH_INDEX
+#undef DYNAMIC_ARRAY_STATIC
+#undef DYNAMIC_ARRAY_IMPLEMENTATION
+#undef DYNAMIC_ARRAY_TYPE
+#undef DYNAMIC_ARRAY_NAME
@@ -0,0 +1,268 @@
+// read, write and fstat are POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "dynamic_array_text.h"
+
+#include "dynamic_array_view.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEXT_BUFFER_SIZE ( (size_t)1 << 16 )
+// the longest formatted int with its sign and separator
+#define TEXT_MAX_FIELD ( sizeof( int ) * CHAR_BIT * 3 / 10 + 3 )
+
+static const char digit_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// writes two digits per division, right to left; the magnitude is taken in
+// unsigned so INT_MIN needs no special case
+static size_t format_int( char *out, const int value ) {
+    char     digits[TEXT_MAX_FIELD];
+    char    *end       = digits + sizeof digits;
+    char    *p         = end;
+    unsigned magnitude = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    while ( magnitude >= 100 ) {
+        p -= 2;
+        memcpy( p, digit_pairs + 2 * ( magnitude % 100 ), 2 );
+        magnitude /= 100;
+    }
+    if ( magnitude >= 10 ) {
+        p -= 2;
+        memcpy( p, digit_pairs + 2 * magnitude, 2 );
+    } else {
+        *--p = (char)( '0' + magnitude );
+    }
+    if ( value < 0 ) { *--p = '-'; }
+    memcpy( out, p, (size_t)( end - p ) );
+    return (size_t)( end - p );
+}
+
+typedef bool ( *text_flush )( void *target, const char *data, const size_t n );
+
+static bool flush_stream( void *target, const char *data, const size_t n ) {
+    return fwrite( data, 1, n, target ) == n;
+}
+
+// write may stop short on pipes and sockets
+static bool flush_fd( void *target, const char *data, const size_t n ) {
+    const int fd = *(const int *)target;
+    for ( size_t done = 0; done < n; ) {
+        ssize_t written = write( fd, data + done, n - done );
+        if ( written < 0 ) {
+            if ( errno == EINTR ) { continue; }
+            return false;
+        }
+        done += (size_t)written;
+    }
+    return true;
+}
+
+// time: O(N), one flush per TEXT_BUFFER_SIZE bytes of output
+static bool format_all( const int *data, const size_t n, const size_t stride,
+                        const char separator, text_flush flush,
+                        void *target ) {
+    char   buffer[TEXT_BUFFER_SIZE];
+    size_t used = 0;
+    for ( size_t i = 0; i < n; i++ ) {
+        if ( used > sizeof buffer - TEXT_MAX_FIELD ) {
+            if ( !flush( target, buffer, used ) ) { return false; }
+            used = 0;
+        }
+        used += format_int( buffer + used, data[i * stride] );
+        buffer[used++] = separator;
+    }
+    return used == 0 || flush( target, buffer, used );
+}
+
+bool dynamic_array_write( const struct dynamic_array *da, FILE *stream,
+                          const char separator ) {
+    assert( da != NULL );
+    assert( stream != NULL );
+    return format_all( da->buffer, da->size, 1, separator, flush_stream,
+                       stream );
+}
+
+bool dynamic_array_write_fd( const struct dynamic_array *da, const int fd,
+                             const char separator ) {
+    assert( da != NULL );
+    int target = fd;
+    return format_all( da->buffer, da->size, 1, separator, flush_fd,
+                       &target );
+}
+
+// the output is unchanged from the printf loop: "%d " per element, then a
+// newline
+void dynamic_array_print( const struct dynamic_array *da ) {
+    assert( da != NULL );
+    (void)dynamic_array_write( da, stdout, ' ' );
+    putchar( '\n' );
+}
+
+bool dynamic_array_view_write( const struct dynamic_array_view view,
+                               FILE *stream, const char separator ) {
+    assert( stream != NULL );
+    return format_all( view.data, view.size, view.stride, separator,
+                       flush_stream, stream );
+}
+
+void dynamic_array_view_print( const struct dynamic_array_view view ) {
+    (void)dynamic_array_view_write( view, stdout, ' ' );
+    putchar( '\n' );
+}
+
+// ' ', '\t', '\n', '\v', '\f' and '\r', as isspace in the C locale
+static inline bool is_space( const char c ) {
+    return c == ' ' || (unsigned char)( c - '\t' ) <= '\r' - '\t';
+}
+
+static inline bool is_digit( const char c ) {
+    return (unsigned char)( c - '0' ) <= 9;
+}
+
+// time: O(N), branchless: a token starts at every non-space after a space
+static size_t count_tokens( const char *text, const size_t length ) {
+    size_t count      = 0;
+    bool   prev_space = true;
+    for ( size_t i = 0; i < length; i++ ) {
+        bool space = is_space( text[i] );
+        count += (size_t)( !space & prev_space );
+        prev_space = space;
+    }
+    return count;
+}
+
+// time: O(N), one reserve
+ptrdiff_t dynamic_array_parse( struct dynamic_array *da, const char *text,
+                               const size_t length ) {
+    assert( da != NULL );
+    assert( text != NULL || length == 0 );
+    const size_t tokens = count_tokens( text, length );
+    if ( tokens == 0 ) { return 0; }
+    assert( tokens <= SIZE_MAX / sizeof *da->buffer - da->size );
+    dynamic_array_unshare( da );
+    dynamic_array_reserve( da, da->size + tokens );
+
+    // converted past the size, so a bad token leaves the elements as they were
+    int        *out = da->buffer + da->size;
+    const char *p   = text;
+    const char *end = text + length;
+    for ( size_t i = 0; i < tokens; i++ ) {
+        while ( is_space( *p ) ) { p++; } // a token is left, so p < end
+        bool negative = *p == '-';
+        if ( *p == '-' || *p == '+' ) { p++; }
+        const uint64_t limit  = (uint64_t)INT_MAX + negative;
+        const char    *digits = p;
+        uint64_t       value  = 0;
+        while ( p < end && is_digit( *p ) ) {
+            value = value * 10 + (uint64_t)( *p++ - '0' );
+            if ( value > limit ) {
+                errno = ERANGE;
+                return -1;
+            }
+        }
+        if ( p == digits || ( p < end && !is_space( *p ) ) ) {
+            errno = EINVAL;
+            return -1;
+        }
+        out[i] = negative ? (int)( -(int64_t)value ) : (int)value;
+    }
+    da->size += tokens;
+    da->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                              DYNAMIC_ARRAY_FLAG_INDEXED );
+    dynamic_array_index_refresh( da );
+    return (ptrdiff_t)tokens;
+}
+
+// fills out and returns the byte count, 0 at end of input or -1 on error
+typedef ptrdiff_t ( *text_fill )( void *source, char *out, const size_t n );
+
+static ptrdiff_t fill_stream( void *source, char *out, const size_t n ) {
+    size_t got = fread( out, 1, n, source );
+    if ( got == 0 && ferror( (FILE *)source ) ) {
+        if ( errno == 0 ) { errno = EIO; }
+        return -1;
+    }
+    return (ptrdiff_t)got;
+}
+
+static ptrdiff_t fill_fd( void *source, char *out, const size_t n ) {
+    ssize_t got;
+    do {
+        got = read( *(const int *)source, out, n );
+    } while ( got < 0 && errno == EINTR );
+    return got;
+}
+
+// Reads all remaining input into one malloc'd buffer. hint is the expected
+// length; a regular file then fits on the first read and its end of file is
+// seen without another reallocation.
+static char *slurp( text_fill fill, void *source, const size_t hint,
+                    size_t *length ) {
+    size_t capacity = hint > 0 ? hint + 1 : TEXT_BUFFER_SIZE;
+    size_t used     = 0;
+    char  *data     = malloc( capacity );
+    if ( data == NULL ) { return NULL; }
+    for ( ;; ) {
+        if ( used == capacity ) {
+            char *grown = realloc( data, capacity * 2 );
+            if ( grown == NULL ) {
+                free( data );
+                return NULL;
+            }
+            data = grown;
+            capacity *= 2;
+        }
+        ptrdiff_t got = fill( source, data + used, capacity - used );
+        if ( got < 0 ) {
+            free( data );
+            return NULL;
+        }
+        if ( got == 0 ) { break; }
+        used += (size_t)got;
+    }
+    *length = used;
+    return data;
+}
+
+static size_t file_size_hint( const int fd ) {
+    struct stat st;
+    if ( fd < 0 || fstat( fd, &st ) != 0 || !S_ISREG( st.st_mode ) ||
+         st.st_size <= 0 ) {
+        return 0;
+    }
+    return (size_t)st.st_size;
+}
+
+static ptrdiff_t read_all( struct dynamic_array *da, text_fill fill,
+                           void *source, const size_t hint ) {
+    size_t length = 0;
+    char  *text   = slurp( fill, source, hint, &length );
+    if ( text == NULL ) { return -1; }
+    ptrdiff_t appended = dynamic_array_parse( da, text, length );
+    free( text );
+    return appended;
+}
+
+ptrdiff_t dynamic_array_read( struct dynamic_array *da, FILE *stream ) {
+    assert( da != NULL );
+    assert( stream != NULL );
+    return read_all( da, fill_stream, stream,
+                     file_size_hint( fileno( stream ) ) );
+}
+
+ptrdiff_t dynamic_array_read_fd( struct dynamic_array *da, const int fd ) {
+    assert( da != NULL );
+    int source = fd;
+    return read_all( da, fill_fd, &source, file_size_hint( fd ) );
+}
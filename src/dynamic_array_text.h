@@ -0,0 +1,41 @@
+#ifndef DYNAMIC_ARRAY_TEXT_H
+#define DYNAMIC_ARRAY_TEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dynamic_array.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Decimal text I/O for the int array. Output is formatted into a 64 KiB
+// buffer without printf and handed to the stream or descriptor in one call
+// per buffer. Input is read whole, its tokens counted, the array reserved
+// once and the integers converted straight into it.
+
+// every element is followed by the separator; return false with errno set
+// on a write error
+extern bool dynamic_array_write( const struct dynamic_array *da, FILE *stream,
+                                 const char separator );
+extern bool dynamic_array_write_fd( const struct dynamic_array *da,
+                                    const int fd, const char separator );
+
+// Appends the whitespace-separated integers of text, each an optional sign
+// and decimal digits. Return how many were appended, or -1 with errno set to
+// EINVAL for a malformed token or ERANGE for one outside int; the elements
+// are then left as they were.
+extern ptrdiff_t dynamic_array_parse( struct dynamic_array *da,
+                                      const char *text, const size_t length );
+// parse the rest of the stream or file; -1 with errno also on a read error
+extern ptrdiff_t dynamic_array_read( struct dynamic_array *da, FILE *stream );
+extern ptrdiff_t dynamic_array_read_fd( struct dynamic_array *da,
+                                        const int             fd );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_TEXT_H
@@ -0,0 +1,214 @@
+#include "dynamic_array_view.h"
+
+#include "dynamic_array_simd.h"
+
+#include <assert.h>
+#include <limits.h>
+
+// a positive stride keeps the elements in array order, so a view of a sorted
+// array is sorted too
+static bool is_sorted( const struct dynamic_array_view view ) {
+    return view.array->flags & DYNAMIC_ARRAY_FLAG_SORTED;
+}
+
+static bool is_contiguous( const struct dynamic_array_view view ) {
+    return view.stride == 1;
+}
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+struct dynamic_array_view dynamic_array_view_of( struct dynamic_array *da ) {
+    assert( da != NULL );
+    return ( struct dynamic_array_view ){
+        .data = da->buffer, .size = da->size, .stride = 1, .array = da };
+}
+
+struct dynamic_array_view dynamic_array_slice( struct dynamic_array *da,
+                                               const size_t          first,
+                                               const size_t          last ) {
+    assert( da != NULL );
+    assert( first <= last && last <= da->size );
+    // an empty array may have no buffer to offset
+    return ( struct dynamic_array_view ){
+        .data   = first == last ? da->buffer : da->buffer + first,
+        .size   = last - first,
+        .stride = 1,
+        .array  = da };
+}
+
+struct dynamic_array_view
+dynamic_array_slice_strided( struct dynamic_array *da, const size_t first,
+                             const size_t count, const size_t stride ) {
+    assert( da != NULL );
+    assert( stride >= 1 );
+    // the last element, first + (count - 1) * stride, is checked without
+    // overflowing
+    assert( count == 0 || first < da->size );
+    assert( count == 0 || count - 1 <= ( da->size - 1 - first ) / stride );
+    return ( struct dynamic_array_view ){
+        .data   = count == 0 ? da->buffer : da->buffer + first,
+        .size   = count,
+        .stride = stride,
+        .array  = da };
+}
+
+struct dynamic_array_view
+dynamic_array_view_slice( const struct dynamic_array_view view,
+                          const size_t first, const size_t last ) {
+    assert( first <= last && last <= view.size );
+    struct dynamic_array_view sub = view;
+    sub.size                      = last - first;
+    if ( sub.size > 0 ) { sub.data = view.data + first * view.stride; }
+    return sub;
+}
+
+// ============================================================================
+// Element access
+// ============================================================================
+
+// the view points into the buffer, so writing can't copy a shared one
+void dynamic_array_view_touch( const struct dynamic_array_view view ) {
+    assert( view.array != NULL );
+    assert( !dynamic_array_is_shared( view.array ) );
+    assert( !( view.array->flags & DYNAMIC_ARRAY_FLAG_FILE ) ||
+            dynamic_array_file_mode( view.array->file ) !=
+                DYNAMIC_ARRAY_FILE_READ_ONLY );
+    view.array->flags &= ~(unsigned)( DYNAMIC_ARRAY_FLAG_SORTED |
+                                      DYNAMIC_ARRAY_FLAG_INDEXED );
+}
+
+int dynamic_array_view_get( const struct dynamic_array_view view,
+                            const size_t                    i ) {
+    return *dynamic_array_view_at( view, i );
+}
+
+void dynamic_array_view_set( const struct dynamic_array_view view,
+                             const size_t i, const int value ) {
+    dynamic_array_view_touch( view );
+    *dynamic_array_view_at( view, i ) = value;
+}
+
+void dynamic_array_view_for_each( const struct dynamic_array_view view,
+                                  void ( *function )( int *element,
+                                                      void *context ),
+                                  void *context ) {
+    assert( function != NULL );
+    dynamic_array_view_touch( view );
+    for ( size_t i = 0; i < view.size; i++ ) {
+        function( view.data + i * view.stride, context );
+    }
+    dynamic_array_index_refresh( view.array );
+}
+
+// ============================================================================
+// Search and fill
+// ============================================================================
+
+// time: O(N), vectorized when contiguous
+ptrdiff_t dynamic_array_view_find( const struct dynamic_array_view view,
+                                   const int                       value ) {
+    if ( is_contiguous( view ) ) {
+        size_t i = dynamic_array_simd_find( view.data, view.size, value );
+        return i == view.size ? -1 : (ptrdiff_t)i;
+    }
+    for ( size_t i = 0; i < view.size; i++ ) {
+        if ( view.data[i * view.stride] == value ) { return (ptrdiff_t)i; }
+    }
+    return -1;
+}
+
+// time: O(N)
+void dynamic_array_view_fill( const struct dynamic_array_view view,
+                              const int                       value ) {
+    dynamic_array_view_touch( view );
+    for ( size_t i = 0; i < view.size; i++ ) {
+        view.data[i * view.stride] = value;
+    }
+    dynamic_array_index_refresh( view.array );
+}
+
+// ============================================================================
+// Reductions
+// ============================================================================
+
+// time: O(N), vectorized when contiguous
+int64_t dynamic_array_view_sum( const struct dynamic_array_view view ) {
+    if ( is_contiguous( view ) ) {
+        return dynamic_array_simd_sum( view.data, view.size );
+    }
+    int64_t sum = 0;
+    for ( size_t i = 0; i < view.size; i++ ) {
+        sum += view.data[i * view.stride];
+    }
+    return sum;
+}
+
+// time: O(1) when the array is sorted, otherwise O(N), vectorized when
+// contiguous
+void dynamic_array_view_minmax( const struct dynamic_array_view view, int *min,
+                                int *max ) {
+    assert( view.size > 0 );
+    assert( min != NULL && max != NULL );
+    if ( is_sorted( view ) ) {
+        *min = view.data[0];
+        *max = view.data[( view.size - 1 ) * view.stride];
+        return;
+    }
+    if ( is_contiguous( view ) ) {
+        dynamic_array_simd_minmax( view.data, view.size, min, max );
+        return;
+    }
+    int lo = INT_MAX;
+    int hi = INT_MIN;
+    for ( size_t i = 0; i < view.size; i++ ) {
+        const int value = view.data[i * view.stride];
+        lo              = value < lo ? value : lo;
+        hi              = value > hi ? value : hi;
+    }
+    *min = lo;
+    *max = hi;
+}
+
+// time: as minmax
+int dynamic_array_view_min( const struct dynamic_array_view view ) {
+    assert( view.size > 0 );
+    if ( is_sorted( view ) ) { return view.data[0]; }
+    if ( is_contiguous( view ) ) {
+        return dynamic_array_simd_min( view.data, view.size );
+    }
+    int min;
+    int max;
+    dynamic_array_view_minmax( view, &min, &max );
+    return min;
+}
+
+int dynamic_array_view_max( const struct dynamic_array_view view ) {
+    assert( view.size > 0 );
+    if ( is_sorted( view ) ) {
+        return view.data[( view.size - 1 ) * view.stride];
+    }
+    if ( is_contiguous( view ) ) {
+        return dynamic_array_simd_max( view.data, view.size );
+    }
+    int min;
+    int max;
+    dynamic_array_view_minmax( view, &min, &max );
+    return max;
+}
+
+// time: O(1) when sorted, otherwise O(N); the first minimum
+size_t dynamic_array_view_argmin( const struct dynamic_array_view view ) {
+    assert( view.size > 0 );
+    if ( is_sorted( view ) ) { return 0; }
+    return (size_t)dynamic_array_view_find( view,
+                                            dynamic_array_view_min( view ) );
+}
+
+// time: O(N); the first maximum
+size_t dynamic_array_view_argmax( const struct dynamic_array_view view ) {
+    assert( view.size > 0 );
+    return (size_t)dynamic_array_view_find( view,
+                                            dynamic_array_view_max( view ) );
+}
@@ -0,0 +1,102 @@
+#ifndef DYNAMIC_ARRAY_VIEW_H
+#define DYNAMIC_ARRAY_VIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dynamic_array.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Zero-copy views of the int array: element i of a view is
+// data[i * stride]. A view borrows the array's buffer, so it is invalidated
+// by anything that may move the buffer: push, push_n, insert or extend past
+// the capacity, expand, reserve, shrink_to_fit, release and destroy.
+// Elements past a shrunk size are stale. set, fill and sort never
+// reallocate, so views stay valid across them; so do pop and the removals
+// unless the growth policy shrinks (shrink_divisor).
+// The view functions that write clear the array's SORTED and INDEXED flags;
+// fill, sort and for_each then rebuild a hash index, set leaves it stale for
+// dynamic_array_index_refresh. Code storing through dynamic_array_view_at
+// must call dynamic_array_view_touch itself. An array shared with clones must
+// be unshared before it is written through a view.
+struct dynamic_array_view {
+    int                  *data;
+    size_t                size;
+    size_t                stride; // in elements, >= 1
+    struct dynamic_array *array;  // the owner, for its flags
+};
+
+// time: O(1); the whole array, or its elements [first, last)
+extern struct dynamic_array_view
+dynamic_array_view_of( struct dynamic_array *da );
+extern struct dynamic_array_view
+dynamic_array_slice( struct dynamic_array *da, const size_t first,
+                     const size_t last );
+// count elements from first, every stride-th one
+extern struct dynamic_array_view
+dynamic_array_slice_strided( struct dynamic_array *da, const size_t first,
+                             const size_t count, const size_t stride );
+// elements [first, last) of a view
+extern struct dynamic_array_view
+dynamic_array_view_slice( const struct dynamic_array_view view,
+                          const size_t first, const size_t last );
+
+// Iteration: for ( size_t i = 0; i < view.size; i++ ) with
+// *dynamic_array_view_at( view, i ), or a callback per element; for_each
+// touches the view, since the callback may write.
+static inline int *dynamic_array_view_at( const struct dynamic_array_view view,
+                                          const size_t                    i ) {
+    assert( i < view.size );
+    return view.data + i * view.stride;
+}
+
+// marks the owner as modified: no longer sorted, hash index stale
+extern void dynamic_array_view_touch( const struct dynamic_array_view view );
+extern int  dynamic_array_view_get( const struct dynamic_array_view view,
+                                    const size_t                    i );
+extern void dynamic_array_view_set( const struct dynamic_array_view view,
+                                    const size_t i, const int value );
+extern void dynamic_array_view_for_each( const struct dynamic_array_view view,
+                                         void ( *function )( int *element,
+                                                             void *context ),
+                                         void *context );
+
+// positions are view positions; -1 when absent
+extern ptrdiff_t dynamic_array_view_find( const struct dynamic_array_view view,
+                                          const int value );
+extern void      dynamic_array_view_fill( const struct dynamic_array_view view,
+                                          const int value );
+
+// as the array reductions; min, max and the arg variants require a
+// non-empty view
+extern int64_t dynamic_array_view_sum( const struct dynamic_array_view view );
+extern int     dynamic_array_view_min( const struct dynamic_array_view view );
+extern int     dynamic_array_view_max( const struct dynamic_array_view view );
+extern void dynamic_array_view_minmax( const struct dynamic_array_view view,
+                                       int *min, int *max );
+extern size_t
+dynamic_array_view_argmin( const struct dynamic_array_view view );
+extern size_t
+dynamic_array_view_argmax( const struct dynamic_array_view view );
+
+// sorts the viewed elements in place, leaving the rest of the array alone;
+// defined with the array sort in dynamic_array.c
+extern void dynamic_array_view_sort( const struct dynamic_array_view view );
+
+// as dynamic_array_write and dynamic_array_print; defined in
+// dynamic_array_text.c
+extern bool dynamic_array_view_write( const struct dynamic_array_view view,
+                                      FILE *stream, const char separator );
+extern void dynamic_array_view_print( const struct dynamic_array_view view );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DYNAMIC_ARRAY_VIEW_H
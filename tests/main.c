@@ -10,11 +10,51 @@
  *
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "../src/dynamic_array.h"
+#include "../src/dynamic_array_concurrent.h"
+#include "../src/dynamic_array_frozen.h"
+#include "../src/dynamic_array_parallel.h"
+#include "../src/dynamic_array_set.h"
+#include "../src/dynamic_array_simd.h"
+#include "../src/dynamic_array_text.h"
+#include "../src/dynamic_array_view.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define DYNAMIC_ARRAY_NAME   u8_array
+#define DYNAMIC_ARRAY_TYPE   uint8_t
+#define DYNAMIC_ARRAY_STATIC 1
+#include "../src/dynamic_array_template.h"
+
+#define DYNAMIC_ARRAY_NAME   i64_array
+#define DYNAMIC_ARRAY_TYPE   int64_t
+#define DYNAMIC_ARRAY_STATIC 1
+#include "../src/dynamic_array_template.h"
+
+#define DYNAMIC_ARRAY_NAME            small_array
+#define DYNAMIC_ARRAY_TYPE            int
+#define DYNAMIC_ARRAY_INLINE_CAPACITY 16
+#define DYNAMIC_ARRAY_STATIC          1
+#include "../src/dynamic_array_template.h"
+
+struct point {
+    short x;
+    short y;
+};
+
+#define DYNAMIC_ARRAY_NAME          point_array
+#define DYNAMIC_ARRAY_TYPE          struct point
+#define DYNAMIC_ARRAY_EQUAL( a, b ) ( ( a ).x == ( b ).x && ( a ).y == ( b ).y )
+#define DYNAMIC_ARRAY_STATIC        1
+#include "../src/dynamic_array_template.h"
 
 // Test counters
 int tests_run    = 0;
@@ -32,6 +72,31 @@ int tests_passed = 0;
         }                                                                      \
     } while ( 0 )
 
+// Allocator that counts calls, for checking when arrays touch the heap
+struct counting_context {
+    int allocs;
+    int reallocs;
+    int frees;
+};
+
+static void *counting_alloc( void *context, const size_t size ) {
+    ( (struct counting_context *)context )->allocs++;
+    return malloc( size );
+}
+
+static void *counting_realloc( void *context, void *ptr, const size_t old_size,
+                               const size_t new_size ) {
+    (void)old_size;
+    ( (struct counting_context *)context )->reallocs++;
+    return realloc( ptr, new_size );
+}
+
+static void counting_free( void *context, void *ptr, const size_t size ) {
+    (void)size;
+    ( (struct counting_context *)context )->frees++;
+    free( ptr );
+}
+
 // ============================================================================
 // Creation and Initialization Tests
 // ============================================================================
@@ -40,8 +105,12 @@ void test_create_and_init() {
     struct dynamic_array *da = dynamic_array_create();
     TEST_ASSERT( da != NULL, "create returns non-NULL pointer" );
     TEST_ASSERT( da->size == 0, "new array has size 0" );
-    TEST_ASSERT( da->capacity == 8, "new array has default capacity 8" );
-    TEST_ASSERT( da->buffer != NULL, "new array has allocated buffer" );
+    TEST_ASSERT( da->capacity == 0, "new array has no capacity" );
+    TEST_ASSERT( da->buffer == NULL, "new array allocates no buffer" );
+
+    dynamic_array_push( da, 1 );
+    TEST_ASSERT( da->capacity == 8, "first push allocates default capacity" );
+    TEST_ASSERT( da->buffer != NULL, "first push allocates buffer" );
     dynamic_array_destroy( da );
 }
 
@@ -49,9 +118,9 @@ void test_init_on_existing() {
     struct dynamic_array da;
     dynamic_array_init( &da );
     TEST_ASSERT( da.size == 0, "init sets size to 0" );
-    TEST_ASSERT( da.capacity == 8, "init sets capacity to 8" );
-    TEST_ASSERT( da.buffer != NULL, "init allocates buffer" );
-    dynamic_array_clear( &da );
+    TEST_ASSERT( da.capacity == 0, "init sets capacity to 0" );
+    TEST_ASSERT( da.buffer == NULL, "init does not allocate" );
+    dynamic_array_release( &da );
 }
 
 // ============================================================================
@@ -113,6 +182,182 @@ void test_pop_multiple() {
     dynamic_array_destroy( da );
 }
 
+// ============================================================================
+// Bulk Push and Pop Tests
+// ============================================================================
+
+void test_push_n() {
+    struct dynamic_array *da = dynamic_array_create();
+    int                   values[100];
+    for ( int i = 0; i < 100; i++ ) { values[i] = i; }
+
+    dynamic_array_push( da, -1 );
+    dynamic_array_push_n( da, values, 100 );
+
+    TEST_ASSERT( da->size == 101, "push_n appends all values" );
+    TEST_ASSERT( da->capacity == 128, "push_n grows to next doubling" );
+    TEST_ASSERT( da->buffer[0] == -1, "push_n keeps existing values" );
+    TEST_ASSERT( da->buffer[1] == 0 && da->buffer[100] == 99,
+                 "push_n stores values in order" );
+
+    dynamic_array_push_n( da, NULL, 0 );
+    TEST_ASSERT( da->size == 101, "push_n of zero elements is a no-op" );
+
+    dynamic_array_destroy( da );
+}
+
+void test_extend() {
+    struct dynamic_array *dst = dynamic_array_create();
+    struct dynamic_array *src = dynamic_array_create();
+    for ( int i = 0; i < 3; i++ ) { dynamic_array_push( dst, i ); }
+    for ( int i = 3; i < 20; i++ ) { dynamic_array_push( src, i ); }
+
+    dynamic_array_extend( dst, src );
+    TEST_ASSERT( dst->size == 20, "extend appends source array" );
+    TEST_ASSERT( dst->buffer[3] == 3 && dst->buffer[19] == 19,
+                 "extend preserves source order" );
+    TEST_ASSERT( src->size == 17, "extend leaves source untouched" );
+
+    dynamic_array_extend( dst, dst );
+    TEST_ASSERT( dst->size == 40, "extend with itself doubles contents" );
+    TEST_ASSERT( dst->buffer[20] == 0 && dst->buffer[39] == 19,
+                 "self extend copies original contents" );
+
+    dynamic_array_destroy( src );
+    dynamic_array_destroy( dst );
+}
+
+void test_pop_n() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 10; i++ ) { dynamic_array_push( da, i ); }
+
+    int out[4] = { 0 };
+    dynamic_array_pop_n( da, out, 4 );
+    TEST_ASSERT( da->size == 6, "pop_n removes n elements" );
+    TEST_ASSERT( out[0] == 6 && out[3] == 9,
+                 "pop_n copies elements in array order" );
+
+    dynamic_array_pop_n( da, NULL, 6 );
+    TEST_ASSERT( da->size == 0, "pop_n with NULL out discards elements" );
+
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Insert and Remove Tests
+// ============================================================================
+
+void test_insert_remove() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 10; i++ ) { dynamic_array_push( da, i ); }
+
+    dynamic_array_insert( da, 0, -1 );
+    dynamic_array_insert( da, 5, 100 );
+    dynamic_array_insert( da, da->size, 200 );
+    TEST_ASSERT( da->size == 13 && da->buffer[0] == -1 &&
+                     da->buffer[5] == 100 && da->buffer[6] == 4 &&
+                     da->buffer[12] == 200,
+                 "insert shifts the tail at front, middle and end" );
+
+    TEST_ASSERT( dynamic_array_remove( da, 5 ) == 100 && da->buffer[5] == 4,
+                 "remove returns the element and closes the gap" );
+    TEST_ASSERT( dynamic_array_remove( da, 0 ) == -1 && da->buffer[0] == 0,
+                 "remove at front shifts everything down" );
+
+    dynamic_array_destroy( da );
+}
+
+void test_insert_remove_range() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 6; i++ ) { dynamic_array_push( da, i ); }
+
+    const int values[] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+    dynamic_array_insert_range( da, 2, values, 10 );
+    TEST_ASSERT( da->size == 16 && da->capacity == 16,
+                 "insert_range grows once to fit the range" );
+    TEST_ASSERT( da->buffer[1] == 1 && da->buffer[2] == 10 &&
+                     da->buffer[11] == 19 && da->buffer[12] == 2 &&
+                     da->buffer[15] == 5,
+                 "insert_range places the range before index" );
+
+    dynamic_array_remove_range( da, 2, 12 );
+    bool same = da->size == 6;
+    for ( size_t i = 0; i < da->size; i++ ) {
+        same = same && da->buffer[i] == (int)i;
+    }
+    TEST_ASSERT( same, "remove_range undoes insert_range" );
+
+    dynamic_array_remove_range( da, 3, 3 );
+    dynamic_array_insert_range( da, 3, NULL, 0 );
+    TEST_ASSERT( da->size == 6, "empty ranges are no-ops" );
+
+    dynamic_array_remove_range( da, 0, da->size );
+    TEST_ASSERT( da->size == 0, "remove_range can empty the array" );
+
+    dynamic_array_destroy( da );
+}
+
+static bool is_multiple( const int value, void *context ) {
+    return value % *(int *)context == 0;
+}
+
+void test_remove_if_retain_if() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, i ); }
+
+    int    three   = 3;
+    size_t removed = dynamic_array_remove_if( da, is_multiple, &three );
+    bool   ordered = true;
+    for ( size_t i = 1; i < da->size; i++ ) {
+        ordered = ordered && da->buffer[i - 1] < da->buffer[i] &&
+                  da->buffer[i] % 3 != 0;
+    }
+    TEST_ASSERT( removed == 34 && da->size == 66,
+                 "remove_if removes every match" );
+    TEST_ASSERT( ordered, "remove_if keeps the order of the rest" );
+
+    int two = 2;
+    removed = dynamic_array_retain_if( da, is_multiple, &two );
+    TEST_ASSERT( removed == 33 && da->size == 33 && da->buffer[0] == 2 &&
+                     da->buffer[32] == 98,
+                 "retain_if keeps only the matches" );
+
+    dynamic_array_destroy( da );
+}
+
+// the compaction kernels must agree with a plain loop at every level, for
+// match densities from none to all
+void test_remove_value_simd_levels() {
+    enum dynamic_array_simd_level best  = dynamic_array_simd_detect();
+    bool                          agree = true;
+    int                           expected[300];
+
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        for ( size_t n = 0; n < 300; n += ( n < 40 ? 1 : 37 ) ) {
+            for ( int modulus = 1; modulus <= 5; modulus++ ) {
+                struct dynamic_array *da = dynamic_array_create();
+                size_t                kept = 0;
+                for ( size_t i = 0; i < n; i++ ) {
+                    int value = (int)( ( i * 7919 ) % (size_t)modulus );
+                    dynamic_array_push( da, value );
+                    if ( value != 0 ) { expected[kept++] = value; }
+                }
+                size_t removed = dynamic_array_remove_value( da, 0 );
+                agree = agree && removed == n - kept && da->size == kept;
+                for ( size_t i = 0; i < kept && agree; i++ ) {
+                    agree = da->buffer[i] == expected[i];
+                }
+                dynamic_array_destroy( da );
+            }
+        }
+    }
+    dynamic_array_simd_set_level( best );
+
+    TEST_ASSERT( agree, "remove_value matches the scalar reference" );
+}
+
 // ============================================================================
 // Size and Capacity Tests
 // ============================================================================
@@ -120,13 +365,14 @@ void test_pop_multiple() {
 void test_size_capacity_queries() {
     struct dynamic_array *da = dynamic_array_create();
     TEST_ASSERT( dynamic_array_size( da ) == 0, "size query works on empty" );
-    TEST_ASSERT( dynamic_array_capacity( da ) == 8, "capacity query works" );
+    TEST_ASSERT( dynamic_array_capacity( da ) == 0, "capacity query works" );
 
     for ( int i = 0; i < 3; i++ ) { dynamic_array_push( da, i ); }
 
     TEST_ASSERT( dynamic_array_size( da ) == 3,
                  "size reflects pushed elements" );
-    TEST_ASSERT( dynamic_array_capacity( da ) == 8, "capacity unchanged" );
+    TEST_ASSERT( dynamic_array_capacity( da ) == 8,
+                 "capacity is default after first pushes" );
 
     dynamic_array_destroy( da );
 }
@@ -246,6 +492,446 @@ void test_find_duplicates() {
     dynamic_array_destroy( da );
 }
 
+void test_find_last_count_all() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 50; i++ ) { dynamic_array_push( da, i % 7 ); }
+
+    TEST_ASSERT( dynamic_array_find_last( da, 3 ) == 45,
+                 "find_last returns last occurrence" );
+    TEST_ASSERT( dynamic_array_find_last( da, 99 ) == -1,
+                 "find_last returns -1 for missing value" );
+    TEST_ASSERT( dynamic_array_count( da, 3 ) == 7, "count counts matches" );
+    TEST_ASSERT( dynamic_array_count( da, 99 ) == 0,
+                 "count returns 0 for missing value" );
+
+    size_t indices[4];
+    size_t total = dynamic_array_find_all( da, 0, indices, 4 );
+    TEST_ASSERT( total == 8, "find_all returns total matches" );
+    TEST_ASSERT( indices[0] == 0 && indices[3] == 21,
+                 "find_all writes indices in order up to max" );
+
+    dynamic_array_destroy( da );
+}
+
+// every kernel level must agree with a plain loop, including lengths that
+// leave a partial vector at the tail
+void test_find_simd_levels() {
+    enum dynamic_array_simd_level best  = dynamic_array_simd_detect();
+    bool                          agree = true;
+    size_t                        indices[1100];
+
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        for ( size_t n = 0; n < 1100; n += ( n < 80 ? 1 : 97 ) ) {
+            struct dynamic_array *da = dynamic_array_create();
+            for ( size_t i = 0; i < n; i++ ) {
+                dynamic_array_push( da, (int)( ( i * 7919 ) % 13 ) );
+            }
+            for ( int value = 0; value < 14; value++ ) {
+                ptrdiff_t first = -1, last = -1;
+                size_t    count = 0;
+                for ( size_t i = 0; i < n; i++ ) {
+                    if ( da->buffer[i] != value ) { continue; }
+                    if ( first < 0 ) { first = (ptrdiff_t)i; }
+                    last = (ptrdiff_t)i;
+                    count++;
+                }
+                agree = agree && dynamic_array_find( da, value ) == first;
+                agree = agree && dynamic_array_find_last( da, value ) == last;
+                agree = agree && dynamic_array_count( da, value ) == count;
+                agree = agree && dynamic_array_find_all( da, value, indices,
+                                                         1100 ) == count;
+                if ( count > 0 ) {
+                    agree = agree && indices[0] == (size_t)first &&
+                            indices[count - 1] == (size_t)last;
+                }
+            }
+            dynamic_array_destroy( da );
+        }
+    }
+    dynamic_array_simd_set_level( best );
+
+    TEST_ASSERT( agree, "all SIMD levels match the scalar reference" );
+}
+
+// ============================================================================
+// Reduction Tests
+// ============================================================================
+
+void test_reductions() {
+    struct dynamic_array *da     = dynamic_array_create();
+    const int             data[] = { 4, -7, 9, 2, -7, 9, 0 };
+    dynamic_array_push_n( da, data, 7 );
+    TEST_ASSERT( dynamic_array_sum( da ) == 10, "sum adds every element" );
+    int min = 0, max = 0;
+    dynamic_array_minmax( da, &min, &max );
+    TEST_ASSERT( dynamic_array_min( da ) == -7 &&
+                     dynamic_array_max( da ) == 9 && min == -7 && max == 9,
+                 "min, max and minmax agree" );
+    TEST_ASSERT( dynamic_array_argmin( da ) == 1 &&
+                     dynamic_array_argmax( da ) == 2,
+                 "argmin and argmax return the first extreme" );
+
+    dynamic_array_sort( da );
+    TEST_ASSERT( dynamic_array_min( da ) == -7 &&
+                     dynamic_array_max( da ) == 9 &&
+                     dynamic_array_argmin( da ) == 0 &&
+                     dynamic_array_argmax( da ) == 5,
+                 "sorted arrays answer from the ends" );
+
+    dynamic_array_clear( da );
+    TEST_ASSERT( dynamic_array_sum( da ) == 0, "an empty sum is 0" );
+    for ( int i = 0; i < 1000; i++ ) { dynamic_array_push( da, INT_MAX ); }
+    TEST_ASSERT( dynamic_array_sum( da ) == (int64_t)INT_MAX * 1000,
+                 "sum accumulates past the int range" );
+    dynamic_array_fill( da, INT_MIN );
+    TEST_ASSERT( dynamic_array_sum( da ) == (int64_t)INT_MIN * 1000,
+                 "sum accumulates past the negative int range" );
+    dynamic_array_destroy( da );
+}
+
+// every kernel level must agree with a plain loop over the full int range,
+// including the empty range and partial vectors at the tail
+void test_reductions_simd_levels() {
+    enum dynamic_array_simd_level best  = dynamic_array_simd_detect();
+    bool                          agree = true;
+    int                           data[1100];
+    uint32_t                      state = 12345;
+    for ( size_t i = 0; i < 1100; i++ ) {
+        state   = state * 1664525u + 1013904223u;
+        data[i] = (int)state;
+    }
+
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        for ( size_t n = 0; n < 1100; n += ( n < 80 ? 1 : 97 ) ) {
+            int64_t sum = 0;
+            int     min = INT_MAX, max = INT_MIN;
+            size_t  argmin = n, argmax = n;
+            for ( size_t i = 0; i < n; i++ ) {
+                sum += data[i];
+                if ( data[i] < min ) {
+                    min    = data[i];
+                    argmin = i;
+                }
+                if ( data[i] > max ) {
+                    max    = data[i];
+                    argmax = i;
+                }
+            }
+            int lo = 0, hi = 0;
+            dynamic_array_simd_minmax( data, n, &lo, &hi );
+            agree = agree && dynamic_array_simd_sum( data, n ) == sum;
+            agree = agree && dynamic_array_simd_min( data, n ) == min;
+            agree = agree && dynamic_array_simd_max( data, n ) == max;
+            agree = agree && lo == min && hi == max;
+            agree = agree && dynamic_array_simd_argmin( data, n ) == argmin;
+            agree = agree && dynamic_array_simd_argmax( data, n ) == argmax;
+        }
+    }
+    dynamic_array_simd_set_level( best );
+
+    TEST_ASSERT( agree, "reductions match the scalar reference" );
+}
+
+// ============================================================================
+// Hash Index Tests
+// ============================================================================
+
+static ptrdiff_t linear_find( const struct dynamic_array *da,
+                              const int                   value ) {
+    for ( size_t i = 0; i < da->size; i++ ) {
+        if ( da->buffer[i] == value ) { return (ptrdiff_t)i; }
+    }
+    return -1;
+}
+
+void test_index_find() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 1000; i++ ) { dynamic_array_push( da, i % 300 ); }
+    TEST_ASSERT( dynamic_array_index_memory( da ) == 0,
+                 "arrays start without an index" );
+    TEST_ASSERT( dynamic_array_index_enable( da ) &&
+                     dynamic_array_index_memory( da ) > 0,
+                 "enable builds the index and reports its memory" );
+    bool first = true;
+    for ( int value = 0; value < 300; value++ ) {
+        first = first && dynamic_array_find( da, value ) == value;
+    }
+    TEST_ASSERT( first, "indexed find returns the first occurrence" );
+    TEST_ASSERT( dynamic_array_find( da, 300 ) == -1 &&
+                     dynamic_array_find( da, -1 ) == -1,
+                 "indexed find reports absent values" );
+    dynamic_array_index_disable( da );
+    TEST_ASSERT( dynamic_array_index_memory( da ) == 0 &&
+                     dynamic_array_find( da, 299 ) == 299,
+                 "disable falls back to the scan" );
+    dynamic_array_destroy( da );
+}
+
+void test_index_maintenance() {
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_index_enable( da );
+    for ( int i = 0; i < 5000; i++ ) { dynamic_array_push( da, i / 2 ); }
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, 2499 ) == 4998,
+                 "push keeps the index current as it grows" );
+
+    dynamic_array_push( da, -5 );
+    dynamic_array_pop( da );
+    dynamic_array_pop( da );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -5 ) == -1 &&
+                     dynamic_array_find( da, 2499 ) == 4998,
+                 "pop drops only the last occurrence of a value" );
+
+    dynamic_array_set( da, 11, -7 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -7 ) == 11 &&
+                     dynamic_array_find( da, 5 ) == 10,
+                 "set of a later copy keeps the index current" );
+    dynamic_array_set( da, 10, -7 );
+    TEST_ASSERT( !( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ),
+                 "set of a first occurrence marks the index stale" );
+    TEST_ASSERT( dynamic_array_find( da, 5 ) == -1 &&
+                     dynamic_array_find( da, -7 ) == 10 &&
+                     !( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ),
+                 "find scans past a stale index without rebuilding it" );
+    TEST_ASSERT( dynamic_array_index_refresh( da ) &&
+                     ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, 5 ) == -1 &&
+                     dynamic_array_find( da, -7 ) == 10,
+                 "refresh rebuilds a stale index" );
+
+    dynamic_array_remove( da, 0 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, 0 ) == 0 &&
+                     dynamic_array_find( da, 1 ) == 1 &&
+                     dynamic_array_find( da, -7 ) == 9,
+                 "remove keeps the index current" );
+    dynamic_array_insert( da, 3, -7 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -7 ) == 3 &&
+                     dynamic_array_find( da, 2 ) == 4,
+                 "insert keeps the index current" );
+    dynamic_array_insert( da, 0, 2499 );
+    dynamic_array_remove( da, 0 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, 2499 ) ==
+                         (ptrdiff_t)dynamic_array_size( da ) - 1,
+                 "removing a first occurrence falls back to the next copy" );
+
+    const int tail[] = { 8, 8, -9 };
+    dynamic_array_push_n( da, tail, 3 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -9 ) ==
+                         (ptrdiff_t)dynamic_array_size( da ) - 1,
+                 "push_n keeps the index current" );
+    dynamic_array_pop_n( da, NULL, 3 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -9 ) == -1 &&
+                     dynamic_array_find( da, 8 ) == 16,
+                 "pop_n keeps the index current" );
+
+    dynamic_array_sort( da );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -7 ) == 0 &&
+                     dynamic_array_find( da, 0 ) == 3,
+                 "sort rebuilds the index" );
+    dynamic_array_remove_range( da, 0, 3 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -7 ) == -1 &&
+                     dynamic_array_find( da, 0 ) == 0,
+                 "bulk changes rebuild the index" );
+
+    bool kept = true;
+    for ( int round = 0; round < 3; round++ ) {
+        dynamic_array_reset( da );
+        kept = kept && ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+               dynamic_array_find( da, 0 ) == -1;
+        for ( int i = 0; i < 10; i++ ) { dynamic_array_push( da, 9 - i ); }
+        kept = kept && ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+               dynamic_array_find( da, 0 ) == 9;
+    }
+    dynamic_array_release( da );
+    TEST_ASSERT( kept && ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, 0 ) == -1,
+                 "reset and release keep an empty index" );
+
+    dynamic_array_index_disable( da );
+    TEST_ASSERT( !dynamic_array_index_refresh( da ),
+                 "refresh without an index fails" );
+    dynamic_array_destroy( da );
+}
+
+// random edits against a linear scan, including operations the index can
+// only follow by rebuilding, refreshed now and then
+void test_index_random() {
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_index_enable( da );
+    uint32_t state = 99;
+    bool     agree = true;
+    for ( int step = 0; step < 20000 && agree; step++ ) {
+        state          = state * 1664525u + 1013904223u;
+        uint32_t r     = state >> 8;
+        int      value = (int)( r % 64 ) - 32;
+        size_t   size  = dynamic_array_size( da );
+        switch ( r % 8 ) {
+            case 0:
+            case 1:
+            case 2: dynamic_array_push( da, value ); break;
+            case 3:
+                if ( size > 0 ) { dynamic_array_pop( da ); }
+                break;
+            case 4:
+                if ( size > 0 ) { dynamic_array_set( da, r % size, value ); }
+                break;
+            case 5:
+                if ( size > 0 && r % 8 == 0 ) {
+                    dynamic_array_remove( da, r % size );
+                }
+                break;
+            case 6:
+                if ( r % 16 == 0 ) {
+                    dynamic_array_insert( da, r % ( size + 1 ), value );
+                }
+                break;
+            case 7: dynamic_array_find_transposition( da, value ); break;
+        }
+        if ( r % 32 == 0 ) { dynamic_array_index_refresh( da ); }
+        agree = dynamic_array_find( da, value ) == linear_find( da, value );
+    }
+    TEST_ASSERT( agree, "indexed find matches a linear scan under edits" );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Sorting and Binary Search Tests
+// ============================================================================
+
+static int compare_ints( const void *a, const void *b ) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return ( x > y ) - ( x < y );
+}
+
+void test_sort() {
+    // sizes on both sides of the insertion sort cutoff, with value ranges
+    // that let the radix sort skip some passes
+    const size_t sizes[]  = { 0, 1, 2, 63, 64, 1000, 5000 };
+    const int    ranges[] = { 0, 7, 1000, 1 << 20 };
+    bool         agree    = true;
+    unsigned     seed     = 12345;
+    int          expected[5000];
+
+    for ( size_t s = 0; s < sizeof sizes / sizeof *sizes; s++ ) {
+        for ( size_t r = 0; r < sizeof ranges / sizeof *ranges; r++ ) {
+            struct dynamic_array *da = dynamic_array_create();
+            for ( size_t i = 0; i < sizes[s]; i++ ) {
+                seed      = seed * 1103515245u + 12345u;
+                int value = ranges[r] ? (int)( seed >> 8 ) % ranges[r]
+                                      : (int)seed;
+                if ( i % 97 == 1 ) { value = -2147483647 - 1; }
+                if ( i % 89 == 2 ) { value = 2147483647; }
+                dynamic_array_push( da, value );
+                expected[i] = value;
+            }
+            qsort( expected, sizes[s], sizeof *expected, compare_ints );
+            dynamic_array_sort( da );
+            for ( size_t i = 0; i < sizes[s]; i++ ) {
+                agree = agree && da->buffer[i] == expected[i];
+            }
+            agree = agree && dynamic_array_is_sorted( da );
+            dynamic_array_destroy( da );
+        }
+    }
+    TEST_ASSERT( agree, "sort matches qsort including INT_MIN and INT_MAX" );
+}
+
+void test_sorted_flag() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, 99 - i ); }
+    TEST_ASSERT( !dynamic_array_is_sorted( da ), "new array is not sorted" );
+
+    dynamic_array_sort( da );
+    TEST_ASSERT( dynamic_array_is_sorted( da ), "sort sets the sorted flag" );
+    dynamic_array_pop( da );
+    dynamic_array_remove( da, 0 );
+    dynamic_array_remove_value( da, 50 );
+    TEST_ASSERT( dynamic_array_is_sorted( da ),
+                 "removals keep the sorted flag" );
+
+    dynamic_array_set( da, 0, 1000 );
+    TEST_ASSERT( !dynamic_array_is_sorted( da ), "set clears the sorted flag" );
+    dynamic_array_sort( da );
+    dynamic_array_push( da, -5 );
+    TEST_ASSERT( !dynamic_array_is_sorted( da ),
+                 "push clears the sorted flag" );
+    dynamic_array_sort( da );
+    dynamic_array_rotate_left_n( da, 3 );
+    TEST_ASSERT( !dynamic_array_is_sorted( da ),
+                 "rotation clears the sorted flag" );
+
+    dynamic_array_destroy( da );
+}
+
+void test_binary_search() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 1000; i++ ) {
+        dynamic_array_push( da, ( i / 4 ) * 2 );
+    }
+    dynamic_array_sort( da );
+
+    TEST_ASSERT( dynamic_array_lower_bound( da, 10 ) == 20 &&
+                     dynamic_array_upper_bound( da, 10 ) == 24,
+                 "bounds bracket the run of equal values" );
+    TEST_ASSERT( dynamic_array_lower_bound( da, 11 ) == 24 &&
+                     dynamic_array_upper_bound( da, 11 ) == 24,
+                 "bounds of a missing value meet at its slot" );
+    TEST_ASSERT( dynamic_array_lower_bound( da, -1 ) == 0 &&
+                     dynamic_array_upper_bound( da, 5000 ) == 1000,
+                 "bounds clamp to the ends" );
+    TEST_ASSERT( dynamic_array_binary_search( da, 498 ) &&
+                     !dynamic_array_binary_search( da, 499 ),
+                 "binary_search reports membership" );
+
+    TEST_ASSERT( dynamic_array_find( da, 10 ) == 20 &&
+                     dynamic_array_find_last( da, 10 ) == 23 &&
+                     dynamic_array_count( da, 10 ) == 4 &&
+                     dynamic_array_find( da, 11 ) == -1,
+                 "find family uses the sorted order" );
+    size_t indices[2];
+    TEST_ASSERT( dynamic_array_find_all( da, 10, indices, 2 ) == 4 &&
+                     indices[0] == 20 && indices[1] == 21,
+                 "sorted find_all returns the run" );
+
+    dynamic_array_destroy( da );
+}
+
+void test_insert_sorted() {
+    struct dynamic_array *da       = dynamic_array_create();
+    const int             values[] = { 5, 1, 4, 1, 5, 9, 2, 6, 5, 3 };
+    for ( size_t i = 0; i < 10; i++ ) {
+        dynamic_array_insert_sorted( da, values[i] );
+    }
+    bool ordered = da->size == 10;
+    for ( size_t i = 1; i < da->size; i++ ) {
+        ordered = ordered && da->buffer[i - 1] <= da->buffer[i];
+    }
+    TEST_ASSERT( ordered, "insert_sorted keeps ascending order" );
+    TEST_ASSERT( dynamic_array_insert_sorted( da, 5 ) == 8,
+                 "insert_sorted goes after equal elements" );
+
+    dynamic_array_sort( da );
+    dynamic_array_insert_sorted( da, 0 );
+    TEST_ASSERT( dynamic_array_is_sorted( da ) && da->buffer[0] == 0,
+                 "insert_sorted keeps the sorted flag" );
+
+    dynamic_array_destroy( da );
+}
+
 // ============================================================================
 // Fill Tests
 // ============================================================================
@@ -334,6 +1020,53 @@ void test_rotate_wrap_around() {
     dynamic_array_destroy( da );
 }
 
+void test_rotate_n_matches_single_steps() {
+    struct dynamic_array *a = dynamic_array_create();
+    struct dynamic_array *b = dynamic_array_create();
+    for ( int i = 0; i < 37; i++ ) {
+        dynamic_array_push( a, i );
+        dynamic_array_push( b, i );
+    }
+
+    dynamic_array_rotate_right_n( a, 1000 ); // 1000 mod 37 == 1
+    dynamic_array_rotate_right( b );
+    bool same = true;
+    for ( size_t i = 0; i < a->size; i++ ) {
+        same = same && a->buffer[i] == b->buffer[i];
+    }
+    TEST_ASSERT( same, "rotate_right_n with large count matches one step" );
+
+    dynamic_array_rotate_left_n( a, 15 );
+    for ( int i = 0; i < 15; i++ ) { dynamic_array_rotate_left( b ); }
+    same = true;
+    for ( size_t i = 0; i < a->size; i++ ) {
+        same = same && a->buffer[i] == b->buffer[i];
+    }
+    TEST_ASSERT( same, "rotate_left_n matches repeated single steps" );
+
+    dynamic_array_destroy( a );
+    dynamic_array_destroy( b );
+}
+
+void test_rotate_negative_count() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 1; i <= 5; i++ ) { dynamic_array_push( da, i ); }
+
+    dynamic_array_rotate_right_n( da, -2 );
+    TEST_ASSERT( da->buffer[0] == 3 && da->buffer[4] == 2,
+                 "negative right rotation rotates left" );
+
+    dynamic_array_rotate_left_n( da, -2 );
+    TEST_ASSERT( da->buffer[0] == 1 && da->buffer[4] == 5,
+                 "negative left rotation rotates right" );
+
+    dynamic_array_rotate_right_n( da, -2147483647 - 1 ); // INT_MIN
+    TEST_ASSERT( da->buffer[0] == 4,
+                 "INT_MIN rotation uses euclidean modulo" );
+
+    dynamic_array_destroy( da );
+}
+
 // ============================================================================
 // Clear and Destroy Tests
 // ============================================================================
@@ -342,13 +1075,52 @@ void test_clear() {
     struct dynamic_array *da = dynamic_array_create();
     for ( int i = 0; i < 10; i++ ) { dynamic_array_push( da, i ); }
 
+    int *buffer = da->buffer;
     dynamic_array_clear( da );
 
     TEST_ASSERT( da->size == 0, "clear resets size" );
-    TEST_ASSERT( da->capacity == 8, "clear resets capacity to default" );
-    TEST_ASSERT( da->buffer != NULL, "clear reallocates buffer" );
+    TEST_ASSERT( da->capacity == 16, "clear keeps capacity" );
+    TEST_ASSERT( da->buffer == buffer, "clear keeps buffer" );
 
-    dynamic_array_clear( da );
+    dynamic_array_destroy( da );
+}
+
+void test_reset_reserve_shrink_release() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+    struct dynamic_array da;
+    dynamic_array_init_with( &da, &allocator );
+
+    dynamic_array_reserve( &da, 100 );
+    TEST_ASSERT( da.capacity == 100 && da.size == 0,
+                 "reserve sets capacity without changing size" );
+    for ( int round = 0; round < 10; round++ ) {
+        for ( int i = 0; i < 100; i++ ) { dynamic_array_push( &da, i ); }
+        dynamic_array_reset( &da );
+    }
+    TEST_ASSERT( counts.allocs == 1 && counts.reallocs == 0 &&
+                     counts.frees == 0,
+                 "steady-state push/reset loop does not allocate" );
+
+    for ( int i = 0; i < 10; i++ ) { dynamic_array_push( &da, i ); }
+    dynamic_array_shrink_to_fit( &da );
+    TEST_ASSERT( da.capacity == 10 && dynamic_array_get( &da, 9 ) == 9,
+                 "shrink_to_fit trims capacity to size" );
+
+    dynamic_array_release( &da );
+    TEST_ASSERT( da.buffer == NULL && da.capacity == 0 && da.size == 0,
+                 "release returns to the empty state" );
+    TEST_ASSERT( counts.frees == 1, "release frees the buffer" );
+
+    dynamic_array_push( &da, 5 );
+    TEST_ASSERT( dynamic_array_back( &da ) == 5,
+                 "array is usable after release" );
+    dynamic_array_release( &da );
 }
 
 // ============================================================================
@@ -394,8 +1166,10 @@ void test_large_array() {
 }
 
 void test_expand() {
-    struct dynamic_array *da       = dynamic_array_create();
-    size_t                capacity = da->capacity;
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_expand( da );
+    TEST_ASSERT( da->capacity == 8, "expand on empty array allocates default" );
+    size_t capacity = da->capacity;
 
     dynamic_array_expand( da );
     TEST_ASSERT( da->capacity == capacity * 2, "expand doubles capacity" );
@@ -405,59 +1179,2081 @@ void test_expand() {
 }
 
 // ============================================================================
-// Main Test Runner
+// Allocator Tests
 // ============================================================================
 
-int main( void ) {
-    printf( "Running Dynamic Array Test Suite\n" );
-    printf( "================================\n\n" );
+void test_custom_allocator() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+
+    struct dynamic_array *da =
+        dynamic_array_create_with( &allocator, &allocator );
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, i ); }
+    TEST_ASSERT( counts.allocs == 2, "header and buffer use the allocator" );
+    TEST_ASSERT( counts.reallocs == 4, "growth goes through realloc" );
+    dynamic_array_destroy( da );
+    TEST_ASSERT( counts.frees == 2, "destroy frees header and buffer" );
+}
 
-    printf( "Creation and Initialization:\n" );
-    test_create_and_init();
-    test_init_on_existing();
+void test_arena_and_pool() {
+    struct dynamic_array_arena arena;
+    struct dynamic_array_pool  pool;
+    dynamic_array_arena_init( &arena, 4096 );
+    dynamic_array_pool_init( &pool, sizeof( struct dynamic_array ), 8 );
+
+    struct dynamic_array *arrays[20];
+    for ( int a = 0; a < 20; a++ ) {
+        arrays[a] = dynamic_array_create_with( &pool.allocator,
+                                               &arena.allocator );
+        for ( int i = 0; i < a * 10; i++ ) {
+            dynamic_array_push( arrays[a], a * 1000 + i );
+        }
+    }
+    bool intact = true;
+    for ( int a = 0; a < 20; a++ ) {
+        for ( int i = 0; i < a * 10; i++ ) {
+            intact = intact &&
+                     dynamic_array_get( arrays[a], (size_t)i ) == a * 1000 + i;
+        }
+    }
+    TEST_ASSERT( intact, "arena-backed arrays keep their own contents" );
 
-    printf( "\nPush and Pop:\n" );
-    test_push_single();
-    test_push_multiple();
-    test_push_expansion();
-    test_pop_single();
-    test_pop_multiple();
+    struct dynamic_array *last = arrays[19];
+    for ( int a = 0; a < 20; a++ ) { dynamic_array_destroy( arrays[a] ); }
+    dynamic_array_arena_reset( &arena );
+    TEST_ASSERT( dynamic_array_arena_used( &arena ) == 0,
+                 "arena reset releases every allocation" );
 
-    printf( "\nSize and Capacity:\n" );
-    test_size_capacity_queries();
-    test_empty();
+    struct dynamic_array *reused =
+        dynamic_array_create_with( &pool.allocator, &arena.allocator );
+    TEST_ASSERT( reused == last, "pool hands back the last freed header" );
+    dynamic_array_destroy( reused );
 
-    printf( "\nGet and Set:\n" );
-    test_get();
-    test_set();
+    dynamic_array_pool_destroy( &pool );
+    dynamic_array_arena_destroy( &arena );
+}
 
-    printf( "\nFront and Back:\n" );
-    test_front_back();
-    test_front_back_single();
+void test_arena_grows_in_place() {
+    struct dynamic_array_arena arena;
+    dynamic_array_arena_init( &arena, 1 << 16 );
 
-    printf( "\nFind:\n" );
-    test_find_existing();
-    test_find_not_found();
-    test_find_duplicates();
+    struct dynamic_array da;
+    dynamic_array_init_with( &da, &arena.allocator );
+    dynamic_array_push( &da, 0 );
+    int *initial = da.buffer;
+    for ( int i = 1; i < 1000; i++ ) { dynamic_array_push( &da, i ); }
+    TEST_ASSERT( da.buffer == initial,
+                 "latest arena allocation grows without moving" );
+    TEST_ASSERT( dynamic_array_get( &da, 999 ) == 999,
+                 "in-place growth keeps contents" );
+
+    dynamic_array_arena_destroy( &arena );
+}
 
-    printf( "\nFill:\n" );
-    test_fill();
+void test_small_buffer() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+
+    struct small_array sa;
+    small_array_init_with( &sa, &allocator );
+    TEST_ASSERT( sa.buffer == sa.inline_buffer && sa.capacity == 16,
+                 "small array starts on inline storage" );
+
+    for ( int i = 0; i < 16; i++ ) { small_array_push( &sa, i ); }
+    TEST_ASSERT( counts.allocs == 0 && counts.reallocs == 0,
+                 "filling inline storage does not allocate" );
+
+    small_array_push( &sa, 16 );
+    TEST_ASSERT( counts.allocs == 1 && sa.buffer != sa.inline_buffer,
+                 "overflow spills to the allocator once" );
+    TEST_ASSERT( sa.capacity == 32 && small_array_get( &sa, 0 ) == 0 &&
+                     small_array_get( &sa, 16 ) == 16,
+                 "spill copies inline elements" );
+
+    for ( int i = 0; i < 15; i++ ) { small_array_pop( &sa ); }
+    small_array_shrink_to_fit( &sa );
+    TEST_ASSERT( counts.frees == 1 && sa.buffer == sa.inline_buffer &&
+                     small_array_get( &sa, 1 ) == 1,
+                 "shrink_to_fit moves back to inline storage" );
+
+    small_array_push_n( &sa, ( const int[] ){ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                              11, 12, 13, 14, 15, 16 },
+                        16 );
+    small_array_release( &sa );
+    TEST_ASSERT( counts.frees == 2 && sa.buffer == sa.inline_buffer,
+                 "release returns to inline storage" );
+
+    struct small_array *heap = small_array_create_with( NULL, &allocator );
+    small_array_push( heap, 1 );
+    small_array_destroy( heap );
+    TEST_ASSERT( counts.allocs == 2 && counts.frees == 2,
+                 "destroy of an inline array frees nothing" );
+}
 
-    printf( "\nRotation:\n" );
-    test_rotate_right();
-    test_rotate_left();
-    test_rotate_right_n();
-    test_rotate_left_n();
-    test_rotate_wrap_around();
+// ============================================================================
+// Growth Policy Tests
+// ============================================================================
 
-    printf( "\nClear and Destroy:\n" );
-    test_clear();
+static size_t quadruple( void *context, const size_t capacity,
+                         const size_t min_capacity ) {
+    size_t next = capacity ? capacity : *(size_t *)context;
+    while ( next < min_capacity ) { next *= 4; }
+    return next;
+}
 
-    printf( "\nEdge Cases and Stress:\n" );
-    test_negative_values();
-    test_large_values();
-    test_large_array();
-    test_expand();
+void test_growth_policies() {
+    struct dynamic_array             *da = dynamic_array_create();
+    const struct dynamic_array_growth one_and_half = {
+        .kind = DYNAMIC_ARRAY_GROWTH_ONE_AND_HALF,
+    };
+    dynamic_array_set_growth( da, &one_and_half );
+    for ( int i = 0; i < 20; i++ ) { dynamic_array_push( da, i ); }
+    TEST_ASSERT( da->capacity == 27, "1.5x policy grows 8, 12, 18, 27" );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_create();
+    const struct dynamic_array_growth fixed = {
+        .kind      = DYNAMIC_ARRAY_GROWTH_FIXED,
+        .increment = 100,
+    };
+    dynamic_array_set_growth( da, &fixed );
+    for ( int i = 0; i < 250; i++ ) { dynamic_array_push( da, i ); }
+    TEST_ASSERT( da->capacity == 300, "fixed policy adds the increment" );
+    dynamic_array_extend( da, da );
+    TEST_ASSERT( da->capacity == 500 && dynamic_array_get( da, 499 ) == 249,
+                 "fixed policy jumps straight to a bulk request" );
+    dynamic_array_destroy( da );
+
+    size_t                            initial = 2;
+    const struct dynamic_array_growth custom  = {
+         .kind     = DYNAMIC_ARRAY_GROWTH_CALLBACK,
+         .callback = quadruple,
+         .context  = &initial,
+    };
+    da = dynamic_array_create();
+    dynamic_array_set_growth( da, &custom );
+    for ( int i = 0; i < 9; i++ ) { dynamic_array_push( da, i ); }
+    TEST_ASSERT( da->capacity == 32, "callback policy decides capacity" );
+
+    dynamic_array_set_growth( da, NULL );
+    dynamic_array_expand( da );
+    TEST_ASSERT( da->capacity == 64, "NULL policy restores doubling" );
+    dynamic_array_destroy( da );
+}
+
+void test_growth_mmap() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+    const struct dynamic_array_growth mapped = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .mmap_threshold = 1 << 14,
+    };
+    struct dynamic_array da;
+    dynamic_array_init_with( &da, &allocator );
+    dynamic_array_set_growth( &da, &mapped );
+
+    for ( int i = 0; i < 1000; i++ ) { dynamic_array_push( &da, i ); }
+    TEST_ASSERT( !( da.flags & DYNAMIC_ARRAY_FLAG_MAPPED ),
+                 "small buffers stay on the allocator" );
+
+    for ( int i = 1000; i < 100000; i++ ) { dynamic_array_push( &da, i ); }
+    bool intact = true;
+    for ( int i = 0; i < 100000; i++ ) {
+        intact = intact && dynamic_array_get( &da, (size_t)i ) == i;
+    }
+    TEST_ASSERT( da.flags & DYNAMIC_ARRAY_FLAG_MAPPED,
+                 "buffer moves to a mapping past the threshold" );
+    TEST_ASSERT( intact, "mapped growth keeps contents" );
+    TEST_ASSERT( counts.frees == 1,
+                 "heap buffer is freed when the mapping takes over" );
+    TEST_ASSERT( da.capacity * sizeof( int ) % 4096 == 0,
+                 "mapped capacity is rounded to whole pages" );
+
+    dynamic_array_pop_n( &da, NULL, 90000 );
+    dynamic_array_shrink_to_fit( &da );
+    TEST_ASSERT( da.capacity >= 10000 && da.capacity < 11024 &&
+                     dynamic_array_get( &da, 9999 ) == 9999,
+                 "shrink_to_fit shrinks the mapping" );
+
+    dynamic_array_release( &da );
+    TEST_ASSERT( da.buffer == NULL && da.flags == 0,
+                 "release unmaps the buffer" );
+    TEST_ASSERT( counts.frees == 1,
+                 "mapping is never passed to the allocator" );
+}
+
+void test_growth_shrink() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+    const struct dynamic_array_growth shrinking = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .shrink_divisor = 4,
+    };
+    struct dynamic_array da;
+    dynamic_array_init_with( &da, &allocator );
+    dynamic_array_set_growth( &da, &shrinking );
+    for ( int i = 0; i < 1024; i++ ) { dynamic_array_push( &da, i ); }
+    const int grown = counts.reallocs;
+
+    while ( da.size > 256 ) { dynamic_array_pop( &da ); }
+    TEST_ASSERT( da.capacity == 1024 && counts.reallocs == grown,
+                 "no shrink down to a quarter of the capacity" );
+    dynamic_array_pop( &da );
+    TEST_ASSERT( da.capacity == 512 && counts.reallocs == grown + 1 &&
+                     da.buffer[254] == 254,
+                 "the capacity halves below a quarter" );
+    for ( int i = 0; i < 1000; i++ ) {
+        dynamic_array_push( &da, 0 );
+        dynamic_array_pop( &da );
+        dynamic_array_pop( &da );
+        dynamic_array_push( &da, 0 );
+    }
+    TEST_ASSERT( da.capacity == 512 && counts.reallocs == grown + 1,
+                 "push/pop pairs at the boundary never reallocate" );
+
+    dynamic_array_pop_n( &da, NULL, da.size );
+    TEST_ASSERT( da.capacity == DYNAMIC_ARRAY_DEFAULT_CAPACITY &&
+                     counts.reallocs == grown + 2,
+                 "a bulk removal shrinks in one reallocation" );
+
+    dynamic_array_reset( &da );
+    for ( int i = 0; i < 1024; i++ ) { dynamic_array_push( &da, i ); }
+    dynamic_array_remove_range( &da, 100, 1024 );
+    bool intact = da.capacity == 256;
+    for ( int i = 0; i < 100; i++ ) { intact &= da.buffer[i] == i; }
+    int two = 2;
+    dynamic_array_remove_if( &da, is_multiple, &two );
+    intact &= da.capacity == 128 && da.size == 50 && da.buffer[49] == 99;
+    TEST_ASSERT( intact, "remove_range and remove_if shrink too" );
+
+    struct dynamic_array *clone = dynamic_array_clone( &da );
+    dynamic_array_pop_n( &da, NULL, 40 );
+    TEST_ASSERT( da.capacity == 128 && dynamic_array_is_shared( &da ),
+                 "a buffer shared with a clone is not shrunk" );
+    dynamic_array_destroy( clone );
+
+    dynamic_array_set_growth( &da, NULL );
+    dynamic_array_pop_n( &da, NULL, da.size );
+    TEST_ASSERT( da.capacity == 128, "the default policy never shrinks" );
+    dynamic_array_release( &da );
+}
+
+void test_growth_shrink_mapped() {
+    const struct dynamic_array_growth mapped = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .mmap_threshold = 1 << 14,
+        .shrink_divisor = 4,
+    };
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_set_growth( da, &mapped );
+    for ( int i = 0; i < 1 << 20; i++ ) { dynamic_array_push( da, i ); }
+    dynamic_array_pop_n( da, NULL, da->size - 1000 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_MAPPED ) &&
+                     da->capacity == ( 1 << 14 ) / sizeof( int ),
+                 "a mapping shrinks down to the mmap threshold" );
+    TEST_ASSERT( da->buffer[999] == 999 && da->buffer[2000] == 0,
+                 "pages past the elements are given back to the kernel" );
+    for ( int i = 1000; i < 5000; i++ ) { dynamic_array_push( da, i ); }
+    bool intact = true;
+    for ( int i = 0; i < 5000; i++ ) { intact &= da->buffer[i] == i; }
+    TEST_ASSERT( intact, "a shrunk mapping grows again" );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Ring Buffer Tests
+// ============================================================================
+
+void test_ring_deque() {
+    struct dynamic_array_ring *ring = dynamic_array_ring_create();
+    for ( int i = 0; i < 5; i++ ) { dynamic_array_ring_push_back( ring, i ); }
+    for ( int i = 1; i <= 5; i++ ) {
+        dynamic_array_ring_push_front( ring, -i );
+    }
+
+    TEST_ASSERT( dynamic_array_ring_size( ring ) == 10 &&
+                     dynamic_array_ring_capacity( ring ) == 16,
+                 "ring grows when either end runs out of room" );
+    bool ordered = true;
+    for ( size_t i = 0; i < 10; i++ ) {
+        ordered = ordered && dynamic_array_ring_get( ring, i ) == (int)i - 5;
+    }
+    TEST_ASSERT( ordered, "ring get uses logical indices across the wrap" );
+    TEST_ASSERT( dynamic_array_ring_front( ring ) == -5 &&
+                     dynamic_array_ring_back( ring ) == 4,
+                 "ring front and back" );
+
+    TEST_ASSERT( dynamic_array_ring_pop_front( ring ) == -5 &&
+                     dynamic_array_ring_pop_back( ring ) == 4 &&
+                     dynamic_array_ring_size( ring ) == 8,
+                 "ring pops from both ends" );
+
+    dynamic_array_ring_set( ring, 0, 100 );
+    TEST_ASSERT( dynamic_array_ring_front( ring ) == 100,
+                 "ring set writes the logical slot" );
+
+    dynamic_array_ring_destroy( ring );
+}
+
+void test_ring_sliding_window() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+    struct dynamic_array_ring ring;
+    dynamic_array_ring_init_with( &ring, &allocator );
+
+    long sum = 0;
+    for ( int i = 0; i < 1000; i++ ) {
+        dynamic_array_ring_push_back( &ring, i );
+        sum += i;
+        if ( dynamic_array_ring_size( &ring ) > 8 ) {
+            sum -= dynamic_array_ring_pop_front( &ring );
+        }
+    }
+    TEST_ASSERT( sum == 992 + 993 + 994 + 995 + 996 + 997 + 998 + 999,
+                 "ring keeps the last window of elements" );
+    TEST_ASSERT( counts.allocs == 1 && counts.reallocs == 1,
+                 "steady-state window does not reallocate" );
+
+    dynamic_array_ring_release( &ring );
+    TEST_ASSERT( counts.frees == 1 && ring.buffer == NULL,
+                 "ring release frees the buffer" );
+}
+
+void test_ring_rotation() {
+    struct dynamic_array_ring *ring = dynamic_array_ring_create();
+    struct dynamic_array      *da   = dynamic_array_create();
+    for ( int i = 0; i < 8; i++ ) {
+        dynamic_array_ring_push_back( ring, i );
+        dynamic_array_push( da, i );
+    }
+
+    int *buffer = ring->buffer;
+    dynamic_array_ring_rotate_left_n( ring, 3 );
+    TEST_ASSERT( ring->buffer == buffer && ring->head == 3,
+                 "full ring rotates by moving head" );
+
+    bool same = true;
+    for ( int step = -20; step <= 20; step += 7 ) {
+        dynamic_array_ring_rotate_right_n( ring, step );
+        dynamic_array_rotate_right_n( da, step );
+        dynamic_array_ring_rotate_left( ring );
+        dynamic_array_rotate_left( da );
+    }
+    dynamic_array_rotate_left_n( da, 3 );
+    for ( size_t i = 0; i < 8; i++ ) {
+        same = same && dynamic_array_ring_get( ring, i ) == da->buffer[i];
+    }
+    TEST_ASSERT( same, "ring rotations match the array rotations" );
+
+    // partially filled: rotation moves the shorter side only
+    dynamic_array_ring_pop_back( ring );
+    dynamic_array_pop( da );
+    dynamic_array_ring_rotate_right_n( ring, 5 );
+    dynamic_array_rotate_right_n( da, 5 );
+    dynamic_array_ring_rotate_left_n( ring, 1 );
+    dynamic_array_rotate_left_n( da, 1 );
+    same = true;
+    for ( size_t i = 0; i < 7; i++ ) {
+        same = same && dynamic_array_ring_get( ring, i ) == da->buffer[i];
+    }
+    TEST_ASSERT( same, "partial ring rotations keep logical order" );
+
+    dynamic_array_destroy( da );
+    dynamic_array_ring_destroy( ring );
+}
+
+void test_ring_linearize() {
+    struct dynamic_array_ring *ring = dynamic_array_ring_create();
+    TEST_ASSERT( dynamic_array_ring_linearize( ring ) == NULL,
+                 "empty ring has no contiguous view" );
+
+    for ( int i = 0; i < 16; i++ ) { dynamic_array_ring_push_back( ring, i ); }
+    for ( int i = 0; i < 12; i++ ) { dynamic_array_ring_pop_front( ring ); }
+    for ( int i = 16; i < 18; i++ ) { dynamic_array_ring_push_back( ring, i ); }
+    int *view = dynamic_array_ring_linearize( ring );
+    TEST_ASSERT( ring->head == 0 && view[0] == 12 && view[5] == 17,
+                 "linearize moves a short wrapped ring to the front" );
+
+    dynamic_array_ring_rotate_left_n( ring, 2 );
+    for ( int i = 18; i < 28; i++ ) { dynamic_array_ring_push_back( ring, i ); }
+    dynamic_array_ring_rotate_left_n( ring, 5 );
+    view = dynamic_array_ring_linearize( ring );
+    bool same = true;
+    for ( size_t i = 0; i < dynamic_array_ring_size( ring ); i++ ) {
+        same = same && view[i] == dynamic_array_ring_get( ring, i );
+    }
+    TEST_ASSERT( same && ring->head == 0 && view[0] == 13,
+                 "linearize rotates a long wrapped ring in place" );
+
+    for ( int i = 0; i < 4; i++ ) { dynamic_array_ring_pop_back( ring ); }
+    for ( int i = 0; i < 10; i++ ) {
+        dynamic_array_ring_push_back( ring,
+                                      dynamic_array_ring_pop_front( ring ) );
+    }
+    TEST_ASSERT( ring->head == 10 && dynamic_array_ring_size( ring ) == 12,
+                 "ring wraps with free slots" );
+    int expected = dynamic_array_ring_get( ring, 11 );
+    view         = dynamic_array_ring_linearize( ring );
+    TEST_ASSERT( ring->head == 0 && view[0] == 27 && view[11] == expected,
+                 "linearize handles a wrapped ring with free slots" );
+
+    dynamic_array_ring_destroy( ring );
+}
+
+// ============================================================================
+// Parallel Algorithm Tests
+// ============================================================================
+
+static int halve( const int value, void *context ) {
+    (void)context;
+    return value / 2;
+}
+
+void test_parallel_pool() {
+    struct dynamic_array_workers *w = dynamic_array_workers_create( 4 );
+    TEST_ASSERT( dynamic_array_workers_threads( w ) == 4,
+                 "pool counts the calling thread" );
+    TEST_ASSERT( dynamic_array_workers_threads( NULL ) == 1,
+                 "NULL pool is single threaded" );
+
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 1000; i++ ) { dynamic_array_push( da, i - 500 ); }
+
+    dynamic_array_parallel_fill( w, da, 7, 1 );
+    TEST_ASSERT( dynamic_array_count( da, 7 ) == 1000,
+                 "parallel fill writes every element" );
+
+    for ( size_t i = 0; i < 1000; i++ ) { da->buffer[i] = (int)i % 97; }
+    TEST_ASSERT( dynamic_array_parallel_find( w, da, 42, 1 ) == 42,
+                 "parallel find returns the earliest match" );
+    TEST_ASSERT( dynamic_array_parallel_find( w, da, 96, 1 ) == 96 &&
+                     dynamic_array_parallel_find( w, da, 97, 1 ) == -1,
+                 "parallel find matches serial find" );
+
+    // an indexed find compares one element, a scan every one up to the match
+    dynamic_array_index_enable( da );
+    dynamic_array_stats_reset( da );
+    const ptrdiff_t found = dynamic_array_parallel_find( w, da, 42, 1 );
+    struct dynamic_array_stats stats;
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( found == 42 &&
+                     ( !DYNAMIC_ARRAY_STATS || stats.comparisons == 1 ),
+                 "parallel find uses the hash index" );
+
+    dynamic_array_workers_destroy( w );
+    dynamic_array_destroy( da );
+}
+
+void test_parallel_reductions() {
+    struct dynamic_array_workers *w  = dynamic_array_workers_create( 4 );
+    struct dynamic_array         *da = dynamic_array_create();
+    int64_t                       expected = 0;
+    for ( int i = 0; i < 1003; i++ ) {
+        int value = i % 2 ? INT_MAX - i : i - 600;
+        dynamic_array_push( da, value );
+        expected += value;
+    }
+
+    TEST_ASSERT( dynamic_array_parallel_sum( w, da, 1 ) == expected,
+                 "parallel sum does not overflow int" );
+    TEST_ASSERT( dynamic_array_parallel_sum( w, da, 1 ) ==
+                     dynamic_array_parallel_sum( NULL, da, 1 ),
+                 "parallel sum matches serial sum" );
+    TEST_ASSERT( dynamic_array_parallel_min( w, da, 1 ) == -600,
+                 "parallel min" );
+    TEST_ASSERT( dynamic_array_parallel_max( w, da, 1 ) == INT_MAX - 1,
+                 "parallel max" );
+
+    dynamic_array_parallel_transform( w, da, halve, NULL, 1 );
+    TEST_ASSERT( da->buffer[0] == -300 && da->buffer[1002] == 201,
+                 "parallel transform applies the function" );
+
+    dynamic_array_clear( da );
+    TEST_ASSERT( dynamic_array_parallel_sum( w, da, 1 ) == 0,
+                 "parallel sum of an empty array" );
+
+    dynamic_array_workers_destroy( w );
+    dynamic_array_destroy( da );
+}
+
+void test_parallel_sort() {
+    struct dynamic_array_workers *w        = dynamic_array_workers_create( 4 );
+    struct dynamic_array         *da       = dynamic_array_create();
+    struct dynamic_array         *expected = dynamic_array_create();
+    uint32_t                      state    = 12345;
+    for ( int i = 0; i < 5000; i++ ) {
+        state = state * 1664525u + 1013904223u;
+        dynamic_array_push( da, (int)state );
+    }
+    dynamic_array_extend( expected, da );
+    qsort( expected->buffer, expected->size, sizeof( int ), compare_ints );
+
+    dynamic_array_parallel_sort( w, da, 1 );
+    TEST_ASSERT( memcmp( da->buffer, expected->buffer,
+                         sizeof( int ) * da->size ) == 0,
+                 "parallel sort matches qsort" );
+    TEST_ASSERT( dynamic_array_is_sorted( da ),
+                 "parallel sort sets the sorted flag" );
+
+    // all keys share their upper bytes, so those passes are skipped
+    dynamic_array_clear( da );
+    for ( int i = 0; i < 1000; i++ ) { dynamic_array_push( da, 999 - i ); }
+    dynamic_array_parallel_sort( w, da, 1 );
+    TEST_ASSERT( da->buffer[0] == 0 && da->buffer[999] == 999 &&
+                     dynamic_array_binary_search( da, 500 ),
+                 "parallel sort with skipped passes" );
+
+    dynamic_array_workers_destroy( w );
+    dynamic_array_destroy( da );
+    dynamic_array_destroy( expected );
+}
+
+// ============================================================================
+// Concurrent Append Tests
+// ============================================================================
+
+void test_concurrent_segments() {
+    struct dynamic_array_concurrent *c = dynamic_array_concurrent_create();
+    TEST_ASSERT( dynamic_array_concurrent_size( c ) == 0,
+                 "concurrent array starts empty" );
+
+    int values[100];
+    for ( int i = 0; i < 100; i++ ) { values[i] = i * i; }
+    TEST_ASSERT( dynamic_array_concurrent_push( c, -1 ) == 0 &&
+                     dynamic_array_concurrent_push_n( c, values, 100 ) == 1,
+                 "pushes return the first reserved index" );
+    TEST_ASSERT( dynamic_array_concurrent_size( c ) == 101,
+                 "size counts published elements" );
+
+    bool same = dynamic_array_concurrent_get( c, 0 ) == -1;
+    for ( size_t i = 0; i < 100; i++ ) {
+        same = same && dynamic_array_concurrent_get( c, i + 1 ) == values[i];
+    }
+    TEST_ASSERT( same, "push_n spans several segments" );
+
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_push( da, 5 );
+    TEST_ASSERT( dynamic_array_concurrent_collect( c, da ) == 101 &&
+                     da->size == 102 && da->buffer[1] == -1 &&
+                     da->buffer[101] == 99 * 99,
+                 "collect appends in index order" );
+
+    dynamic_array_concurrent_clear( c );
+    dynamic_array_concurrent_push( c, 7 );
+    TEST_ASSERT( dynamic_array_concurrent_size( c ) == 1 &&
+                     dynamic_array_concurrent_get( c, 0 ) == 7,
+                 "clear reuses the segments" );
+
+    dynamic_array_destroy( da );
+    dynamic_array_concurrent_destroy( c );
+}
+
+#define PRODUCERS           4
+#define PUSHES_PER_PRODUCER 20000
+
+struct producer {
+    struct dynamic_array_concurrent *c;
+    int                              id;
+};
+
+// values encode producer and sequence, never 0
+static void *produce( void *argument ) {
+    struct producer *p = argument;
+    for ( int i = 1; i <= PUSHES_PER_PRODUCER; i++ ) {
+        if ( i % 100 == 0 && i + 2 <= PUSHES_PER_PRODUCER ) {
+            int batch[3] = { p->id * 1000000 + i, p->id * 1000000 + i + 1,
+                             p->id * 1000000 + i + 2 };
+            dynamic_array_concurrent_push_n( p->c, batch, 3 );
+            i += 2;
+        } else {
+            dynamic_array_concurrent_push( p->c, p->id * 1000000 + i );
+        }
+    }
+    return NULL;
+}
+
+// reads every published slot while producers are still running
+static void *consume( void *argument ) {
+    struct dynamic_array_concurrent *c    = argument;
+    size_t                           seen = 0;
+    bool                             ok   = true;
+    while ( seen < PRODUCERS * PUSHES_PER_PRODUCER ) {
+        size_t size = dynamic_array_concurrent_size( c );
+        for ( ; seen < size; seen++ ) {
+            ok = ok && dynamic_array_concurrent_get( c, seen ) != 0;
+        }
+    }
+    return ok ? argument : NULL;
+}
+
+void test_concurrent_producers() {
+    struct dynamic_array_concurrent *c = dynamic_array_concurrent_create();
+    struct producer                  producers[PRODUCERS];
+    pthread_t                        threads[PRODUCERS];
+    pthread_t                        reader;
+    void                            *result;
+
+    pthread_create( &reader, NULL, consume, c );
+    for ( int t = 0; t < PRODUCERS; t++ ) {
+        producers[t] = ( struct producer ){ .c = c, .id = t + 1 };
+        pthread_create( &threads[t], NULL, produce, &producers[t] );
+    }
+    for ( int t = 0; t < PRODUCERS; t++ ) { pthread_join( threads[t], NULL ); }
+    pthread_join( reader, &result );
+    TEST_ASSERT( result != NULL,
+                 "readers only see written slots during pushes" );
+
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_concurrent_collect( c, da );
+    TEST_ASSERT( da->size == PRODUCERS * PUSHES_PER_PRODUCER,
+                 "no push is lost under contention" );
+
+    // each producer's values appear in the order it pushed them
+    int last[PRODUCERS + 1];
+    for ( int t = 0; t <= PRODUCERS; t++ ) { last[t] = t * 1000000; }
+    bool ordered = true;
+    for ( size_t i = 0; i < da->size; i++ ) {
+        int id   = da->buffer[i] / 1000000;
+        ordered  = ordered && id >= 1 && id <= PRODUCERS &&
+                  da->buffer[i] == last[id] + 1;
+        last[id] = da->buffer[i];
+    }
+    TEST_ASSERT( ordered, "per-producer order is preserved" );
+
+    dynamic_array_destroy( da );
+    dynamic_array_concurrent_destroy( c );
+}
+
+// Allocator whose second call blocks until the test lets it go, to stall
+// one producer between reserving its slot and writing it.
+struct stalling_context {
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;
+    int             calls;
+    bool            open;
+};
+
+static void *stalling_alloc( void *context, const size_t size ) {
+    struct stalling_context *s = context;
+    pthread_mutex_lock( &s->lock );
+    if ( ++s->calls == 2 ) {
+        pthread_cond_broadcast( &s->changed );
+        while ( !s->open ) { pthread_cond_wait( &s->changed, &s->lock ); }
+    }
+    pthread_mutex_unlock( &s->lock );
+    return malloc( size );
+}
+
+static void *stalling_realloc( void *context, void *ptr, const size_t old_size,
+                               const size_t new_size ) {
+    (void)context;
+    (void)old_size;
+    return realloc( ptr, new_size );
+}
+
+static void stalling_free( void *context, void *ptr, const size_t size ) {
+    (void)context;
+    (void)size;
+    free( ptr );
+}
+
+static void *push_one( void *argument ) {
+    dynamic_array_concurrent_push( argument, 8 );
+    return NULL;
+}
+
+void test_concurrent_stalled_producer() {
+    struct stalling_context stall = {
+        .lock    = PTHREAD_MUTEX_INITIALIZER,
+        .changed = PTHREAD_COND_INITIALIZER,
+    };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = stalling_alloc,
+        .realloc = stalling_realloc,
+        .free    = stalling_free,
+        .context = &stall,
+    };
+    struct dynamic_array_concurrent *c =
+        dynamic_array_concurrent_create_with( &allocator );
+    for ( int i = 0; i < 8; i++ ) { dynamic_array_concurrent_push( c, i ); }
+
+    // the producer reserves slot 8, the first of a new segment, and stalls
+    // allocating it
+    pthread_t producer;
+    pthread_create( &producer, NULL, push_one, c );
+    pthread_mutex_lock( &stall.lock );
+    while ( stall.calls < 2 ) {
+        pthread_cond_wait( &stall.changed, &stall.lock );
+    }
+    pthread_mutex_unlock( &stall.lock );
+
+    TEST_ASSERT( dynamic_array_concurrent_push( c, 9 ) == 9 &&
+                     dynamic_array_concurrent_get( c, 9 ) == 9,
+                 "a push completes while an earlier producer is stalled" );
+    TEST_ASSERT( dynamic_array_concurrent_size( c ) == 8,
+                 "size stops at the slot still being written" );
+
+    pthread_mutex_lock( &stall.lock );
+    stall.open = true;
+    pthread_cond_broadcast( &stall.changed );
+    pthread_mutex_unlock( &stall.lock );
+    pthread_join( producer, NULL );
+    TEST_ASSERT( dynamic_array_concurrent_size( c ) == 10 &&
+                     dynamic_array_concurrent_get( c, 8 ) == 8,
+                 "size moves past the slot once it is written" );
+    dynamic_array_concurrent_destroy( c );
+    pthread_mutex_destroy( &stall.lock );
+    pthread_cond_destroy( &stall.changed );
+}
+
+// ============================================================================
+// Instrumentation Tests
+// ============================================================================
+
+#if DYNAMIC_ARRAY_STATS
+void test_stats_growth() {
+    struct dynamic_array_stats before, after, stats;
+    dynamic_array_stats_global( &before );
+
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 9; i++ ) { dynamic_array_push( da, i ); }
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.reallocs == 2 && stats.bytes_copied == 8 * sizeof( int ),
+                 "stats count reallocations and copied bytes" );
+    TEST_ASSERT( stats.peak_capacity == 16 * sizeof( int ) &&
+                     stats.wasted_capacity == 7 * sizeof( int ),
+                 "stats report peak and wasted capacity in bytes" );
+
+    dynamic_array_stats_global( &after );
+    TEST_ASSERT( after.reallocs - before.reallocs == 2 &&
+                     after.bytes_copied - before.bytes_copied ==
+                         8 * sizeof( int ),
+                 "global stats include every array" );
+    TEST_ASSERT( after.wasted_capacity - before.wasted_capacity ==
+                     8 * sizeof( int ),
+                 "global wasted capacity as of the last reallocation" );
+
+    dynamic_array_destroy( da );
+    dynamic_array_stats_global( &after );
+    TEST_ASSERT( after.wasted_capacity == before.wasted_capacity,
+                 "destroy gives back the wasted capacity" );
+}
+
+void test_stats_shifts_and_searches() {
+    struct dynamic_array      *da = dynamic_array_create();
+    struct dynamic_array_stats stats;
+    const int                  values[] = { 1, 2, 3 };
+    for ( int i = 0; i < 10; i++ ) { dynamic_array_push( da, i ); }
+    dynamic_array_stats_reset( da );
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.reallocs == 0 &&
+                     stats.peak_capacity == 16 * sizeof( int ),
+                 "stats_reset clears counters and keeps the peak" );
+
+    dynamic_array_insert( da, 0, -1 );              // moves 10
+    dynamic_array_remove( da, 5 );                  // moves 5
+    dynamic_array_insert_range( da, 8, values, 3 ); // moves 2
+    dynamic_array_remove_range( da, 0, 2 );         // moves 11
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.shifts == 28, "stats count element shifts" );
+
+    dynamic_array_find( da, 3 );  // at index 2
+    dynamic_array_find( da, 99 ); // absent from 11 elements
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.comparisons == 14, "stats count find comparisons" );
+
+    dynamic_array_sort( da );
+    dynamic_array_stats_reset( da );
+    dynamic_array_find( da, 3 );
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.comparisons == 4, "binary search counts its probes" );
+
+    struct point_array *points = point_array_create();
+    point_array_push( points, ( struct point ){ 1, 2 } );
+    point_array_push( points, ( struct point ){ 3, 4 } );
+    point_array_find( points, ( struct point ){ 3, 4 } );
+    point_array_stats( points, &stats );
+    TEST_ASSERT( stats.comparisons == 2 && stats.reallocs == 1,
+                 "every instantiation carries stats" );
+
+    point_array_destroy( points );
+    dynamic_array_destroy( da );
+}
+
+static void *count_sevens( void *arg ) {
+    const struct dynamic_array *da = arg;
+    for ( int i = 0; i < 50; i++ ) { dynamic_array_count( da, 7 ); }
+    return NULL;
+}
+
+void test_stats_concurrent_searches() {
+    struct dynamic_array      *da = dynamic_array_create();
+    struct dynamic_array_stats stats;
+    pthread_t                  threads[4];
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, 99 - i ); }
+    dynamic_array_stats_reset( da );
+    for ( int t = 0; t < 4; t++ ) {
+        pthread_create( &threads[t], NULL, count_sevens, da );
+    }
+    for ( int t = 0; t < 4; t++ ) { pthread_join( threads[t], NULL ); }
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.comparisons == 4 * 50 * 100,
+                 "concurrent searches lose no counts" );
+    dynamic_array_destroy( da );
+}
+#else
+void test_stats_disabled() {
+    struct dynamic_array      *da = dynamic_array_create();
+    struct dynamic_array_stats stats;
+    dynamic_array_push( da, 1 );
+    dynamic_array_stats( da, &stats );
+    TEST_ASSERT( stats.reallocs == 0 && stats.peak_capacity == 0,
+                 "stats are zero when compiled out" );
+    dynamic_array_destroy( da );
+}
+#endif
+
+// ============================================================================
+// File-Backed Storage Tests
+// ============================================================================
+
+// make test runs from the repository root with build/ present
+#define TEST_FILE "build/test_array.bin"
+
+void test_file_save_and_open() {
+    struct dynamic_array *da = dynamic_array_create_file( TEST_FILE );
+    TEST_ASSERT( da != NULL && dynamic_array_size( da ) == 0,
+                 "create_file starts an empty array" );
+    for ( int i = 0; i < 5000; i++ ) { dynamic_array_push( da, 4999 - i ); }
+    TEST_ASSERT( dynamic_array_capacity( da ) >= 5000 &&
+                     ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ),
+                 "file-backed array grows by extending the file" );
+    dynamic_array_sort( da );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_READ_ONLY );
+    TEST_ASSERT( da != NULL && dynamic_array_size( da ) == 5000 &&
+                     da->buffer[0] == 0 && da->buffer[4999] == 4999,
+                 "open maps the saved elements" );
+    TEST_ASSERT( dynamic_array_is_sorted( da ) &&
+                     dynamic_array_find( da, 1234 ) == 1234,
+                 "the sorted flag is saved with the array" );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_SHARED );
+    dynamic_array_set( da, 0, -1 );
+    dynamic_array_push( da, 5000 );
+    TEST_ASSERT( dynamic_array_sync( da ), "sync flushes a shared file" );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_READ_ONLY );
+    TEST_ASSERT( dynamic_array_size( da ) == 5001 && da->buffer[0] == -1 &&
+                     da->buffer[5000] == 5000 &&
+                     !dynamic_array_is_sorted( da ),
+                 "shared changes reach the file" );
+    dynamic_array_destroy( da );
+    remove( TEST_FILE );
+}
+
+void test_file_private() {
+    struct dynamic_array *da = dynamic_array_create_file( TEST_FILE );
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, i ); }
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_PRIVATE );
+    dynamic_array_set( da, 0, 42 );
+    size_t capacity = dynamic_array_capacity( da );
+    while ( dynamic_array_size( da ) <= capacity ) {
+        dynamic_array_push( da, 7 );
+    }
+    TEST_ASSERT( !( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) &&
+                     da->buffer[0] == 42 && da->buffer[99] == 99,
+                 "growing a private mapping copies it off the file" );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_READ_ONLY );
+    TEST_ASSERT( dynamic_array_size( da ) == 100 && da->buffer[0] == 0,
+                 "private changes never reach the file" );
+    dynamic_array_destroy( da );
+    remove( TEST_FILE );
+}
+
+void test_file_shrink_empty() {
+    struct dynamic_array *da = dynamic_array_create_file( TEST_FILE );
+    for ( int i = 0; i < 5000; i++ ) { dynamic_array_push( da, i ); }
+    dynamic_array_pop_n( da, NULL, 5000 );
+    dynamic_array_shrink_to_fit( da );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_FILE ) &&
+                     dynamic_array_capacity( da ) < 5000,
+                 "shrinking an empty file keeps it mapped" );
+    dynamic_array_push( da, 42 );
+    TEST_ASSERT( dynamic_array_sync( da ), "sync after the shrink" );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_READ_ONLY );
+    TEST_ASSERT( da != NULL && dynamic_array_size( da ) == 1 &&
+                     da->buffer[0] == 42,
+                 "pushes after the shrink reach the file" );
+    dynamic_array_destroy( da );
+    remove( TEST_FILE );
+}
+
+void test_file_errors() {
+    errno = 0;
+    TEST_ASSERT( dynamic_array_open( "build/missing.bin",
+                                     DYNAMIC_ARRAY_FILE_READ_ONLY ) == NULL &&
+                     errno == ENOENT,
+                 "open reports a missing file" );
+
+    struct dynamic_array *da = dynamic_array_create_file( TEST_FILE );
+    dynamic_array_push( da, 1 );
+    dynamic_array_destroy( da );
+    errno = 0;
+    TEST_ASSERT( u8_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_READ_ONLY ) ==
+                         NULL &&
+                     errno == EINVAL,
+                 "open rejects another element size" );
+
+    FILE *garbage = fopen( TEST_FILE, "wb" );
+    fputs( "not an array", garbage );
+    fclose( garbage );
+    errno = 0;
+    TEST_ASSERT( dynamic_array_open( TEST_FILE,
+                                     DYNAMIC_ARRAY_FILE_READ_ONLY ) == NULL &&
+                     errno == EINVAL,
+                 "open rejects a file without a header" );
+    remove( TEST_FILE );
+}
+
+// ============================================================================
+// Text I/O Tests
+// ============================================================================
+
+void test_text_write_and_read() {
+    struct dynamic_array *da     = dynamic_array_create();
+    const int             edge[] = { INT_MIN, -1, 0, 7, 2147483647 };
+    dynamic_array_push_n( da, edge, 5 );
+
+    FILE *tmp = tmpfile();
+    TEST_ASSERT( dynamic_array_write_fd( da, fileno( tmp ), ' ' ),
+                 "write_fd formats into a descriptor" );
+    char text[64] = { 0 };
+    rewind( tmp );
+    size_t length = fread( text, 1, sizeof text - 1, tmp );
+    TEST_ASSERT( length == 30 &&
+                     strcmp( text, "-2147483648 -1 0 7 2147483647 " ) == 0,
+                 "the text matches printf, INT_MIN included" );
+    fclose( tmp );
+
+    // enough lines to flush the format buffer several times
+    for ( int i = 0; i < 100000; i++ ) {
+        dynamic_array_push( da, ( i % 2 ? -i : i ) * 997 );
+    }
+    tmp = tmpfile();
+    TEST_ASSERT( dynamic_array_write( da, tmp, '\n' ),
+                 "write formats into a stream" );
+    rewind( tmp );
+    struct dynamic_array *copy = dynamic_array_create();
+    TEST_ASSERT( dynamic_array_read( copy, tmp ) == 100005 &&
+                     memcmp( copy->buffer, da->buffer,
+                             sizeof *da->buffer * da->size ) == 0,
+                 "read parses the written elements back" );
+    fclose( tmp );
+    dynamic_array_destroy( copy );
+    dynamic_array_destroy( da );
+}
+
+void test_text_parse() {
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_push( da, 5 );
+    dynamic_array_sort( da );
+    const char *text = "  1\t-2\r\n+3\n\n\v\f-0 42";
+    TEST_ASSERT( dynamic_array_parse( da, text, strlen( text ) ) == 5,
+                 "parse splits on any whitespace" );
+    TEST_ASSERT( dynamic_array_size( da ) == 6 && da->buffer[0] == 5 &&
+                     da->buffer[2] == -2 && da->buffer[3] == 3 &&
+                     da->buffer[4] == 0 && da->buffer[5] == 42,
+                 "parse appends after the existing elements" );
+    TEST_ASSERT( !dynamic_array_is_sorted( da ), "parse clears sorted" );
+    TEST_ASSERT( dynamic_array_parse( da, " \n\t", 3 ) == 0 &&
+                     dynamic_array_parse( da, NULL, 0 ) == 0 &&
+                     dynamic_array_size( da ) == 6,
+                 "blank text appends nothing" );
+    TEST_ASSERT( dynamic_array_parse( da, "12345", 3 ) == 1 &&
+                     dynamic_array_back( da ) == 123,
+                 "parse stops at the given length" );
+    dynamic_array_destroy( da );
+}
+
+void test_text_parse_errors() {
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_push( da, 1 );
+    const char *malformed[] = { "1 2x 3", "- 1", "1 --2", "+", "0x10" };
+    bool        rejected    = true;
+    for ( size_t i = 0; i < 5; i++ ) {
+        errno = 0;
+        rejected &= dynamic_array_parse( da, malformed[i],
+                                         strlen( malformed[i] ) ) == -1 &&
+                    errno == EINVAL;
+    }
+    TEST_ASSERT( rejected, "parse rejects malformed tokens with EINVAL" );
+    errno = 0;
+    TEST_ASSERT( dynamic_array_parse( da, "7 2147483648", 12 ) == -1 &&
+                     errno == ERANGE,
+                 "parse rejects INT_MAX + 1 with ERANGE" );
+    errno = 0;
+    TEST_ASSERT( dynamic_array_parse( da, "-2147483649", 11 ) == -1 &&
+                     errno == ERANGE,
+                 "parse rejects INT_MIN - 1 with ERANGE" );
+    TEST_ASSERT( dynamic_array_size( da ) == 1 && da->buffer[0] == 1,
+                 "a failed parse leaves the elements as they were" );
+    TEST_ASSERT( dynamic_array_parse( da, "-2147483648", 11 ) == 1 &&
+                     dynamic_array_back( da ) == INT_MIN,
+                 "parse accepts INT_MIN" );
+    errno = 0;
+    TEST_ASSERT( dynamic_array_read_fd( da, -1 ) == -1 && errno == EBADF,
+                 "read_fd reports a bad descriptor" );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// View Tests
+// ============================================================================
+
+void test_view_slices() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 10; i++ ) { dynamic_array_push( da, i * 10 ); }
+
+    struct dynamic_array_view all = dynamic_array_view_of( da );
+    TEST_ASSERT( all.data == da->buffer && all.size == 10 && all.stride == 1,
+                 "view_of covers the whole array" );
+    struct dynamic_array_view mid = dynamic_array_slice( da, 2, 7 );
+    TEST_ASSERT( mid.size == 5 && dynamic_array_view_get( mid, 0 ) == 20 &&
+                     dynamic_array_view_get( mid, 4 ) == 60,
+                 "slice covers [first, last) without copying" );
+    struct dynamic_array_view odd = dynamic_array_slice_strided( da, 1, 5, 2 );
+    TEST_ASSERT( odd.size == 5 && dynamic_array_view_get( odd, 0 ) == 10 &&
+                     dynamic_array_view_get( odd, 4 ) == 90,
+                 "strided slice takes every stride-th element" );
+    struct dynamic_array_view sub = dynamic_array_view_slice( odd, 1, 3 );
+    TEST_ASSERT( sub.size == 2 && sub.stride == 2 &&
+                     dynamic_array_view_get( sub, 1 ) == 50,
+                 "a view can be sliced again" );
+    TEST_ASSERT( dynamic_array_slice( da, 10, 10 ).size == 0 &&
+                     dynamic_array_slice_strided( da, 3, 0, 4 ).size == 0,
+                 "empty slices are allowed at any bound" );
+
+    dynamic_array_view_set( sub, 0, -30 );
+    TEST_ASSERT( da->buffer[3] == -30, "writes go through to the array" );
+    long total = 0;
+    for ( size_t i = 0; i < odd.size; i++ ) {
+        total += *dynamic_array_view_at( odd, i );
+    }
+    TEST_ASSERT( total == 10 - 30 + 50 + 70 + 90,
+                 "view_at iterates the strided elements" );
+    dynamic_array_destroy( da );
+}
+
+static void view_double( int *element, void *context ) {
+    *element *= 2;
+    ( *(int *)context )++;
+}
+
+void test_view_operations() {
+    struct dynamic_array *da       = dynamic_array_create();
+    const int             values[] = { 5, 9, -4, 7, 1, 9, 0, -4, 3, 8, 2, 6 };
+    dynamic_array_push_n( da, values, 12 );
+
+    struct dynamic_array_view mid  = dynamic_array_slice( da, 2, 10 );
+    struct dynamic_array_view even = dynamic_array_slice_strided( da, 0, 6, 2 );
+    TEST_ASSERT( dynamic_array_view_find( mid, 9 ) == 3 &&
+                     dynamic_array_view_find( mid, 5 ) == -1 &&
+                     dynamic_array_view_find( even, 0 ) == 3,
+                 "find returns view positions" );
+    TEST_ASSERT( dynamic_array_view_sum( mid ) == 20 &&
+                     dynamic_array_view_sum( even ) == 7,
+                 "sum over contiguous and strided views" );
+    int min = 0;
+    int max = 0;
+    dynamic_array_view_minmax( even, &min, &max );
+    TEST_ASSERT( min == -4 && max == 5 && dynamic_array_view_min( mid ) == -4 &&
+                     dynamic_array_view_max( mid ) == 9,
+                 "min and max over views" );
+    TEST_ASSERT( dynamic_array_view_argmin( mid ) == 0 &&
+                     dynamic_array_view_argmax( mid ) == 3 &&
+                     dynamic_array_view_argmax( even ) == 0,
+                 "arg variants return the first extreme position" );
+
+    dynamic_array_view_sort( even );
+    const int sorted_even[] = { -4, 9, 0, 7, 1, 9, 2, -4, 3, 8, 5, 6 };
+    TEST_ASSERT( memcmp( da->buffer, sorted_even, sizeof sorted_even ) == 0,
+                 "sorting a strided view leaves the other elements" );
+    dynamic_array_view_sort( mid );
+    const int sorted_mid[] = { -4, 9, -4, 0, 1, 2, 3, 7, 8, 9, 5, 6 };
+    TEST_ASSERT( memcmp( da->buffer, sorted_mid, sizeof sorted_mid ) == 0,
+                 "sorting a slice sorts only the slice" );
+
+    dynamic_array_view_fill( dynamic_array_slice( da, 10, 12 ), 0 );
+    int calls = 0;
+    dynamic_array_view_for_each( dynamic_array_slice( da, 0, 2 ), view_double,
+                                 &calls );
+    TEST_ASSERT( calls == 2 && da->buffer[0] == -8 && da->buffer[1] == 18 &&
+                     da->buffer[10] == 0 && da->buffer[11] == 0,
+                 "fill and for_each write through the view" );
+
+    FILE *tmp = tmpfile();
+    TEST_ASSERT( dynamic_array_view_write( dynamic_array_slice_strided(
+                                               da, 0, 4, 3 ),
+                                           tmp, ',' ),
+                 "write formats a strided view" );
+    char text[32] = { 0 };
+    rewind( tmp );
+    TEST_ASSERT( fread( text, 1, sizeof text - 1, tmp ) == 9 &&
+                     strcmp( text, "-8,0,3,9," ) == 0,
+                 "the written text holds only the viewed elements" );
+    fclose( tmp );
+    dynamic_array_destroy( da );
+}
+
+void test_view_flags() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, 99 - i ); }
+    dynamic_array_sort( da );
+    struct dynamic_array_view tail = dynamic_array_slice( da, 50, 100 );
+    TEST_ASSERT( dynamic_array_view_min( tail ) == 50 &&
+                     dynamic_array_view_max( tail ) == 99 &&
+                     dynamic_array_view_argmin( tail ) == 0,
+                 "views of a sorted array reduce from the ends" );
+    dynamic_array_view_sort( tail ); // already in order, a no-op
+    TEST_ASSERT( dynamic_array_is_sorted( da ),
+                 "sorting a view of a sorted array keeps the flag" );
+    dynamic_array_view_set( tail, 0, 1000 );
+    TEST_ASSERT( !dynamic_array_is_sorted( da ),
+                 "writing through a view clears the sorted flag" );
+
+    TEST_ASSERT( dynamic_array_index_enable( da ), "index enabled" );
+    dynamic_array_view_fill( dynamic_array_slice( da, 0, 10 ), -1 );
+    TEST_ASSERT( dynamic_array_find( da, -1 ) == 0 &&
+                     dynamic_array_find( da, 5 ) == -1,
+                 "writing through a view leaves no stale index" );
+
+    // a view of the old buffer would dangle after this; take a new one
+    dynamic_array_reserve( da, 4096 );
+    struct dynamic_array_view all = dynamic_array_view_of( da );
+    TEST_ASSERT( all.data == da->buffer && all.size == 100,
+                 "a view taken after reallocating sees the new buffer" );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Copy-on-Write Tests
+// ============================================================================
+
+void test_clone_shares_buffer() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+    struct dynamic_array *da = dynamic_array_create_with( NULL, &allocator );
+    for ( int i = 0; i < 1000; i++ ) { dynamic_array_push( da, i ); }
+    dynamic_array_sort( da );
+    const int buffers = counts.allocs;
+
+    struct dynamic_array *snapshot = dynamic_array_clone( da );
+    TEST_ASSERT( snapshot->buffer == da->buffer &&
+                     dynamic_array_size( snapshot ) == 1000 &&
+                     counts.allocs == buffers + 1,
+                 "clone shares the buffer, allocating only the count" );
+    TEST_ASSERT( dynamic_array_is_shared( da ) &&
+                     dynamic_array_is_shared( snapshot ) &&
+                     dynamic_array_is_sorted( snapshot ),
+                 "both sides are shared and the clone keeps the flags" );
+
+    dynamic_array_set( da, 0, -1 );
+    TEST_ASSERT( da->buffer != snapshot->buffer && da->buffer[0] == -1 &&
+                     snapshot->buffer[0] == 0,
+                 "the first write copies, the clone keeps its contents" );
+    TEST_ASSERT( !dynamic_array_is_shared( da ) &&
+                     !dynamic_array_is_shared( snapshot ),
+                 "after the copy neither side is shared" );
+    dynamic_array_push( snapshot, 1000 );
+    TEST_ASSERT( counts.allocs == buffers + 2 &&
+                     dynamic_array_size( snapshot ) == 1001,
+                 "the last holder writes in place without another copy" );
+
+    struct dynamic_array *a = dynamic_array_clone( snapshot );
+    struct dynamic_array *b = dynamic_array_clone( snapshot );
+    dynamic_array_destroy( snapshot );
+    dynamic_array_destroy( a );
+    TEST_ASSERT( b->buffer[1000] == 1000 && !dynamic_array_is_shared( b ),
+                 "the buffer outlives its other holders" );
+    dynamic_array_destroy( b );
+    dynamic_array_destroy( da );
+    TEST_ASSERT( counts.allocs == counts.frees,
+                 "every buffer and count is freed once" );
+}
+
+static bool cow_is_even( const int value, void *context ) {
+    (void)context;
+    return value % 2 == 0;
+}
+
+void test_clone_mutations() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( da, 99 - i ); }
+
+    bool isolated = true;
+    for ( int op = 0; op < 12; op++ ) {
+        struct dynamic_array *snapshot = dynamic_array_clone( da );
+        struct dynamic_array *work     = dynamic_array_clone( da );
+        switch ( op ) {
+        case 0: dynamic_array_push( work, 7 ); break;
+        case 1: dynamic_array_set( work, 5, 7 ); break;
+        case 2: dynamic_array_insert( work, 0, 7 ); break;
+        case 3: dynamic_array_remove( work, 0 ); break;
+        case 4: dynamic_array_remove_range( work, 10, 20 ); break;
+        case 5: dynamic_array_fill( work, 7 ); break;
+        case 6: dynamic_array_rotate_left_n( work, 3 ); break;
+        case 7: dynamic_array_sort( work ); break;
+        case 8: dynamic_array_remove_value( work, 50 ); break;
+        case 9: dynamic_array_remove_if( work, cow_is_even, NULL ); break;
+        case 10: dynamic_array_find_transposition( work, 50 ); break;
+        default: dynamic_array_parse( work, "1 2 3", 5 ); break;
+        }
+        for ( int i = 0; i < 100; i++ ) {
+            isolated &= snapshot->buffer[i] == 99 - i;
+        }
+        isolated &= dynamic_array_size( snapshot ) == 100 &&
+                    work->buffer != snapshot->buffer;
+        dynamic_array_destroy( work );
+        dynamic_array_destroy( snapshot );
+    }
+    TEST_ASSERT( isolated, "every mutation copies before writing" );
+
+    struct dynamic_array *snapshot = dynamic_array_clone( da );
+    dynamic_array_pop( da );
+    dynamic_array_reset( da );
+    TEST_ASSERT( dynamic_array_is_shared( da ) &&
+                     dynamic_array_size( snapshot ) == 100,
+                 "pop and reset only move the size and copy nothing" );
+    dynamic_array_push( da, 1 );
+    TEST_ASSERT( snapshot->buffer[0] == 99 && da->buffer[0] == 1,
+                 "a push after reset still copies first" );
+    dynamic_array_destroy( snapshot );
+    dynamic_array_destroy( da );
+}
+
+void test_clone_storage_kinds() {
+    struct small_array small;
+    small_array_init( &small );
+    small_array_push_n( &small, ( const int[] ){ 1, 2, 3 }, 3 );
+    struct small_array *small_copy = small_array_clone( &small );
+    TEST_ASSERT( small_copy->buffer == small_copy->inline_buffer &&
+                     small_array_get( small_copy, 2 ) == 3,
+                 "inline elements are copied into the clone" );
+    small_array_destroy( small_copy );
+    small_array_release( &small );
+
+    const struct dynamic_array_growth mapped = {
+        .kind           = DYNAMIC_ARRAY_GROWTH_DOUBLE,
+        .mmap_threshold = 1 << 14,
+    };
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_set_growth( da, &mapped );
+    for ( int i = 0; i < 10000; i++ ) { dynamic_array_push( da, i ); }
+    struct dynamic_array *copy = dynamic_array_clone( da );
+    TEST_ASSERT( copy->buffer == da->buffer &&
+                     ( copy->flags & DYNAMIC_ARRAY_FLAG_MAPPED ),
+                 "mapped buffers are shared too" );
+    for ( int i = 0; i < 10000; i++ ) { dynamic_array_push( copy, -i ); }
+    TEST_ASSERT( dynamic_array_size( da ) == 10000 &&
+                     da->buffer[9999] == 9999 && copy->buffer[10000] == 0 &&
+                     copy->buffer[19999] == -9999,
+                 "growing a shared mapping copies it instead of mremap" );
+    dynamic_array_destroy( da );
+    dynamic_array_destroy( copy );
+
+    da = dynamic_array_create_file( TEST_FILE );
+    dynamic_array_push_n( da, ( const int[] ){ 4, 5, 6 }, 3 );
+    copy = dynamic_array_clone( da );
+    TEST_ASSERT( copy->buffer != da->buffer &&
+                     !( copy->flags & DYNAMIC_ARRAY_FLAG_FILE ) &&
+                     dynamic_array_get( copy, 1 ) == 5,
+                 "file-backed elements are copied to the allocator" );
+    dynamic_array_destroy( copy );
+    dynamic_array_destroy( da );
+    remove( TEST_FILE );
+}
+
+struct snapshot_job {
+    struct dynamic_array *snapshot;
+    int64_t               expected;
+    bool                  consistent;
+};
+
+static void *check_snapshot( void *context ) {
+    struct snapshot_job *job = context;
+    job->consistent          = true;
+    for ( int round = 0; round < 100; round++ ) {
+        job->consistent &= dynamic_array_sum( job->snapshot ) == job->expected;
+    }
+    dynamic_array_destroy( job->snapshot );
+    return NULL;
+}
+
+void test_clone_snapshots_across_threads() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 10000; i++ ) { dynamic_array_push( da, 1 ); }
+
+    pthread_t           threads[4];
+    struct snapshot_job jobs[4];
+    for ( int t = 0; t < 4; t++ ) {
+        // taken by the writer, so cloning never races with its writes
+        jobs[t] = ( struct snapshot_job ){
+            .snapshot = dynamic_array_clone( da ), .expected = 10000 + t };
+        pthread_create( &threads[t], NULL, check_snapshot, &jobs[t] );
+        dynamic_array_push( da, 1 );
+    }
+    bool consistent = true;
+    for ( int t = 0; t < 4; t++ ) {
+        pthread_join( threads[t], NULL );
+        consistent &= jobs[t].consistent;
+    }
+    TEST_ASSERT( consistent, "readers keep their snapshot while it changes" );
+    TEST_ASSERT( dynamic_array_sum( da ) == 10004,
+                 "the writer sees its own pushes" );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Frozen Array Tests
+// ============================================================================
+
+void test_frozen_pack_levels() {
+    enum dynamic_array_simd_level best  = dynamic_array_simd_detect();
+    bool                          agree = true;
+    uint32_t                      state = 777;
+    int                           values[128];
+    int                           out[128];
+    uint32_t                      packed[128];
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        for ( unsigned bits = 0; bits <= 32; bits++ ) {
+            const uint32_t mask =
+                bits == 32 ? UINT32_MAX : ( (uint32_t)1 << bits ) - 1;
+            for ( int delta = 0; delta < 2; delta++ ) {
+                const int reference = (int)( state % 2001 ) - 1000;
+                for ( int i = 0; i < 128; i++ ) {
+                    state = state * 1664525u + 1013904223u;
+                    const uint32_t before =
+                        delta && i >= 4 ? (uint32_t)values[i - 4]
+                                        : (uint32_t)reference;
+                    values[i] = (int)( before + ( state & mask ) );
+                }
+                dynamic_array_simd_pack128( values, bits, reference,
+                                            (bool)delta, packed );
+                dynamic_array_simd_unpack128( packed, bits, reference,
+                                              (bool)delta, out );
+                agree &= memcmp( values, out, sizeof values ) == 0;
+            }
+        }
+    }
+    dynamic_array_simd_set_level( best );
+    TEST_ASSERT( agree, "pack/unpack round-trips every width at every level" );
+}
+
+void test_frozen_ids() {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( int i = 0; i < 100000; i++ ) {
+        dynamic_array_push( da, 1000000 + i * 8 + i % 7 );
+    }
+    struct dynamic_array_frozen *f = dynamic_array_freeze( da );
+    TEST_ASSERT( f != NULL && dynamic_array_frozen_size( f ) == 100000,
+                 "freeze keeps the size" );
+    TEST_ASSERT( dynamic_array_frozen_memory( f ) * 4 < sizeof( int ) * 100000,
+                 "ascending ids shrink more than 4x" );
+    bool same = true;
+    for ( size_t i = 0; i < 100000; i++ ) {
+        same &= dynamic_array_frozen_get( f, i ) == da->buffer[i];
+    }
+    TEST_ASSERT( same, "get decodes every element" );
+    TEST_ASSERT( dynamic_array_frozen_find( f, 1000000 ) == 0 &&
+                     dynamic_array_frozen_find( f, da->buffer[77777] ) ==
+                         77777 &&
+                     dynamic_array_frozen_find( f, da->buffer[99999] ) ==
+                         99999 &&
+                     dynamic_array_frozen_find( f, 1000001 ) == -1 &&
+                     dynamic_array_frozen_find( f, INT_MAX ) == -1 &&
+                     dynamic_array_frozen_find( f, 0 ) == -1,
+                 "find searches one block of sorted data" );
+
+    struct dynamic_array *thawed = dynamic_array_create();
+    dynamic_array_frozen_thaw( f, thawed );
+    TEST_ASSERT( dynamic_array_size( thawed ) == 100000 &&
+                     memcmp( thawed->buffer, da->buffer,
+                             sizeof( int ) * 100000 ) == 0 &&
+                     dynamic_array_is_sorted( thawed ),
+                 "thaw restores the elements and marks them sorted" );
+    dynamic_array_destroy( thawed );
+    dynamic_array_frozen_destroy( f );
+    dynamic_array_destroy( da );
+}
+
+void test_frozen_mixed() {
+    struct dynamic_array *da    = dynamic_array_create();
+    uint32_t              state = 4242;
+    // blocks of constants, small counters, descending runs and full-range
+    // noise, ending in a partial block
+    for ( int i = 0; i < 128 * 20 + 37; i++ ) {
+        state     = state * 1664525u + 1013904223u;
+        int value = 0;
+        switch ( ( i / 128 ) % 5 ) {
+        case 0: value = -5; break;
+        case 1: value = (int)( state >> 24 ); break;
+        case 2: value = 1000 - i; break;
+        case 3: value = (int)state; break;
+        default: value = i % 2 ? INT_MAX : INT_MIN; break;
+        }
+        dynamic_array_push( da, value );
+    }
+    const size_t                 n = dynamic_array_size( da );
+    struct dynamic_array_frozen *f = dynamic_array_freeze( da );
+    bool                         same = true;
+    for ( size_t i = 0; i < n; i++ ) {
+        same &= dynamic_array_frozen_get( f, i ) == da->buffer[i];
+    }
+    TEST_ASSERT( same, "get matches on every kind of block" );
+
+    int out[600];
+    dynamic_array_frozen_decode( f, 100, 600, out );
+    bool decoded = memcmp( out, da->buffer + 100, sizeof out ) == 0;
+    dynamic_array_frozen_decode( f, n - 37, 37, out );
+    decoded &= memcmp( out, da->buffer + n - 37, sizeof( int ) * 37 ) == 0;
+    TEST_ASSERT( decoded, "decode streams any range" );
+
+    bool found = true;
+    for ( size_t i = 0; i < n; i += 13 ) {
+        found &= dynamic_array_frozen_find( f, da->buffer[i] ) ==
+                 linear_find( da, da->buffer[i] );
+    }
+    found &= dynamic_array_frozen_find( f, 1001 ) == -1;
+    TEST_ASSERT( found, "find returns the first occurrence, skipping blocks" );
+    dynamic_array_frozen_destroy( f );
+
+    dynamic_array_reset( da );
+    f = dynamic_array_freeze( da );
+    dynamic_array_frozen_thaw( f, da );
+    TEST_ASSERT( dynamic_array_frozen_size( f ) == 0 &&
+                     dynamic_array_frozen_find( f, 0 ) == -1 &&
+                     dynamic_array_size( da ) == 0,
+                 "an empty array freezes and thaws" );
+    dynamic_array_frozen_destroy( f );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Set Algebra Tests
+// ============================================================================
+
+// n values in [0, range), sorted, so small ranges repeat values
+static struct dynamic_array *sorted_random( const size_t n, const int range,
+                                            uint32_t seed ) {
+    struct dynamic_array *da = dynamic_array_create();
+    for ( size_t i = 0; i < n; i++ ) {
+        seed = seed * 1664525u + 1013904223u;
+        dynamic_array_push( da, (int)( ( seed >> 8 ) % (uint32_t)range ) );
+    }
+    dynamic_array_sort( da );
+    return da;
+}
+
+// distinct, ascending and, per value, in the result exactly when expected
+static bool is_set_result( const struct dynamic_array *result,
+                           const struct dynamic_array *a,
+                           const struct dynamic_array *b, const int op ) {
+    for ( size_t i = 1; i < result->size; i++ ) {
+        if ( result->buffer[i - 1] >= result->buffer[i] ) { return false; }
+    }
+    size_t expected = 0;
+    for ( size_t i = 0; i < a->size + b->size; i++ ) {
+        const int  value = i < a->size ? a->buffer[i] : b->buffer[i - a->size];
+        const bool in_a  = dynamic_array_binary_search( a, value );
+        const bool in_b  = dynamic_array_binary_search( b, value );
+        const bool want  = op == 0 ? in_a && in_b : op == 1 ? true : !in_b;
+        if ( !want ) { continue; }
+        if ( !dynamic_array_binary_search( result, value ) ) { return false; }
+        // count each wanted value once, at its first position in a, then b
+        const bool first =
+            i < a->size ? dynamic_array_lower_bound( a, value ) == i
+                        : !in_a && dynamic_array_lower_bound( b, value ) ==
+                                       i - a->size;
+        expected += first;
+    }
+    return expected == result->size && dynamic_array_is_sorted( result );
+}
+
+void test_set_unique() {
+    struct dynamic_array *da       = dynamic_array_create();
+    int                   values[] = { 1, 1, 2, 3, 3, 3, 4, 4 };
+    dynamic_array_push_n( da, values, 8 );
+    dynamic_array_sort( da );
+    struct dynamic_array *snapshot = dynamic_array_clone( da );
+    TEST_ASSERT( dynamic_array_unique( da ) == 4 && da->size == 4 &&
+                     da->buffer[0] == 1 && da->buffer[3] == 4 &&
+                     dynamic_array_is_sorted( da ),
+                 "unique keeps each value once and stays sorted" );
+    TEST_ASSERT( snapshot->size == 8 && snapshot->buffer[1] == 1,
+                 "unique leaves a clone alone" );
+    dynamic_array_destroy( snapshot );
+
+    snapshot = dynamic_array_clone( da );
+    TEST_ASSERT( dynamic_array_unique( da ) == 0 &&
+                     dynamic_array_is_shared( da ),
+                 "unique without repeats neither writes nor copies" );
+    dynamic_array_destroy( snapshot );
+    dynamic_array_destroy( da );
+}
+
+void test_set_intersect() {
+    enum dynamic_array_simd_level best       = dynamic_array_simd_detect();
+    struct dynamic_array         *out        = dynamic_array_create();
+    bool                          agree      = true;
+    const size_t                  sizes[][2] = {
+        { 0, 50 }, { 7, 9 }, { 1000, 1200 }, { 3000, 3000 }, { 20, 5000 },
+    };
+    for ( int level = DYNAMIC_ARRAY_SIMD_SCALAR; level <= (int)best;
+          level++ ) {
+        dynamic_array_simd_set_level( (enum dynamic_array_simd_level)level );
+        for ( size_t s = 0; s < sizeof sizes / sizeof *sizes; s++ ) {
+            struct dynamic_array *a =
+                sorted_random( sizes[s][0], 2000, (uint32_t)( 11 + s ) );
+            struct dynamic_array *b =
+                sorted_random( sizes[s][1], 2000, (uint32_t)( 97 + s ) );
+            dynamic_array_intersect( out, a, b );
+            agree &= is_set_result( out, a, b, 0 );
+            dynamic_array_intersect( out, b, a );
+            agree &= is_set_result( out, a, b, 0 );
+            dynamic_array_destroy( a );
+            dynamic_array_destroy( b );
+        }
+    }
+    dynamic_array_simd_set_level( best );
+    TEST_ASSERT( agree, "intersect agrees with binary search at every level" );
+
+    // one side 1000x larger takes the galloping path
+    struct dynamic_array *large = dynamic_array_create();
+    struct dynamic_array *small = dynamic_array_create();
+    for ( int i = 0; i < 100000; i++ ) { dynamic_array_push( large, 3 * i ); }
+    for ( int i = 0; i < 100; i++ ) { dynamic_array_push( small, 1000 * i ); }
+    dynamic_array_intersect( out, small, large );
+    bool galloped = out->size == 34;
+    for ( size_t i = 0; i < out->size; i++ ) {
+        galloped &= out->buffer[i] == 3000 * (int)i;
+    }
+    TEST_ASSERT( galloped, "intersect gallops through a much larger side" );
+    dynamic_array_destroy( small );
+    dynamic_array_destroy( large );
+    dynamic_array_destroy( out );
+}
+
+void test_set_union_difference() {
+    struct counting_context              counts    = { 0 };
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = counting_alloc,
+        .realloc = counting_realloc,
+        .free    = counting_free,
+        .context = &counts,
+    };
+    struct dynamic_array *out =
+        dynamic_array_create_with( &allocator, &allocator );
+    struct dynamic_array *a = sorted_random( 3000, 5000, 5 );
+    struct dynamic_array *b = sorted_random( 2000, 5000, 6 );
+    dynamic_array_push( out, 42 );
+    dynamic_array_union( out, a, b );
+    TEST_ASSERT( is_set_result( out, a, b, 1 ),
+                 "union holds every value of either side once" );
+    TEST_ASSERT( counts.allocs + counts.reallocs == 3,
+                 "union reserves the output once" );
+    dynamic_array_difference( out, a, b );
+    bool agree = is_set_result( out, a, b, 2 );
+    dynamic_array_difference( out, b, a );
+    agree &= is_set_result( out, b, a, 2 );
+
+    struct dynamic_array *empty = dynamic_array_create();
+    dynamic_array_difference( out, a, empty );
+    agree &= is_set_result( out, a, empty, 2 );
+    dynamic_array_difference( out, empty, a );
+    agree &= out->size == 0;
+    // a few values against a much larger side gallop
+    dynamic_array_reset( empty );
+    for ( int i = 0; i < 20; i++ ) { dynamic_array_push( empty, i * 250 ); }
+    dynamic_array_difference( out, empty, a );
+    agree &= is_set_result( out, empty, a, 2 );
+    TEST_ASSERT( agree, "difference keeps the values missing from b" );
+    dynamic_array_destroy( empty );
+    dynamic_array_destroy( a );
+    dynamic_array_destroy( b );
+    dynamic_array_destroy( out );
+}
+
+void test_set_merge() {
+    struct dynamic_array *parts[5];
+    size_t                total = 0;
+    for ( int i = 0; i < 5; i++ ) {
+        parts[i] = sorted_random( i == 2 ? 0 : (size_t)( 100 * i + 3 ), 50,
+                                  (uint32_t)i );
+        total += parts[i]->size;
+    }
+    struct dynamic_array *expected = dynamic_array_create();
+    for ( int i = 0; i < 5; i++ ) {
+        dynamic_array_extend( expected, parts[i] );
+    }
+    dynamic_array_sort( expected );
+
+    struct dynamic_array *out = dynamic_array_create();
+    dynamic_array_merge( out, (const struct dynamic_array *const *)parts, 5 );
+    TEST_ASSERT( out->size == total &&
+                     memcmp( out->buffer, expected->buffer,
+                             sizeof( int ) * total ) == 0 &&
+                     dynamic_array_is_sorted( out ),
+                 "k-way merge keeps every element in order" );
+
+    dynamic_array_merge( out, (const struct dynamic_array *const *)parts + 3,
+                         2 );
+    bool merged = out->size == parts[3]->size + parts[4]->size;
+    for ( size_t i = 1; i < out->size; i++ ) {
+        merged &= out->buffer[i - 1] <= out->buffer[i];
+    }
+    dynamic_array_merge( out, (const struct dynamic_array *const *)parts + 1,
+                         2 );
+    merged &= out->size == parts[1]->size &&
+              memcmp( out->buffer, parts[1]->buffer,
+                      sizeof( int ) * out->size ) == 0;
+    dynamic_array_merge( out, NULL, 0 );
+    merged &= out->size == 0 && dynamic_array_is_sorted( out );
+    TEST_ASSERT( merged, "two-way, one-sided and empty merges" );
+    dynamic_array_destroy( out );
+    dynamic_array_destroy( expected );
+    for ( int i = 0; i < 5; i++ ) { dynamic_array_destroy( parts[i] ); }
+}
+
+// ============================================================================
+// Checked and Unchecked Access Tests
+// ============================================================================
+
+// allocator that fails once its budget of allocations is spent
+static void *limited_alloc( void *context, const size_t size ) {
+    int *budget = context;
+    if ( *budget == 0 ) { return NULL; }
+    ( *budget )--;
+    return malloc( size );
+}
+
+static void *limited_realloc( void *context, void *ptr, const size_t old_size,
+                              const size_t new_size ) {
+    (void)old_size;
+    int *budget = context;
+    if ( *budget == 0 ) { return NULL; }
+    ( *budget )--;
+    return realloc( ptr, new_size );
+}
+
+static void limited_free( void *context, void *ptr, const size_t size ) {
+    (void)context;
+    (void)size;
+    free( ptr );
+}
+
+void test_checked_errors() {
+    int value = 0;
+    TEST_ASSERT( dynamic_array_push_checked( NULL, 1 ) ==
+                         DYNAMIC_ARRAY_ERROR_NULL &&
+                     dynamic_array_get_checked( NULL, 0, &value ) ==
+                         DYNAMIC_ARRAY_ERROR_NULL,
+                 "a NULL array is reported" );
+
+    struct dynamic_array *da = dynamic_array_create();
+    TEST_ASSERT( dynamic_array_pop_checked( da, &value ) ==
+                         DYNAMIC_ARRAY_ERROR_EMPTY &&
+                     dynamic_array_front_checked( da, &value ) ==
+                         DYNAMIC_ARRAY_ERROR_EMPTY &&
+                     dynamic_array_back_checked( da, &value ) ==
+                         DYNAMIC_ARRAY_ERROR_EMPTY,
+                 "pop, front and back of an empty array are reported" );
+
+    bool pushed = true;
+    for ( int i = 0; i < 100; i++ ) {
+        pushed &= dynamic_array_push_checked( da, i ) == DYNAMIC_ARRAY_OK;
+    }
+    TEST_ASSERT( pushed && da->size == 100 && da->buffer[99] == 99,
+                 "push_checked grows the array" );
+    TEST_ASSERT( dynamic_array_get_checked( da, 100, &value ) ==
+                         DYNAMIC_ARRAY_ERROR_BOUNDS &&
+                     dynamic_array_set_checked( da, 100, 7 ) ==
+                         DYNAMIC_ARRAY_ERROR_BOUNDS &&
+                     dynamic_array_get_checked( da, 0, NULL ) ==
+                         DYNAMIC_ARRAY_ERROR_NULL,
+                 "indexes past the size and NULL outputs are reported" );
+
+    int front = -1;
+    int back  = -1;
+    TEST_ASSERT( dynamic_array_set_checked( da, 5, -5 ) == DYNAMIC_ARRAY_OK &&
+                     dynamic_array_get_checked( da, 5, &value ) ==
+                         DYNAMIC_ARRAY_OK &&
+                     value == -5 &&
+                     dynamic_array_front_checked( da, &front ) ==
+                         DYNAMIC_ARRAY_OK &&
+                     dynamic_array_pop_checked( da, &back ) ==
+                         DYNAMIC_ARRAY_OK &&
+                     front == 0 && back == 99 && da->size == 99,
+                 "checked calls in range succeed" );
+    dynamic_array_destroy( da );
+
+    da = dynamic_array_create_file( TEST_FILE );
+    dynamic_array_push( da, 1 );
+    dynamic_array_destroy( da );
+    da = dynamic_array_open( TEST_FILE, DYNAMIC_ARRAY_FILE_READ_ONLY );
+    TEST_ASSERT( dynamic_array_set_checked( da, 0, 2 ) ==
+                         DYNAMIC_ARRAY_ERROR_READ_ONLY &&
+                     dynamic_array_push_checked( da, 2 ) ==
+                         DYNAMIC_ARRAY_ERROR_READ_ONLY &&
+                     da->size == 1 && da->buffer[0] == 1,
+                 "writes to a read-only file are reported" );
+    dynamic_array_destroy( da );
+    remove( TEST_FILE );
+}
+
+void test_checked_no_memory() {
+    int                                  budget    = 1;
+    const struct dynamic_array_allocator allocator = {
+        .alloc   = limited_alloc,
+        .realloc = limited_realloc,
+        .free    = limited_free,
+        .context = &budget,
+    };
+    struct dynamic_array da;
+    dynamic_array_init_with( &da, &allocator );
+    bool pushed = true;
+    for ( int i = 0; i < DYNAMIC_ARRAY_DEFAULT_CAPACITY; i++ ) {
+        pushed &= dynamic_array_push_checked( &da, i ) == DYNAMIC_ARRAY_OK;
+    }
+    const size_t capacity = da.capacity;
+    TEST_ASSERT( pushed && dynamic_array_push_checked( &da, -1 ) ==
+                               DYNAMIC_ARRAY_ERROR_NO_MEMORY,
+                 "a failed growth is reported" );
+    TEST_ASSERT( da.size == capacity && da.capacity == capacity &&
+                     da.buffer[capacity - 1] == (int)capacity - 1,
+                 "the array is unchanged after a failed push" );
+
+    budget                      = 1; // the share count
+    struct dynamic_array *clone = dynamic_array_clone( &da );
+    TEST_ASSERT( budget == 0 && dynamic_array_set_checked( clone, 0, -1 ) ==
+                         DYNAMIC_ARRAY_ERROR_NO_MEMORY &&
+                     dynamic_array_is_shared( clone ) &&
+                     clone->buffer[0] == 0 && da.buffer[0] == 0,
+                 "a shared buffer that cannot be copied is left alone" );
+    budget = 1;
+    TEST_ASSERT( dynamic_array_set_checked( clone, 0, -1 ) ==
+                         DYNAMIC_ARRAY_OK &&
+                     clone->buffer[0] == -1 && da.buffer[0] == 0,
+                 "set_checked copies a shared buffer before writing" );
+    dynamic_array_destroy( clone );
+    dynamic_array_release( &da );
+}
+
+void test_inline_and_unchecked() {
+    struct dynamic_array *da = dynamic_array_create();
+    dynamic_array_reserve( da, 64 );
+    for ( int i = 0; i < 64; i++ ) { dynamic_array_push_unchecked( da, i ); }
+    int64_t sum = 0;
+    for ( size_t i = 0; i < da->size; i++ ) {
+        sum += dynamic_array_get_unchecked( da, i );
+    }
+    TEST_ASSERT( da->size == 64 && da->capacity == 64 && sum == 63 * 32 &&
+                     dynamic_array_front_unchecked( da ) == 0 &&
+                     dynamic_array_back_unchecked( da ) == 63,
+                 "unchecked push and reads after reserve" );
+
+    dynamic_array_sort( da );
+    dynamic_array_set( da, 0, 100 );
+    TEST_ASSERT( !dynamic_array_is_sorted( da ) &&
+                     dynamic_array_find( da, 100 ) == 0,
+                 "the inline set clears the sorted flag" );
+
+    dynamic_array_index_enable( da );
+    dynamic_array_push( da, -2 );
+    TEST_ASSERT( ( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -2 ) == 64,
+                 "push on an indexed array takes the slow path" );
+    dynamic_array_set_unchecked( da, 2, -3 );
+    TEST_ASSERT( !( da->flags & DYNAMIC_ARRAY_FLAG_INDEXED ) &&
+                     dynamic_array_find( da, -3 ) == 2 &&
+                     dynamic_array_find( da, 2 ) == -1,
+                 "an unchecked write marks the index stale" );
+    dynamic_array_destroy( da );
+}
+
+// ============================================================================
+// Generic Instantiation Tests
+// ============================================================================
+
+void test_generic_u8() {
+    struct u8_array *a = u8_array_create();
+    TEST_ASSERT( sizeof *a->buffer == 1, "u8 instantiation stores bytes" );
+
+    for ( int i = 0; i < 300; i++ ) { u8_array_push( a, (uint8_t)i ); }
+    TEST_ASSERT( u8_array_size( a ) == 300, "u8 push grows past capacity" );
+    TEST_ASSERT( u8_array_get( a, 299 ) == 43, "u8 values wrap as uint8_t" );
+    TEST_ASSERT( u8_array_find( a, 200 ) == 200, "u8 find uses ==" );
+    TEST_ASSERT( u8_array_count( a, 7 ) == 2, "u8 count uses ==" );
+
+    u8_array_rotate_left_n( a, 1 );
+    TEST_ASSERT( u8_array_front( a ) == 1 && u8_array_back( a ) == 0,
+                 "u8 rotate_left_n works on bytes" );
+
+    u8_array_destroy( a );
+}
+
+void test_generic_i64() {
+    struct i64_array *a = i64_array_create();
+    const int64_t     big[] = { INT64_MAX, INT64_MIN, 1 };
+
+    i64_array_push_n( a, big, 3 );
+    i64_array_insert( a, 1, 42 );
+    TEST_ASSERT( i64_array_get( a, 0 ) == INT64_MAX,
+                 "i64 keeps 64-bit values" );
+    TEST_ASSERT( i64_array_get( a, 1 ) == 42 &&
+                     i64_array_get( a, 2 ) == INT64_MIN,
+                 "i64 insert shifts elements" );
+    TEST_ASSERT( i64_array_remove( a, 0 ) == INT64_MAX &&
+                     i64_array_size( a ) == 3,
+                 "i64 remove returns element" );
+    TEST_ASSERT( i64_array_find_last( a, 1 ) == 2, "i64 find_last" );
+
+    i64_array_destroy( a );
+}
+
+void test_generic_struct() {
+    struct point_array *a = point_array_create();
+    for ( short i = 0; i < 10; i++ ) {
+        point_array_push( a, ( struct point ){ .x = i, .y = (short)-i } );
+    }
+
+    struct point p = point_array_get( a, 4 );
+    TEST_ASSERT( p.x == 4 && p.y == -4, "struct instantiation stores fields" );
+    TEST_ASSERT( point_array_find( a, ( struct point ){ 7, -7 } ) == 7,
+                 "struct find uses custom equality" );
+    TEST_ASSERT( point_array_find( a, ( struct point ){ 7, 7 } ) == -1,
+                 "struct find compares every field" );
+
+    point_array_insert( a, 0, ( struct point ){ 3, -3 } );
+    TEST_ASSERT( point_array_remove_value( a, ( struct point ){ 3, -3 } ) ==
+                         2 &&
+                     point_array_size( a ) == 9,
+                 "struct remove_value uses custom equality" );
+
+    struct point out[2];
+    point_array_pop_n( a, out, 2 );
+    TEST_ASSERT( out[1].x == 9 && point_array_size( a ) == 7,
+                 "struct pop_n copies whole elements" );
+
+    point_array_destroy( a );
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int main( void ) {
+    printf( "Running Dynamic Array Test Suite\n" );
+    printf( "================================\n\n" );
+
+    printf( "Creation and Initialization:\n" );
+    test_create_and_init();
+    test_init_on_existing();
+
+    printf( "\nPush and Pop:\n" );
+    test_push_single();
+    test_push_multiple();
+    test_push_expansion();
+    test_pop_single();
+    test_pop_multiple();
+
+    printf( "\nBulk Push and Pop:\n" );
+    test_push_n();
+    test_extend();
+    test_pop_n();
+
+    printf( "\nInsert and Remove:\n" );
+    test_insert_remove();
+    test_insert_remove_range();
+    test_remove_if_retain_if();
+    test_remove_value_simd_levels();
+
+    printf( "\nSize and Capacity:\n" );
+    test_size_capacity_queries();
+    test_empty();
+
+    printf( "\nGet and Set:\n" );
+    test_get();
+    test_set();
+
+    printf( "\nFront and Back:\n" );
+    test_front_back();
+    test_front_back_single();
+
+    printf( "\nFind:\n" );
+    test_find_existing();
+    test_find_not_found();
+    test_find_duplicates();
+    test_find_last_count_all();
+    test_find_simd_levels();
+
+    printf( "\nReductions:\n" );
+    test_reductions();
+    test_reductions_simd_levels();
+
+    printf( "\nHash Index:\n" );
+    test_index_find();
+    test_index_maintenance();
+    test_index_random();
+
+    printf( "\nSorting and Binary Search:\n" );
+    test_sort();
+    test_sorted_flag();
+    test_binary_search();
+    test_insert_sorted();
+
+    printf( "\nFill:\n" );
+    test_fill();
+
+    printf( "\nRotation:\n" );
+    test_rotate_right();
+    test_rotate_left();
+    test_rotate_right_n();
+    test_rotate_left_n();
+    test_rotate_wrap_around();
+    test_rotate_n_matches_single_steps();
+    test_rotate_negative_count();
+
+    printf( "\nClear and Destroy:\n" );
+    test_clear();
+    test_reset_reserve_shrink_release();
+
+    printf( "\nEdge Cases and Stress:\n" );
+    test_negative_values();
+    test_large_values();
+    test_large_array();
+    test_expand();
+
+    printf( "\nAllocators:\n" );
+    test_custom_allocator();
+    test_arena_and_pool();
+    test_arena_grows_in_place();
+    test_small_buffer();
+
+    printf( "\nGrowth Policies:\n" );
+    test_growth_policies();
+    test_growth_mmap();
+    test_growth_shrink();
+    test_growth_shrink_mapped();
+
+    printf( "\nRing Buffer:\n" );
+    test_ring_deque();
+    test_ring_sliding_window();
+    test_ring_rotation();
+    test_ring_linearize();
+
+    printf( "\nParallel Algorithms:\n" );
+    test_parallel_pool();
+    test_parallel_reductions();
+    test_parallel_sort();
+
+    printf( "\nConcurrent Append:\n" );
+    test_concurrent_segments();
+    test_concurrent_producers();
+    test_concurrent_stalled_producer();
+
+    printf( "\nFile-Backed Storage:\n" );
+    test_file_save_and_open();
+    test_file_private();
+    test_file_shrink_empty();
+    test_file_errors();
+
+    printf( "\nText I/O:\n" );
+    test_text_write_and_read();
+    test_text_parse();
+    test_text_parse_errors();
+
+    printf( "\nViews:\n" );
+    test_view_slices();
+    test_view_operations();
+    test_view_flags();
+
+    printf( "\nCopy-on-Write:\n" );
+    test_clone_shares_buffer();
+    test_clone_mutations();
+    test_clone_storage_kinds();
+    test_clone_snapshots_across_threads();
+
+    printf( "\nFrozen Arrays:\n" );
+    test_frozen_pack_levels();
+    test_frozen_ids();
+    test_frozen_mixed();
+
+    printf( "\nSet Algebra:\n" );
+    test_set_unique();
+    test_set_intersect();
+    test_set_union_difference();
+    test_set_merge();
+
+    printf( "\nChecked and Unchecked Access:\n" );
+    test_checked_errors();
+    test_checked_no_memory();
+    test_inline_and_unchecked();
+
+    printf( "\nInstrumentation:\n" );
+#if DYNAMIC_ARRAY_STATS
+    test_stats_growth();
+    test_stats_shifts_and_searches();
+    test_stats_concurrent_searches();
+#else
+    test_stats_disabled();
+#endif
+
+    printf( "\nGeneric Instantiations:\n" );
+    test_generic_u8();
+    test_generic_i64();
+    test_generic_struct();
 
     printf( "\n================================\n" );
     printf( "Tests passed: %d/%d\n", tests_passed, tests_run );